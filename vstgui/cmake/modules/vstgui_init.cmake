@@ -12,6 +12,10 @@ if(NOT DEFINED VSTGUI_ENABLE_OPENGL_SUPPORT)
     option(VSTGUI_ENABLE_OPENGL_SUPPORT "Enable OpenGL support" ON)
 endif()
 
+if(NOT DEFINED VSTGUI_ENABLE_DRAW_PROFILER)
+    option(VSTGUI_ENABLE_DRAW_PROFILER "Enable recording the draw time of views" OFF)
+endif()
+
 ##########################################################################################
 if(UNIX AND NOT CMAKE_HOST_APPLE)
     set(LINUX TRUE CACHE INTERNAL "VSTGUI linux platform")
@@ -82,6 +86,14 @@ else()
 	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_OPENGL_SUPPORT=0")
 endif()
 
+if(VSTGUI_ENABLE_DRAW_PROFILER)
+	set(VSTGUI_COMPILE_DEFINITIONS_DEBUG "${VSTGUI_COMPILE_DEFINITIONS_DEBUG};VSTGUI_ENABLE_DRAW_PROFILER=1")
+	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_ENABLE_DRAW_PROFILER=1")
+else()
+	set(VSTGUI_COMPILE_DEFINITIONS_DEBUG "${VSTGUI_COMPILE_DEFINITIONS_DEBUG};VSTGUI_ENABLE_DRAW_PROFILER=0")
+	set(VSTGUI_COMPILE_DEFINITIONS_RELEASE "${VSTGUI_COMPILE_DEFINITIONS_RELEASE};VSTGUI_ENABLE_DRAW_PROFILER=0")
+endif()
+
 set(VSTGUI_COMPILE_DEFINITIONS PRIVATE
     $<$<CONFIG:Debug>:${VSTGUI_COMPILE_DEFINITIONS_DEBUG}>
     $<$<CONFIG:Release>:${VSTGUI_COMPILE_DEFINITIONS_RELEASE}>
@@ -0,0 +1,240 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#include "drawprofileroverlayview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/drawprofiler.h"
+#include <algorithm>
+#include <cstdio>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr size_t kNumHistogramFrames = 240;
+static constexpr uint32_t kNumHistogramBins = 20;
+static constexpr double kHistogramBinWidth = 2.; // ms
+static constexpr double kFrameBudget = 1000. / 60.; // ms
+static constexpr CCoord kHistogramWidth = 220.;
+static constexpr CCoord kHistogramHeight = 90.;
+static constexpr CCoord kLabelHeight = 14.;
+static constexpr CCoord kLabelCharWidth = 7.;
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+DrawProfilerOverlayView::DrawProfilerOverlayView (const CRect& size, uint32_t numTopViews)
+: CView (size), numTopViews (numTopViews)
+{
+	setMouseEnabled (false);
+}
+
+//------------------------------------------------------------------------
+DrawProfilerOverlayView::~DrawProfilerOverlayView () noexcept = default;
+
+//------------------------------------------------------------------------
+void DrawProfilerOverlayView::setUpdateInterval (uint32_t interval)
+{
+	updateInterval = std::max<uint32_t> (interval, 16);
+	if (timer)
+		timer->setFireTime (updateInterval);
+}
+
+//------------------------------------------------------------------------
+bool DrawProfilerOverlayView::attached (CView* parent)
+{
+	if (!CView::attached (parent))
+		return false;
+	auto& profiler = DrawProfiler::instance ();
+	profiler.setEnabled (true);
+	nextFrame = profiler.getFrameIndex ();
+	timer = makeOwned<CVSTGUITimer> ([this] (CVSTGUITimer*) { update (); }, updateInterval);
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool DrawProfilerOverlayView::removed (CView* parent)
+{
+	timer = nullptr;
+	highlights.clear ();
+	return CView::removed (parent);
+}
+
+//------------------------------------------------------------------------
+void DrawProfilerOverlayView::collectViews (CView* view,
+											std::unordered_set<const CView*>& views) const
+{
+	views.emplace (view);
+	if (auto container = view->asViewContainer ())
+		container->forEachChild ([&] (CView* child) { collectViews (child, views); });
+}
+
+//------------------------------------------------------------------------
+CRect DrawProfilerOverlayView::getHistogramRect () const
+{
+	CRect r (getViewSize ());
+	r.left = std::max (r.left, r.right - kHistogramWidth);
+	r.top = std::max (r.top, r.bottom - kHistogramHeight);
+	return r;
+}
+
+//------------------------------------------------------------------------
+CRect DrawProfilerOverlayView::getHighlightBounds (const Highlight& highlight) const
+{
+	CRect r (highlight.rect);
+	r.extend (2., 2.);
+	CRect labelRect (highlight.rect.left, highlight.rect.top - kLabelHeight,
+					 highlight.rect.left + highlight.label.size () * kLabelCharWidth,
+					 highlight.rect.top);
+	r.unite (labelRect);
+	return r;
+}
+
+//------------------------------------------------------------------------
+void DrawProfilerOverlayView::update ()
+{
+	auto frame = getFrame ();
+	if (!frame)
+		return;
+	auto& profiler = DrawProfiler::instance ();
+	auto endFrame = profiler.getFrameIndex ();
+
+	auto newFrames = false;
+	for (const auto& stats : profiler.getFrameStatistics (nextFrame))
+	{
+		if (stats.frameIndex >= endFrame)
+			break;
+		if (frameTimes.size () < kNumHistogramFrames)
+			frameTimes.emplace_back (stats.duration);
+		else
+			frameTimes[frameTimesWritePos] = stats.duration;
+		frameTimesWritePos = (frameTimesWritePos + 1) % kNumHistogramFrames;
+		newFrames = true;
+	}
+
+	// the records only contain pointers, so only views which are still in the frame are shown
+	std::unordered_set<const CView*> liveViews;
+	collectViews (frame, liveViews);
+	std::vector<Highlight> newHighlights;
+	for (const auto& stats : profiler.getViewStatistics (nextFrame))
+	{
+		if (newHighlights.size () >= numTopViews)
+			break;
+		if (stats.view == this || stats.numDraws == 0 || liveViews.count (stats.view) == 0)
+			continue;
+		auto view = const_cast<CView*> (stats.view);
+		Highlight highlight;
+		highlight.rect = view->translateToGlobal (view->getViewSize (), true);
+		char text[32];
+		snprintf (text, sizeof (text), " %.2f ms x%llu", stats.selfTime / 1000000.,
+				  static_cast<unsigned long long> (stats.numDraws));
+		highlight.label = DrawProfiler::demangle (stats.typeName) + text;
+		newHighlights.emplace_back (std::move (highlight));
+	}
+	nextFrame = endFrame;
+
+	auto changed = newHighlights.size () != highlights.size ();
+	for (size_t i = 0; !changed && i < highlights.size (); ++i)
+	{
+		changed = newHighlights[i].rect != highlights[i].rect ||
+				  newHighlights[i].label != highlights[i].label;
+	}
+	if (changed)
+	{
+		for (const auto& highlight : highlights)
+			invalidRect (getHighlightBounds (highlight));
+		highlights = std::move (newHighlights);
+		for (const auto& highlight : highlights)
+			invalidRect (getHighlightBounds (highlight));
+	}
+	if (newFrames)
+		invalidRect (getHistogramRect ());
+}
+
+//------------------------------------------------------------------------
+void DrawProfilerOverlayView::drawRect (CDrawContext* context, const CRect& dirtyRect)
+{
+	context->setDrawMode (kAliasing);
+	context->setFont (kNormalFontSmall);
+	context->setLineWidth (2.);
+	context->setLineStyle (kLineSolid);
+	if (!DrawProfiler::isAvailable ())
+	{
+		auto r = getHistogramRect ();
+		context->setFillColor (CColor (0, 0, 0, 180));
+		context->drawRect (r, kDrawFilled);
+		context->setFontColor (kWhiteCColor);
+		context->drawString ("VSTGUI_ENABLE_DRAW_PROFILER is off", r);
+		return;
+	}
+
+	uint8_t alpha = 255;
+	for (const auto& highlight : highlights)
+	{
+		if (getHighlightBounds (highlight).rectOverlap (dirtyRect))
+		{
+			context->setFrameColor (CColor (255, 40, 40, alpha));
+			context->drawRect (highlight.rect, kDrawStroked);
+			CRect labelRect (highlight.rect.left, highlight.rect.top - kLabelHeight,
+							 highlight.rect.left + highlight.label.size () * kLabelCharWidth,
+							 highlight.rect.top);
+			context->setFillColor (CColor (0, 0, 0, alpha));
+			context->drawRect (labelRect, kDrawFilled);
+			context->setFontColor (CColor (255, 255, 255, alpha));
+			context->drawString (highlight.label.data (), labelRect, kLeftText);
+		}
+		// the most expensive view is the most visible one
+		alpha = static_cast<uint8_t> (std::max (alpha - 40, 80));
+	}
+
+	auto r = getHistogramRect ();
+	if (!r.rectOverlap (dirtyRect))
+		return;
+	context->setFillColor (CColor (0, 0, 0, 180));
+	context->drawRect (r, kDrawFilled);
+
+	uint32_t bins[kNumHistogramBins] = {};
+	int64_t sum = 0;
+	int64_t maxTime = 0;
+	for (auto time : frameTimes)
+	{
+		auto bin = static_cast<uint32_t> (time / 1000000. / kHistogramBinWidth);
+		++bins[std::min (bin, kNumHistogramBins - 1)];
+		sum += time;
+		maxTime = std::max (maxTime, time);
+	}
+	auto maxCount = std::max (*std::max_element (std::begin (bins), std::end (bins)), 1u);
+
+	CRect plot (r);
+	plot.inset (6., 6.);
+	plot.top += kLabelHeight;
+	auto binWidth = plot.getWidth () / kNumHistogramBins;
+	context->setFillColor (CColor (60, 200, 90));
+	for (uint32_t i = 0; i < kNumHistogramBins; ++i)
+	{
+		if (bins[i] == 0)
+			continue;
+		CRect bar (plot.left + i * binWidth, plot.bottom - plot.getHeight () * bins[i] / maxCount,
+				   plot.left + (i + 1) * binWidth - 1., plot.bottom);
+		context->drawRect (bar, kDrawFilled);
+	}
+	auto budgetX = plot.left + binWidth * kFrameBudget / kHistogramBinWidth;
+	context->setFrameColor (CColor (255, 200, 0));
+	context->setLineWidth (1.);
+	context->drawLine (CPoint (budgetX, plot.top), CPoint (budgetX, plot.bottom));
+
+	char text[64];
+	auto average = frameTimes.empty () ? 0. : sum / 1000000. / frameTimes.size ();
+	snprintf (text, sizeof (text), "avg %.2f ms  max %.2f ms  (%u)", average, maxTime / 1000000.,
+			  static_cast<unsigned> (frameTimes.size ()));
+	CRect textRect (r.left + 6., r.top + 4., r.right - 6., r.top + 4. + kLabelHeight);
+	context->setFontColor (kWhiteCColor);
+	context->drawString (text, textRect, kLeftText);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
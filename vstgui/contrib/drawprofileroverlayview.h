@@ -0,0 +1,69 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#pragma once
+
+#include "vstgui/lib/cview.h"
+#include "vstgui/lib/cvstguitimer.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Shows the draw costs recorded by the DrawProfiler on top of the frame
+ *
+ *	Add the view as the last child of the frame with the size of the frame. It enables the
+ *	DrawProfiler when attached and updates itself periodically: the views with the highest self
+ *	draw time since the last update are outlined and labeled with their type, time and draw
+ *	count, and a histogram of the durations of the last frames is shown in the bottom right
+ *	corner. Only the changed parts are invalidated, the draws of the overlay itself are excluded.
+ *
+ *	Without VSTGUI_ENABLE_DRAW_PROFILER the view only shows that the profiler is not available.
+ */
+class DrawProfilerOverlayView : public CView
+{
+public:
+	DrawProfilerOverlayView (const CRect& size, uint32_t numTopViews = 5);
+	~DrawProfilerOverlayView () noexcept override;
+
+	void setNumTopViews (uint32_t num) { numTopViews = num; }
+	uint32_t getNumTopViews () const { return numTopViews; }
+	/** in milliseconds */
+	void setUpdateInterval (uint32_t interval);
+	uint32_t getUpdateInterval () const { return updateInterval; }
+
+	/** collect the recorded statistics and invalidate the changed parts, called by the timer */
+	void update ();
+
+	void drawRect (CDrawContext* context, const CRect& dirtyRect) override;
+	bool hitTest (const CPoint& where, const Event& event = noEvent ()) override { return false; }
+	bool attached (CView* parent) override;
+	bool removed (CView* parent) override;
+
+//------------------------------------------------------------------------
+private:
+	struct Highlight
+	{
+		CRect rect;
+		std::string label;
+	};
+
+	CRect getHistogramRect () const;
+	CRect getHighlightBounds (const Highlight& highlight) const;
+	void collectViews (CView* view, std::unordered_set<const CView*>& views) const;
+
+	std::vector<Highlight> highlights;
+	std::vector<int64_t> frameTimes;
+	size_t frameTimesWritePos {0};
+	uint64_t nextFrame {0};
+	uint32_t numTopViews {5};
+	uint32_t updateInterval {250};
+	SharedPointer<CVSTGUITimer> timer;
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
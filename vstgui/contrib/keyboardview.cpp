@@ -6,12 +6,14 @@
 
 #include "keyboardview.h"
 #include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cdrawcontext.h"
 #include "vstgui/lib/coffscreencontext.h"
 #include "vstgui/uidescription/detail/uiviewcreatorattributes.h"
 #include "vstgui/uidescription/iviewcreator.h"
 #include "vstgui/uidescription/uiattributes.h"
 #include "vstgui/uidescription/uiviewcreator.h"
 #include "vstgui/uidescription/uiviewfactory.h"
+#include <cmath>
 #include <sstream>
 
 //------------------------------------------------------------------------
@@ -550,11 +552,14 @@ CMouseEventResult KeyboardViewRangeSelector::onMouseCancel ()
 //------------------------------------------------------------------------
 KeyboardViewBase::KeyboardViewBase () : CView (CRect (0, 0, 0, 0)), noteNameFont (kSystemFont)
 {
+	setWantsIdle (true);
 }
 
 //------------------------------------------------------------------------
 void KeyboardViewBase::setViewSize (const CRect& rect, bool invalid)
 {
+	if (rect.getHeight () != getViewSize ().getHeight ())
+		invalidKeyImageCache ();
 	CView::setViewSize (rect, invalid);
 	noteRectCacheInvalid = true;
 }
@@ -632,7 +637,7 @@ void KeyboardViewBase::setWhiteKeyWidth (CCoord width)
 	if (whiteKeyWidth != width)
 	{
 		whiteKeyWidth = width;
-		whiteKeyBitmapCache = nullptr;
+		invalidKeyImageCache ();
 		noteRectCacheInvalid = true;
 		invalid ();
 	}
@@ -644,7 +649,7 @@ void KeyboardViewBase::setBlackKeyWidth (CCoord width)
 	if (blackKeyWidth != width)
 	{
 		blackKeyWidth = width;
-		blackKeyBitmapCache = nullptr;
+		invalidKeyImageCache ();
 		noteRectCacheInvalid = true;
 		invalid ();
 	}
@@ -656,6 +661,7 @@ void KeyboardViewBase::setBlackKeyHeight (CCoord height)
 	if (blackKeyHeight != height)
 	{
 		blackKeyHeight = height;
+		invalidKeyImageCache ();
 		noteRectCacheInvalid = true;
 		invalid ();
 	}
@@ -667,6 +673,7 @@ void KeyboardViewBase::setLineWidth (CCoord width)
 	if (lineWidth != width)
 	{
 		lineWidth = width;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
@@ -677,6 +684,7 @@ void KeyboardViewBase::setFrameColor (CColor color)
 	if (frameColor != color)
 	{
 		frameColor = color;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
@@ -697,6 +705,7 @@ void KeyboardViewBase::setWhiteKeyColor (CColor color)
 	if (whiteKeyColor != color)
 	{
 		whiteKeyColor = color;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
@@ -707,6 +716,7 @@ void KeyboardViewBase::setWhiteKeyPressedColor (CColor color)
 	if (whiteKeyPressedColor != color)
 	{
 		whiteKeyPressedColor = color;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
@@ -717,6 +727,7 @@ void KeyboardViewBase::setBlackKeyColor (CColor color)
 	if (blackKeyColor != color)
 	{
 		blackKeyColor = color;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
@@ -727,51 +738,50 @@ void KeyboardViewBase::setBlackKeyPressedColor (CColor color)
 	if (blackKeyPressedColor != color)
 	{
 		blackKeyPressedColor = color;
+		invalidKeyImageCache ();
 		invalid ();
 	}
 }
 
 //------------------------------------------------------------------------
-void KeyboardViewBase::createBitmapCache ()
+void KeyboardViewBase::invalidKeyImageCache ()
 {
-	auto whiteKeyBitmap = getBitmap (BitmapID::WhiteKeyUnpressed);
-	auto blackKeyBitmap = getBitmap (BitmapID::BlackKeyUnpressed);
-	if (!whiteKeyBitmap || !blackKeyBitmap)
-		return;
-
-#if ((VSTGUI_VERSION_MAJOR == 4 && VSTGUI_VERSION_MINOR > 9) || (VSTGUI_VERSION_MAJOR > 4))
-	if (auto offscreen = COffscreenContext::create (CPoint (whiteKeyWidth, getHeight ())))
-#else
-	if (auto offscreen = COffscreenContext::create (getFrame (), whiteKeyWidth, getHeight ()))
-#endif
-	{
-		offscreen->beginDraw ();
-		CRect r (0, 0, whiteKeyWidth, getHeight ());
-		r.left -= whiteKeyBitmapInset.left;
-		r.right += whiteKeyBitmapInset.right;
-		r.top -= whiteKeyBitmapInset.top;
-		r.bottom += whiteKeyBitmapInset.bottom;
-		whiteKeyBitmap->draw (offscreen, r);
-		offscreen->endDraw ();
-		whiteKeyBitmapCache = offscreen->getBitmap ();
-	}
+	keyImageCache.clear ();
+}
 
-#if ((VSTGUI_VERSION_MAJOR == 4 && VSTGUI_VERSION_MINOR > 9) || (VSTGUI_VERSION_MAJOR > 4))
-	if (auto offscreen = COffscreenContext::create (CPoint (blackKeyWidth, blackKeyHeight)))
-#else
-	if (auto offscreen = COffscreenContext::create (getFrame (), blackKeyWidth, blackKeyHeight))
-#endif
+//------------------------------------------------------------------------
+CBitmap* KeyboardViewBase::getKeyImage (CDrawContext* context, const CRect& rect,
+                                        const CRect& bitmapRect, bool isWhite, bool pressed,
+                                        CRect& imageRect)
+{
+	auto scaleFactor = context->getScaleFactor ();
+	auto frameWidth = lineWidth == -1 ? context->getHairlineSize () : lineWidth;
+	// the key frame is stroked centered on the key rect, the image includes its outer half
+	auto padding = std::ceil (frameWidth / 2.);
+	imageRect = bitmapRect;
+	imageRect.extend (padding, padding);
+	CPoint size (std::ceil (imageRect.getWidth ()), std::ceil (imageRect.getHeight ()));
+	for (const auto& image : keyImageCache)
 	{
-		offscreen->beginDraw ();
-		CRect r (0, 0, blackKeyWidth, blackKeyHeight);
-		r.left -= blackKeyBitmapInset.left;
-		r.right += blackKeyBitmapInset.right;
-		r.top -= blackKeyBitmapInset.top;
-		r.bottom += blackKeyBitmapInset.bottom;
-		blackKeyBitmap->draw (offscreen, r);
-		offscreen->endDraw ();
-		blackKeyBitmapCache = offscreen->getBitmap ();
+		if (image.isWhite == isWhite && image.pressed == pressed && image.size == size &&
+		    image.scaleFactor == scaleFactor)
+			return image.bitmap;
 	}
+	auto offscreen = COffscreenContext::create (size, scaleFactor);
+	if (!offscreen)
+		return nullptr;
+	offscreen->beginDraw ();
+	offscreen->setLineWidth (frameWidth);
+	offscreen->setFrameColor (frameColor);
+	offscreen->setDrawMode (kAntiAliasing | kNonIntegralMode);
+	CRect keyRect (rect);
+	keyRect.offset (-imageRect.left, -imageRect.top);
+	CRect keyBitmapRect (bitmapRect);
+	keyBitmapRect.offset (-imageRect.left, -imageRect.top);
+	drawKey (offscreen, keyRect, keyBitmapRect, isWhite, pressed);
+	offscreen->endDraw ();
+	keyImageCache.push_back ({isWhite, pressed, size, scaleFactor, offscreen->getBitmap ()});
+	return keyImageCache.back ().bitmap;
 }
 
 //------------------------------------------------------------------------
@@ -780,9 +790,6 @@ void KeyboardViewBase::drawRect (CDrawContext* context, const CRect& dirtyRect)
 	if (noteRectCacheInvalid)
 		updateNoteRectCache ();
 
-	if (whiteKeyBitmapCache == nullptr || blackKeyBitmapCache == nullptr)
-		createBitmapCache ();
-
 	context->setLineWidth (lineWidth == -1 ? context->getHairlineSize () : lineWidth);
 	context->setFrameColor (frameColor);
 	context->setFontColor (fontColor);
@@ -817,10 +824,32 @@ void KeyboardViewBase::drawRect (CDrawContext* context, const CRect& dirtyRect)
 }
 
 //------------------------------------------------------------------------
-void KeyboardViewBase::drawNote (CDrawContext* context, CRect& rect, NoteIndex note,
-                                 bool isWhite) const
+void KeyboardViewBase::drawKey (CDrawContext* context, const CRect& rect, const CRect& bitmapRect,
+                                bool isWhite, bool pressed) const
 {
 	CBitmap* keyBitmap = nullptr;
+	if (pressed)
+		keyBitmap = getBitmap (isWhite ? BitmapID::WhiteKeyPressed : BitmapID::BlackKeyPressed);
+	else
+		keyBitmap = getBitmap (isWhite ? BitmapID::WhiteKeyUnpressed : BitmapID::BlackKeyUnpressed);
+
+	if (keyBitmap)
+	{
+		keyBitmap->draw (context, bitmapRect);
+	}
+	else
+	{
+		if (pressed)
+			context->setFillColor (isWhite ? whiteKeyPressedColor : blackKeyPressedColor);
+		else
+			context->setFillColor (isWhite ? whiteKeyColor : blackKeyColor);
+		context->drawRect (rect, isWhite ? kDrawFilledAndStroked : kDrawFilled);
+	}
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::drawNote (CDrawContext* context, CRect& rect, NoteIndex note, bool isWhite)
+{
 	CRect bitmapRect (rect);
 	if (isWhite)
 	{
@@ -837,39 +866,15 @@ void KeyboardViewBase::drawNote (CDrawContext* context, CRect& rect, NoteIndex n
 		bitmapRect.bottom += blackKeyBitmapInset.bottom;
 	}
 
-	if (keyPressed[note])
-		keyBitmap = getBitmap (isWhite ? BitmapID::WhiteKeyPressed : BitmapID::BlackKeyPressed);
-	else
-	{
-		if (isWhite)
-		{
-			if (whiteKeyBitmapCache && whiteKeyBitmapCache->getWidth () == bitmapRect.getWidth () &&
-			    whiteKeyBitmapCache->getHeight () == bitmapRect.getHeight ())
-				keyBitmap = whiteKeyBitmapCache;
-			else
-				keyBitmap = getBitmap (BitmapID::WhiteKeyUnpressed);
-		}
-		else
-		{
-			if (blackKeyBitmapCache && blackKeyBitmapCache->getWidth () == bitmapRect.getWidth () &&
-			    blackKeyBitmapCache->getHeight () == bitmapRect.getHeight ())
-				keyBitmap = blackKeyBitmapCache;
-			else
-				keyBitmap = getBitmap (BitmapID::BlackKeyUnpressed);
-		}
-	}
-
-	if (keyBitmap)
+	CRect imageRect;
+	if (auto keyImage =
+	        getKeyImage (context, rect, bitmapRect, isWhite, keyPressed[note], imageRect))
 	{
-		keyBitmap->draw (context, bitmapRect);
+		drawClipped (context, imageRect, [&] () { keyImage->draw (context, imageRect); });
 	}
 	else
 	{
-		if (keyPressed[note])
-			context->setFillColor (isWhite ? whiteKeyPressedColor : blackKeyPressedColor);
-		else
-			context->setFillColor (isWhite ? whiteKeyColor : blackKeyColor);
-		context->drawRect (rect, isWhite ? kDrawFilledAndStroked : kDrawFilled);
+		drawKey (context, rect, bitmapRect, isWhite, keyPressed[note]);
 	}
 	if (keyPressed[note] && isWhite)
 	{
@@ -997,34 +1002,135 @@ void KeyboardViewBase::invalidNote (NoteIndex note)
 }
 
 //------------------------------------------------------------------------
-void KeyboardViewBase::setKeyPressed (NoteIndex note, bool state)
+void KeyboardViewBase::invalidDirtyNotes ()
 {
-	vstgui_assert (note >= 0);
-	if (note < 0)
+	if (dirtyNotes.none ())
 		return;
+	if (noteRectCacheInvalid)
+		updateNoteRectCache ();
+	CRect run;
+	for (NoteIndex note = 0; note < MaxNotes; ++note)
+	{
+		if (!dirtyNotes[note])
+			continue;
+		const auto& r = getNoteRect (note);
+		if (run.isEmpty ())
+			run = r;
+		else if (r.left <= run.right)
+			run.unite (r);
+		else
+		{
+			invalidRect (run);
+			run = r;
+		}
+	}
+	if (!run.isEmpty ())
+		invalidRect (run);
+	dirtyNotes.reset ();
+}
 
-	if (keyPressed[note] != state)
+//------------------------------------------------------------------------
+bool KeyboardViewBase::applyKeyPressed (NoteIndex note, bool state)
+{
+	if (keyPressed[note] == state)
+		return false;
+	keyPressed[note] = state;
+	dirtyNotes.set (note);
+	if (isWhiteKey (note))
 	{
-		keyPressed[note] = state;
-		invalidNote (note);
-		if (isWhiteKey (note))
+		// the neighbours draw the shadow of the pressed key
+		if (note > startNote)
 		{
-			if (note > startNote)
-			{
-				NoteIndex prevKey = note - 1;
-				if (!isWhiteKey (prevKey))
-					prevKey--;
-				invalidNote (prevKey);
-			}
-			if (note < startNote + numKeys)
-			{
-				NoteIndex nextKey = note + 1;
-				if (!isWhiteKey (nextKey))
-					nextKey++;
-				invalidNote (nextKey);
-			}
+			NoteIndex prevKey = note - 1;
+			if (!isWhiteKey (prevKey))
+				prevKey--;
+			dirtyNotes.set (prevKey);
+		}
+		if (note < startNote + numKeys)
+		{
+			NoteIndex nextKey = note + 1;
+			if (!isWhiteKey (nextKey))
+				nextKey++;
+			if (nextKey < MaxNotes)
+				dirtyNotes.set (nextKey);
 		}
 	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::setKeyPressed (NoteIndex note, bool state)
+{
+	vstgui_assert (note >= 0 && note < MaxNotes);
+	if (note < 0 || note >= MaxNotes)
+		return;
+
+	// a queue overflow re-applies all queued states, they must not undo this change
+	setQueuedKeyState (note, state);
+	if (applyKeyPressed (note, state))
+		invalidDirtyNotes ();
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::setQueuedKeyState (NoteIndex note, bool state)
+{
+	auto& word = queuedKeyState[note / 64];
+	auto bit = uint64_t (1) << (note % 64);
+	if (state)
+		word.fetch_or (bit, std::memory_order_release);
+	else
+		word.fetch_and (~bit, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::queueKeyPressed (NoteIndex note, bool state)
+{
+	if (note < 0 || note >= MaxNotes)
+		return;
+	setQueuedKeyState (note, state);
+
+	auto writePos = noteQueueWritePos.load (std::memory_order_relaxed);
+	auto nextWritePos = (writePos + 1) % NoteQueueSize;
+	if (nextWritePos == noteQueueReadPos.load (std::memory_order_acquire))
+	{
+		// queue is full, the UI thread will compare all notes instead
+		noteQueueOverflow.store (true, std::memory_order_release);
+		return;
+	}
+	noteQueue[writePos] = note;
+	noteQueueWritePos.store (nextWritePos, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::processQueuedKeyStates ()
+{
+	auto isQueuedPressed = [this] (NoteIndex note) {
+		auto word = queuedKeyState[note / 64].load (std::memory_order_acquire);
+		return (word & (uint64_t (1) << (note % 64))) != 0;
+	};
+
+	auto readPos = noteQueueReadPos.load (std::memory_order_relaxed);
+	auto writePos = noteQueueWritePos.load (std::memory_order_acquire);
+	while (readPos != writePos)
+	{
+		auto note = noteQueue[readPos];
+		applyKeyPressed (note, isQueuedPressed (note));
+		readPos = (readPos + 1) % NoteQueueSize;
+	}
+	noteQueueReadPos.store (readPos, std::memory_order_release);
+
+	if (noteQueueOverflow.exchange (false, std::memory_order_acq_rel))
+	{
+		for (NoteIndex note = 0; note < MaxNotes; ++note)
+			applyKeyPressed (note, isQueuedPressed (note));
+	}
+	invalidDirtyNotes ();
+}
+
+//------------------------------------------------------------------------
+void KeyboardViewBase::onIdle ()
+{
+	processQueuedKeyStates ();
 }
 
 //------------------------------------------------------------------------
@@ -1038,18 +1144,21 @@ bool KeyboardViewBase::isWhiteKey (NoteIndex note) const
 void KeyboardViewBase::setWhiteKeyBitmapInset (const CRect& inset)
 {
 	whiteKeyBitmapInset = inset;
+	invalidKeyImageCache ();
 }
 
 //------------------------------------------------------------------------
 void KeyboardViewBase::setBlackKeyBitmapInset (const CRect& inset)
 {
 	blackKeyBitmapInset = inset;
+	invalidKeyImageCache ();
 }
 
 //------------------------------------------------------------------------
 void KeyboardViewBase::setBitmap (BitmapID bID, CBitmap* bitmap)
 {
 	bitmaps[static_cast<size_t> (bID)] = bitmap;
+	invalidKeyImageCache ();
 	invalid ();
 }
 
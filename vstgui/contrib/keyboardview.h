@@ -12,8 +12,10 @@
 #include "vstgui/lib/dispatchlist.h"
 #include "vstgui/lib/itouchevent.h"
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <map>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -40,6 +42,20 @@ public:
 	KeyboardViewBase ();
 
 	void setKeyPressed (NoteIndex note, bool state);
+	bool isKeyPressed (NoteIndex note) const
+	{
+		return note >= 0 && note < MaxNotes && keyPressed[note];
+	}
+
+	/** queue a key state change
+	 *
+	 *	Lock-free and safe to call from one non UI thread (e.g. the thread receiving the MIDI
+	 *	events). The queued states are applied in onIdle and all changed notes are invalidated
+	 *	together once per idle cycle.
+	 */
+	void queueKeyPressed (NoteIndex note, bool state);
+	/** apply all queued key states, must be called on the UI thread */
+	void processQueuedKeyStates ();
 
 	virtual void setKeyRange (NoteIndex startNote, NumNotes numKeys);
 	NoteIndex getKeyRangeStart () const { return startNote; }
@@ -85,27 +101,47 @@ public:
 	void drawRect (CDrawContext* context, const CRect& dirtyRect) override;
 	void setViewSize (const CRect& rect, bool invalid = true) override;
 	bool sizeToFit () override;
+	void onIdle () override;
 //------------------------------------------------------------------------
 protected:
 	using NoteRectCache = std::array<CRect, MaxNotes>;
 
 	void invalidNote (NoteIndex note);
+	/** invalidate all notes marked dirty, adjacent notes are combined into one rect */
+	void invalidDirtyNotes ();
 
 	NoteIndex pointToNote (const CPoint& p, bool ignoreY) const;
 	const NoteRectCache& getNoteRectCache () const { return noteRectCache; }
 
 private:
-	void drawNote (CDrawContext* context, CRect& rect, NoteIndex note, bool isWhite) const;
+	void drawNote (CDrawContext* context, CRect& rect, NoteIndex note, bool isWhite);
+	void drawKey (CDrawContext* context, const CRect& rect, const CRect& bitmapRect, bool isWhite,
+	              bool pressed) const;
+	CBitmap* getKeyImage (CDrawContext* context, const CRect& rect, const CRect& bitmapRect,
+	                      bool isWhite, bool pressed, CRect& imageRect);
+	void invalidKeyImageCache ();
+	bool applyKeyPressed (NoteIndex note, bool state);
 	CRect calcNoteRect (NoteIndex note) const;
 	void updateNoteRectCache () const;
-	void createBitmapCache ();
+	void setQueuedKeyState (NoteIndex note, bool state);
 
 	using BitmapArray =
 	    std::array<SharedPointer<CBitmap>, static_cast<size_t> (BitmapID::NumBitmaps)>;
 
+	/** a pre-rendered key state for one key size and scale factor */
+	struct KeyImage
+	{
+		bool isWhite;
+		bool pressed;
+		CPoint size;
+		double scaleFactor;
+		SharedPointer<CBitmap> bitmap;
+	};
+
+	static constexpr uint32_t NoteQueueSize = 1024;
+
 	BitmapArray bitmaps;
-	SharedPointer<CBitmap> whiteKeyBitmapCache;
-	SharedPointer<CBitmap> blackKeyBitmapCache;
+	std::vector<KeyImage> keyImageCache;
 	SharedPointer<CFontDesc> noteNameFont;
 
 	CRect whiteKeyBitmapInset;
@@ -129,6 +165,14 @@ private:
 	mutable bool noteRectCacheInvalid {true};
 	mutable NoteRectCache noteRectCache;
 	std::bitset<MaxNotes> keyPressed {};
+	std::bitset<MaxNotes> dirtyNotes {};
+
+	// single producer / single consumer queue of notes whose queued state changed
+	std::array<NoteIndex, NoteQueueSize> noteQueue;
+	std::atomic<uint32_t> noteQueueWritePos {0};
+	std::atomic<uint32_t> noteQueueReadPos {0};
+	std::atomic<bool> noteQueueOverflow {false};
+	std::array<std::atomic<uint64_t>, MaxNotes / 64> queuedKeyState {};
 };
 
 class KeyboardViewRangeSelector;
@@ -0,0 +1,388 @@
+//------------------------------------------------------------------------
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#include "meterbankview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/uidescription/detail/uiviewcreatorattributes.h"
+#include "vstgui/uidescription/iviewcreator.h"
+#include "vstgui/uidescription/uiattributes.h"
+#include "vstgui/uidescription/uiviewcreator.h"
+#include "vstgui/uidescription/uiviewfactory.h"
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+MeterBankView::MeterBankView (const CRect& size, MeterIndex numMeters) : CView (size)
+{
+	setNumMeters (numMeters);
+	setWantsIdle (true);
+}
+
+//------------------------------------------------------------------------
+MeterBankView::~MeterBankView () noexcept = default;
+
+//------------------------------------------------------------------------
+void MeterBankView::setNumMeters (MeterIndex num)
+{
+	if (num == numMeters && inputValues)
+		return;
+	numMeters = num;
+	inputValues = std::unique_ptr<std::atomic<float>[]> (new std::atomic<float>[numMeters]);
+	for (MeterIndex i = 0; i < numMeters; ++i)
+		inputValues[i].store (0.f, std::memory_order_relaxed);
+	displayValues.assign (numMeters, 0.f);
+	drawnLevels.assign (numMeters, -1);
+	invalid ();
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setMeterValue (MeterIndex index, float value)
+{
+	if (index < numMeters)
+		inputValues[index].store (value, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setMeterValues (const float* values, MeterIndex numValues)
+{
+	numValues = std::min (numValues, numMeters);
+	for (MeterIndex i = 0; i < numValues; ++i)
+		inputValues[i].store (values[i], std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+float MeterBankView::getMeterDisplayValue (MeterIndex index) const
+{
+	return index < numMeters ? displayValues[index] : 0.f;
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setNumLed (int32_t num)
+{
+	num = std::max (num, 0);
+	if (numLed != num)
+	{
+		numLed = num;
+		std::fill (drawnLevels.begin (), drawnLevels.end (), -1);
+		invalid ();
+	}
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setMeterGap (CCoord gap)
+{
+	if (meterGap != gap)
+	{
+		meterGap = gap;
+		std::fill (drawnLevels.begin (), drawnLevels.end (), -1);
+		invalid ();
+	}
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setMeterColor (CColor color)
+{
+	if (meterColor != color)
+	{
+		meterColor = color;
+		invalid ();
+	}
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setMeterBackgroundColor (CColor color)
+{
+	if (meterBackgroundColor != color)
+	{
+		meterBackgroundColor = color;
+		invalid ();
+	}
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::setViewSize (const CRect& rect, bool invalid)
+{
+	CView::setViewSize (rect, invalid);
+	std::fill (drawnLevels.begin (), drawnLevels.end (), -1);
+}
+
+//------------------------------------------------------------------------
+CCoord MeterBankView::getMeterWidth () const
+{
+	if (numMeters == 0)
+		return 0.;
+	return (getViewSize ().getWidth () - meterGap * (numMeters - 1)) / numMeters;
+}
+
+//------------------------------------------------------------------------
+CRect MeterBankView::getMeterRect (MeterIndex index) const
+{
+	auto width = getMeterWidth ();
+	CRect r (getViewSize ());
+	r.left += index * (width + meterGap);
+	r.setWidth (width);
+	return r;
+}
+
+//------------------------------------------------------------------------
+int32_t MeterBankView::getMeterAt (CCoord x) const
+{
+	auto stride = getMeterWidth () + meterGap;
+	if (numMeters == 0 || stride <= 0.)
+		return -1;
+	auto index = static_cast<int32_t> (std::floor ((x - getViewSize ().left) / stride));
+	if (index < 0 || index >= static_cast<int32_t> (numMeters))
+		return -1;
+	return index;
+}
+
+//------------------------------------------------------------------------
+int32_t MeterBankView::valueToLevel (float value) const
+{
+	auto maxLevel = numLed > 0 ? numLed : static_cast<int32_t> (getViewSize ().getHeight ());
+	return std::clamp (static_cast<int32_t> (maxLevel * value + 0.5f), 0, maxLevel);
+}
+
+//------------------------------------------------------------------------
+CCoord MeterBankView::levelToHeight (int32_t level) const
+{
+	if (numLed > 0)
+		return std::round (getViewSize ().getHeight () * level / numLed);
+	return level;
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::invalidMeterRange (MeterIndex first, MeterIndex last, int32_t minLevel,
+                                       int32_t maxLevel)
+{
+	CRect r (getMeterRect (first));
+	r.right = getMeterRect (last).right;
+	auto bottom = r.bottom;
+	r.top = bottom - levelToHeight (maxLevel);
+	r.bottom = bottom - levelToHeight (minLevel);
+	r.makeIntegral ();
+	r.bound (getViewSize ());
+	if (!r.isEmpty ())
+		invalidRect (r);
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::onIdle ()
+{
+	auto maxLevel = numLed > 0 ? numLed : static_cast<int32_t> (getViewSize ().getHeight ());
+	MeterIndex runStart = 0;
+	int32_t runMinLevel = 0;
+	int32_t runMaxLevel = 0;
+	bool inRun = false;
+	for (MeterIndex i = 0; i < numMeters; ++i)
+	{
+		auto input = inputValues[i].load (std::memory_order_relaxed);
+		auto value = displayValues[i] - decreaseValue;
+		if (value < input)
+			value = input;
+		displayValues[i] = value;
+
+		auto level = valueToLevel (value);
+		auto drawnLevel = drawnLevels[i];
+		if (level == drawnLevel)
+		{
+			if (inRun)
+			{
+				invalidMeterRange (runStart, i - 1, runMinLevel, runMaxLevel);
+				inRun = false;
+			}
+			continue;
+		}
+		auto minLevel = drawnLevel < 0 ? 0 : std::min (level, drawnLevel);
+		auto maxChangedLevel = drawnLevel < 0 ? maxLevel : std::max (level, drawnLevel);
+		if (inRun)
+		{
+			runMinLevel = std::min (runMinLevel, minLevel);
+			runMaxLevel = std::max (runMaxLevel, maxChangedLevel);
+		}
+		else
+		{
+			runStart = i;
+			runMinLevel = minLevel;
+			runMaxLevel = maxChangedLevel;
+			inRun = true;
+		}
+	}
+	if (inRun)
+		invalidMeterRange (runStart, numMeters - 1, runMinLevel, runMaxLevel);
+}
+
+//------------------------------------------------------------------------
+void MeterBankView::drawRect (CDrawContext* context, const CRect& dirtyRect)
+{
+	if (numMeters == 0)
+		return;
+
+	auto stride = getMeterWidth () + meterGap;
+	if (stride <= 0.)
+		return;
+	auto left = getViewSize ().left;
+	auto first = static_cast<int32_t> (std::floor ((dirtyRect.left - left) / stride));
+	// the column starting exactly at the right edge of the dirty rect is not drawn
+	auto last = static_cast<int32_t> (std::ceil ((dirtyRect.right - left) / stride)) - 1;
+	first = std::max (first, 0);
+	last = std::clamp (last, -1, static_cast<int32_t> (numMeters) - 1);
+	if (first > last)
+		return;
+
+	context->setDrawMode (kAliasing);
+	context->setFillColor (meterBackgroundColor);
+	for (auto i = first; i <= last; ++i)
+	{
+		auto r = getMeterRect (i);
+		r.bottom -= levelToHeight (valueToLevel (displayValues[i]));
+		r.bound (dirtyRect);
+		if (!r.isEmpty ())
+			context->drawRect (r, kDrawFilled);
+	}
+	context->setFillColor (meterColor);
+	for (auto i = first; i <= last; ++i)
+	{
+		auto level = valueToLevel (displayValues[i]);
+		auto r = getMeterRect (i);
+		r.top = r.bottom - levelToHeight (level);
+		r.bound (dirtyRect);
+		if (!r.isEmpty ())
+			context->drawRect (r, kDrawFilled);
+		drawnLevels[i] = level;
+	}
+	setDirty (false);
+}
+
+//------------------------------------------------------------------------
+//------------------------------------------------------------------------
+//------------------------------------------------------------------------
+static const std::string kAttrNumMeters = "num-meters";
+static const std::string kAttrMeterGap = "meter-gap";
+static const std::string kAttrMeterColor = "meter-color";
+static const std::string kAttrMeterBackgroundColor = "meter-background-color";
+
+//-----------------------------------------------------------------------------
+class MeterBankViewCreator : public ViewCreatorAdapter
+{
+public:
+	MeterBankViewCreator () { UIViewFactory::registerViewCreator (*this); }
+	IdStringPtr getViewName () const override { return "MeterBankView"; }
+	IdStringPtr getBaseViewName () const override { return UIViewCreator::kCView; }
+	UTF8StringPtr getDisplayName () const override { return "Meter Bank"; }
+	CView* create (const UIAttributes& attributes, const IUIDescription* description) const override
+	{
+		return new MeterBankView ();
+	}
+	bool getAttributeNames (std::list<std::string>& attributeNames) const override
+	{
+		attributeNames.push_back (kAttrNumMeters);
+		attributeNames.push_back (UIViewCreator::kAttrNumLed);
+		attributeNames.push_back (kAttrMeterGap);
+		attributeNames.push_back (UIViewCreator::kAttrDecreaseStepValue);
+		attributeNames.push_back (kAttrMeterColor);
+		attributeNames.push_back (kAttrMeterBackgroundColor);
+		return true;
+	}
+	AttrType getAttributeType (const std::string& attributeName) const override
+	{
+		if (attributeName == kAttrNumMeters)
+			return kIntegerType;
+		if (attributeName == UIViewCreator::kAttrNumLed)
+			return kIntegerType;
+		if (attributeName == kAttrMeterGap)
+			return kFloatType;
+		if (attributeName == UIViewCreator::kAttrDecreaseStepValue)
+			return kFloatType;
+		if (attributeName == kAttrMeterColor)
+			return kColorType;
+		if (attributeName == kAttrMeterBackgroundColor)
+			return kColorType;
+		return kUnknownType;
+	}
+	bool getAttributeValue (CView* view, const std::string& attributeName, std::string& stringValue,
+	                        const IUIDescription* desc) const override
+	{
+		auto mb = dynamic_cast<MeterBankView*> (view);
+		if (!mb)
+			return false;
+		if (attributeName == kAttrNumMeters)
+		{
+			stringValue =
+			    UIAttributes::integerToString (static_cast<int32_t> (mb->getNumMeters ()));
+			return true;
+		}
+		if (attributeName == UIViewCreator::kAttrNumLed)
+		{
+			stringValue = UIAttributes::integerToString (mb->getNumLed ());
+			return true;
+		}
+		if (attributeName == kAttrMeterGap)
+		{
+			stringValue = UIAttributes::doubleToString (mb->getMeterGap ());
+			return true;
+		}
+		if (attributeName == UIViewCreator::kAttrDecreaseStepValue)
+		{
+			stringValue = UIAttributes::doubleToString (mb->getDecreaseStepValue ());
+			return true;
+		}
+		if (attributeName == kAttrMeterColor)
+		{
+			UIViewCreator::colorToString (mb->getMeterColor (), stringValue, desc);
+			return true;
+		}
+		if (attributeName == kAttrMeterBackgroundColor)
+		{
+			UIViewCreator::colorToString (mb->getMeterBackgroundColor (), stringValue, desc);
+			return true;
+		}
+		return false;
+	}
+	bool apply (CView* view, const UIAttributes& attributes,
+	            const IUIDescription* desc) const override
+	{
+		auto mb = dynamic_cast<MeterBankView*> (view);
+		if (!mb)
+			return false;
+		int32_t i;
+		if (attributes.getIntegerAttribute (kAttrNumMeters, i))
+			mb->setNumMeters (static_cast<MeterBankView::MeterIndex> (std::max (i, 0)));
+		if (attributes.getIntegerAttribute (UIViewCreator::kAttrNumLed, i))
+			mb->setNumLed (i);
+		double d;
+		if (attributes.getDoubleAttribute (kAttrMeterGap, d))
+			mb->setMeterGap (d);
+		if (attributes.getDoubleAttribute (UIViewCreator::kAttrDecreaseStepValue, d))
+			mb->setDecreaseStepValue (static_cast<float> (d));
+		CColor color;
+		if (UIViewCreator::stringToColor (attributes.getAttributeValue (kAttrMeterColor), color,
+		                                  desc))
+			mb->setMeterColor (color);
+		if (UIViewCreator::stringToColor (attributes.getAttributeValue (kAttrMeterBackgroundColor),
+		                                  color, desc))
+			mb->setMeterBackgroundColor (color);
+		return true;
+	}
+	bool getAttributeValueRange (const std::string& attributeName, double& minValue,
+	                             double& maxValue) const override
+	{
+		if (attributeName == kAttrNumMeters)
+		{
+			minValue = 0;
+			maxValue = 4096;
+			return true;
+		}
+		return false;
+	}
+};
+MeterBankViewCreator gMeterBankViewCreator;
+
+//------------------------------------------------------------------------
+} // VSTGUI
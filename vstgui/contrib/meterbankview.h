@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#pragma once
+
+#include "vstgui/lib/vstguifwd.h"
+#include "vstgui/lib/ccolor.h"
+#include "vstgui/lib/cview.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Draws a bank of vertical level meters in one view
+ *
+ *	The meter values are stored in one contiguous buffer of atomic floats, so that
+ *	setMeterValue/setMeterValues can be called from any thread (e.g. the audio thread) without
+ *	locking. On every idle tick the view applies the decay, compares the quantized level of each
+ *	meter with the last drawn one and invalidates only the changed part of the changed columns.
+ *	Adjacent dirty columns are coalesced into one invalid rect.
+ *
+ *	Changing the number of meters is not thread safe and must be done on the UI thread while no
+ *	other thread writes values.
+ */
+class MeterBankView : public CView
+{
+public:
+	using MeterIndex = uint32_t;
+
+	MeterBankView (const CRect& size = CRect (0, 0, 0, 0), MeterIndex numMeters = 0);
+	~MeterBankView () noexcept override;
+
+	void setNumMeters (MeterIndex numMeters);
+	MeterIndex getNumMeters () const { return numMeters; }
+
+	/** set the normalized value [0..1] of one meter, thread safe */
+	void setMeterValue (MeterIndex index, float value);
+	/** set the normalized values of the first numValues meters, thread safe */
+	void setMeterValues (const float* values, MeterIndex numValues);
+	/** the currently displayed value including the decay, UI thread only */
+	float getMeterDisplayValue (MeterIndex index) const;
+
+	/** number of segments each meter is quantized to, 0 quantizes to pixels */
+	void setNumLed (int32_t num);
+	int32_t getNumLed () const { return numLed; }
+	void setMeterGap (CCoord gap);
+	CCoord getMeterGap () const { return meterGap; }
+	void setDecreaseStepValue (float value) { decreaseValue = value; }
+	float getDecreaseStepValue () const { return decreaseValue; }
+
+	void setMeterColor (CColor color);
+	void setMeterBackgroundColor (CColor color);
+	CColor getMeterColor () const { return meterColor; }
+	CColor getMeterBackgroundColor () const { return meterBackgroundColor; }
+
+	CRect getMeterRect (MeterIndex index) const;
+	/** returns the meter at the horizontal position x or -1 */
+	int32_t getMeterAt (CCoord x) const;
+
+	void drawRect (CDrawContext* context, const CRect& dirtyRect) override;
+	void setViewSize (const CRect& rect, bool invalid = true) override;
+	void onIdle () override;
+
+//------------------------------------------------------------------------
+private:
+	int32_t valueToLevel (float value) const;
+	CCoord levelToHeight (int32_t level) const;
+	CCoord getMeterWidth () const;
+	void invalidMeterRange (MeterIndex first, MeterIndex last, int32_t minLevel, int32_t maxLevel);
+
+	std::unique_ptr<std::atomic<float>[]> inputValues;
+	std::vector<float> displayValues;
+	std::vector<int32_t> drawnLevels;
+
+	MeterIndex numMeters {0};
+	int32_t numLed {0};
+	CCoord meterGap {1.};
+	float decreaseValue {0.1f};
+
+	CColor meterColor {kGreenCColor};
+	CColor meterBackgroundColor {kBlackCColor};
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
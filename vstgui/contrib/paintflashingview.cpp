@@ -0,0 +1,136 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#include "paintflashingview.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/drawprofiler.h"
+#include "vstgui/lib/platform/platformfactory.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr size_t kMaxFlashes = 512;
+static constexpr uint32_t kTimerInterval = 50;
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PaintFlashingView::PaintFlashingView (const CRect& size) : CView (size)
+{
+	setMouseEnabled (false);
+}
+
+//------------------------------------------------------------------------
+PaintFlashingView::~PaintFlashingView () noexcept = default;
+
+//------------------------------------------------------------------------
+bool PaintFlashingView::attached (CView* parent)
+{
+	if (!CView::attached (parent))
+		return false;
+	auto& profiler = DrawProfiler::instance ();
+	profilerWasEnabled = profiler.isEnabled ();
+	profiler.setEnabled (true);
+	// started when there are flashes
+	timer = makeOwned<CVSTGUITimer> ([this] (CVSTGUITimer*) { removeExpiredFlashes (); },
+									 kTimerInterval, false);
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool PaintFlashingView::removed (CView* parent)
+{
+	timer = nullptr;
+	flashes.clear ();
+	frameInvalidations.clear ();
+	frameInvalidationsIndex = ~static_cast<uint64_t> (0);
+	DrawProfiler::instance ().setEnabled (profilerWasEnabled);
+	return CView::removed (parent);
+}
+
+//------------------------------------------------------------------------
+void PaintFlashingView::updateFrameInvalidations ()
+{
+	auto& profiler = DrawProfiler::instance ();
+	auto frameIndex = profiler.getFrameIndex ();
+	if (frameIndex == frameInvalidationsIndex)
+		return;
+	frameInvalidationsIndex = frameIndex;
+	frameInvalidations.clear ();
+	auto frame = getFrame ();
+	if (!frame)
+		return;
+	// the invalid rects are recorded in frame coordinates
+	auto transform = frame->getTransform ().inverse ();
+	for (const auto& record : profiler.getRecords (frameIndex))
+	{
+		if (record.type != DrawProfiler::RecordType::Invalidation || record.view == this)
+			continue;
+		auto rect = record.rect;
+		transform.transform (rect);
+		frameInvalidations.emplace_back (rect);
+	}
+}
+
+//------------------------------------------------------------------------
+void PaintFlashingView::removeExpiredFlashes ()
+{
+	auto now = getPlatformFactory ().getTicks ();
+	auto it = std::remove_if (flashes.begin (), flashes.end (), [&] (const Flash& flash) {
+		if (now - flash.time < flashTime)
+			return false;
+		invalidRect (flash.rect);
+		return true;
+	});
+	flashes.erase (it, flashes.end ());
+	if (flashes.empty () && timer)
+		timer->stop ();
+}
+
+//------------------------------------------------------------------------
+void PaintFlashingView::drawRect (CDrawContext* context, const CRect& dirtyRect)
+{
+	if (!DrawProfiler::isAvailable ())
+		return;
+	updateFrameInvalidations ();
+	auto now = getPlatformFactory ().getTicks ();
+	for (auto rect : frameInvalidations)
+	{
+		rect.bound (dirtyRect);
+		if (rect.isEmpty ())
+			continue;
+		auto it = std::find_if (flashes.begin (), flashes.end (),
+								[&] (const Flash& flash) { return flash.rect == rect; });
+		if (it != flashes.end ())
+			it->time = now;
+		else
+			flashes.push_back ({rect, now});
+	}
+	if (flashes.size () > kMaxFlashes)
+	{
+		// expire the oldest flashes with the next timer
+		for (auto it = flashes.begin (); it != flashes.end () - kMaxFlashes; ++it)
+			it->time = 0;
+	}
+	if (!flashes.empty () && timer)
+		timer->start ();
+
+	context->setDrawMode (kAliasing);
+	context->setFillColor (flashColor);
+	for (const auto& flash : flashes)
+	{
+		auto rect = flash.rect;
+		rect.bound (dirtyRect);
+		if (!rect.isEmpty ())
+			context->drawRect (rect, kDrawFilled);
+	}
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
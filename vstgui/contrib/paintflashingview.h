@@ -0,0 +1,64 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+// Flags : clang-format SMTGSequencer
+
+#pragma once
+
+#include "vstgui/lib/ccolor.h"
+#include "vstgui/lib/cview.h"
+#include "vstgui/lib/cvstguitimer.h"
+#include <vector>
+
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Tints the regions which were repainted, to find views which repaint too much
+ *
+ *	Add the view as the last child of the frame with the size of the frame. It enables the
+ *	DrawProfiler while attached. While a frame is drawn, the parts of the dirty rects which were
+ *	invalidated by other views in this frame are tinted with the flash color. After the flash
+ *	time the tinted regions are invalidated again to remove the tint, these invalidations of the
+ *	view itself are not tinted.
+ *
+ *	Without VSTGUI_ENABLE_DRAW_PROFILER nothing is tinted.
+ */
+class PaintFlashingView : public CView
+{
+public:
+	PaintFlashingView (const CRect& size);
+	~PaintFlashingView () noexcept override;
+
+	void setFlashColor (CColor color) { flashColor = color; }
+	CColor getFlashColor () const { return flashColor; }
+	/** in milliseconds */
+	void setFlashTime (uint32_t time) { flashTime = time; }
+	uint32_t getFlashTime () const { return flashTime; }
+
+	void drawRect (CDrawContext* context, const CRect& dirtyRect) override;
+	bool hitTest (const CPoint& where, const Event& event = noEvent ()) override { return false; }
+	bool attached (CView* parent) override;
+	bool removed (CView* parent) override;
+
+//------------------------------------------------------------------------
+private:
+	struct Flash
+	{
+		CRect rect;
+		uint64_t time;
+	};
+
+	void updateFrameInvalidations ();
+	void removeExpiredFlashes ();
+
+	std::vector<Flash> flashes;
+	std::vector<CRect> frameInvalidations;
+	uint64_t frameInvalidationsIndex {~static_cast<uint64_t> (0)};
+	CColor flashColor {255, 0, 255, 90};
+	uint32_t flashTime {250};
+	bool profilerWasEnabled {false};
+	SharedPointer<CVSTGUITimer> timer;
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -27,6 +27,7 @@ It's recommended to start new projects with version 4 while old projects should
 - add crosshair mouse cursor (kCursorCrosshair)
 - customizable knob range (see CKnob::setKnobRange)
 - new layouts for CRowColumnView
+- optional frame cache for multi frame bitmaps (see CMultiFrameBitmap::setFrameCacheEnabled, CMultiFrameBitmap::setFrameCacheEnabledByDefault and the bitmap attribute "multiframe-frame-cache")
 
 @subsection version4_13 Version 4.13
 
@@ -145,6 +146,8 @@ Note: All current deprecated methods will be removed in the next version. So mak
 @subsection code_changes_4_13_to_4_14 VSTGUI 4.13 -> VSTGUI 4.14
 
 - In CParamDisplay::drawPlatformText(..) the string argument changed from IPlatformString to UTF8Text
+- CViewContainer stores its child views in a vector. The protected CViewContainer::getChildren is
+deprecated and returns a copy, use CViewContainer::getChildViews instead.
 
 @subsection code_changes_4_12_to_4_13 VSTGUI 4.12 -> VSTGUI 4.13
 
@@ -425,6 +428,14 @@ please see the "Migrating from 2.3.rtf" file in the Documentation folder.
  *	@ingroup new_in
  */
 //------------------------------------------------------------------------
+/*! @defgroup new_in_4_13 Version 4.13
+ *	@ingroup new_in
+ */
+//------------------------------------------------------------------------
+/*! @defgroup new_in_4_14 Version 4.14
+ *	@ingroup new_in
+ */
+//------------------------------------------------------------------------
 /*! @defgroup views Views
  *	@ingroup viewsandcontrols
  */
@@ -6,9 +6,16 @@
 #include "cdrawcontext.h"
 #include "ccolor.h"
 #include "algorithm.h"
+#include "coffscreencontext.h"
 #include "platform/iplatformbitmap.h"
 #include "platform/platformfactory.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace VSTGUI {
 
@@ -184,6 +191,38 @@ CMultiFrameBitmap::CMultiFrameBitmap (const CResourceDescription& desc,
 {
 }
 
+//-----------------------------------------------------------------------------
+CMultiFrameBitmap::~CMultiFrameBitmap () noexcept
+{
+	if (frameCacheEnabled)
+		MultiFrameBitmapCache::clear (this);
+}
+
+//-----------------------------------------------------------------------------
+void CMultiFrameBitmap::setFrameCacheEnabled (bool state)
+{
+	if (frameCacheEnabled == state)
+		return;
+	frameCacheEnabled = state;
+	if (!frameCacheEnabled)
+		MultiFrameBitmapCache::clear (this);
+}
+
+//-----------------------------------------------------------------------------
+static std::atomic<bool> gFrameCacheEnabledByDefault {false};
+
+//-----------------------------------------------------------------------------
+void CMultiFrameBitmap::setFrameCacheEnabledByDefault (bool state)
+{
+	gFrameCacheEnabledByDefault = state;
+}
+
+//-----------------------------------------------------------------------------
+bool CMultiFrameBitmap::isFrameCacheEnabledByDefault ()
+{
+	return gFrameCacheEnabledByDefault;
+}
+
 //-----------------------------------------------------------------------------
 bool CMultiFrameBitmap::setMultiFrameDesc (CMultiFrameBitmapDescription desc)
 {
@@ -192,6 +231,8 @@ bool CMultiFrameBitmap::setMultiFrameDesc (CMultiFrameBitmapDescription desc)
 	if (desc.frameSize.y * (desc.numFrames / desc.framesPerRow) > getSize ().y)
 		return false;
 	description = desc;
+	if (frameCacheEnabled)
+		MultiFrameBitmapCache::clear (this);
 	return true;
 }
 
@@ -227,8 +268,17 @@ CRect CMultiFrameBitmap::calcFrameRect (uint32_t frameIndex) const
 //-----------------------------------------------------------------------------
 void CMultiFrameBitmap::drawFrame (CDrawContext* context, uint16_t frameIndex, CPoint pos)
 {
-	auto fr = calcFrameRect (frameIndex);
 	auto r = CRect (pos, getFrameSize ());
+	if (frameCacheEnabled)
+	{
+		if (auto frame = MultiFrameBitmapCache::getFrame (*this, frameIndex,
+														  context->getScaleFactor ()))
+		{
+			frame->draw (context, r);
+			return;
+		}
+	}
+	auto fr = calcFrameRect (frameIndex);
 	draw (context, r, fr.getTopLeft ());
 }
 
@@ -244,6 +294,236 @@ float CMultiFrameBitmap::frameIndexToNormalizedValue (uint16_t frameIndex) const
 	return stepsToNormalized<float, uint16_t> (frameIndex, getNumFrames () - 1);
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+struct FrameCacheKey
+{
+	const CMultiFrameBitmap* bitmap;
+	uint16_t frameIndex;
+	double scaleFactor;
+
+	bool operator== (const FrameCacheKey& o) const
+	{
+		return bitmap == o.bitmap && frameIndex == o.frameIndex && scaleFactor == o.scaleFactor;
+	}
+};
+
+//-----------------------------------------------------------------------------
+struct FrameCacheKeyHash
+{
+	size_t operator() (const FrameCacheKey& key) const
+	{
+		auto h = std::hash<const void*> {}(key.bitmap);
+		h ^= std::hash<uint32_t> {}(key.frameIndex) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		h ^= std::hash<double> {}(key.scaleFactor) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		return h;
+	}
+};
+
+//-----------------------------------------------------------------------------
+struct FrameCacheEntry
+{
+	FrameCacheKey key;
+	/** the platform bitmap the frame was extracted from, only used for comparison */
+	const IPlatformBitmap* source;
+	SharedPointer<CBitmap> frame;
+	size_t byteSize;
+};
+
+//-----------------------------------------------------------------------------
+SharedPointer<CBitmap> extractFrame (const PlatformBitmapPtr& source, CRect frameRect,
+									 size_t& byteSize)
+{
+	auto scaleFactor = source->getScaleFactor ();
+	frameRect.left *= scaleFactor;
+	frameRect.top *= scaleFactor;
+	frameRect.right *= scaleFactor;
+	frameRect.bottom *= scaleFactor;
+	frameRect.makeIntegral ();
+	frameRect.bound (CRect ({}, source->getSize ()));
+	if (frameRect.isEmpty ())
+		return nullptr;
+
+	// The frame is drawn out of the strip instead of copied via lockPixels, because locking the
+	// pixels of the strip would discard the resampled copy a platform bitmap may keep of it (see
+	// Cairo::Bitmap::getScaledSurface) and would collide with a concurrent draw of the strip.
+	CPoint frameSize (frameRect.getWidth () / scaleFactor, frameRect.getHeight () / scaleFactor);
+	auto offscreen = COffscreenContext::create (frameSize, scaleFactor);
+	if (!offscreen || !offscreen->getBitmap ())
+		return nullptr;
+	auto strip = makeOwned<CBitmap> (source);
+	offscreen->beginDraw ();
+	strip->draw (offscreen, CRect ({}, frameSize),
+				 CPoint (frameRect.left / scaleFactor, frameRect.top / scaleFactor));
+	offscreen->endDraw ();
+
+	// copy the frame into a bitmap which was never a draw target, so that platforms can keep a
+	// resampled copy of it
+	auto frameBitmap = getPlatformFactory ().createBitmap (frameRect.getSize ());
+	if (!frameBitmap)
+		return nullptr;
+	frameBitmap->setScaleFactor (scaleFactor);
+	auto srcAccess = offscreen->getBitmap ()->getPlatformBitmap ()->lockPixels (true);
+	auto dstAccess = frameBitmap->lockPixels (true);
+	if (!srcAccess || !dstAccess || srcAccess->getPixelFormat () != dstAccess->getPixelFormat ())
+		return nullptr;
+	// at fractional scale factors the offscreen may be a pixel smaller than the frame rect
+	const auto& srcSize = offscreen->getBitmap ()->getPlatformBitmap ()->getSize ();
+	const auto& dstSize = frameBitmap->getSize ();
+	auto width = static_cast<uint32_t> (std::min (srcSize.x, dstSize.x));
+	auto height = static_cast<uint32_t> (std::min (srcSize.y, dstSize.y));
+	auto rowBytes = width * 4;
+	auto src = srcAccess->getAddress ();
+	auto dst = dstAccess->getAddress ();
+	for (auto y = 0u; y < height; ++y)
+	{
+		std::memcpy (dst, src, rowBytes);
+		src += srcAccess->getBytesPerRow ();
+		dst += dstAccess->getBytesPerRow ();
+	}
+	byteSize = static_cast<size_t> (dstAccess->getBytesPerRow ()) * height;
+	srcAccess = nullptr;
+	dstAccess = nullptr;
+	return makeOwned<CBitmap> (frameBitmap);
+}
+
+//-----------------------------------------------------------------------------
+struct FrameCache
+{
+	using EntryList = std::list<FrameCacheEntry>;
+
+	std::mutex mutex;
+	EntryList entries; // most recently used first
+	std::unordered_map<FrameCacheKey, EntryList::iterator, FrameCacheKeyHash> map;
+	size_t memoryBudget {MultiFrameBitmapCache::kDefaultMemoryBudget};
+	MultiFrameBitmapCache::Statistics stats;
+
+	static FrameCache& instance ()
+	{
+		static FrameCache gInstance;
+		return gInstance;
+	}
+
+	void remove (EntryList::iterator it)
+	{
+		stats.memoryUsage -= it->byteSize;
+		map.erase (it->key);
+		entries.erase (it);
+	}
+
+	void shrinkTo (size_t bytes)
+	{
+		while (!entries.empty () && stats.memoryUsage > bytes)
+		{
+			remove (std::prev (entries.end ()));
+			++stats.evictions;
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+void MultiFrameBitmapCache::setMemoryBudget (size_t bytes)
+{
+	auto& cache = FrameCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	cache.memoryBudget = bytes;
+	cache.shrinkTo (bytes);
+}
+
+//-----------------------------------------------------------------------------
+size_t MultiFrameBitmapCache::getMemoryBudget ()
+{
+	auto& cache = FrameCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	return cache.memoryBudget;
+}
+
+//-----------------------------------------------------------------------------
+auto MultiFrameBitmapCache::getStatistics () -> Statistics
+{
+	auto& cache = FrameCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	auto result = cache.stats;
+	result.numFrames = cache.entries.size ();
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+void MultiFrameBitmapCache::clear ()
+{
+	auto& cache = FrameCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	cache.entries.clear ();
+	cache.map.clear ();
+	cache.stats.memoryUsage = 0;
+}
+
+//-----------------------------------------------------------------------------
+void MultiFrameBitmapCache::clear (const CMultiFrameBitmap* bitmap)
+{
+	auto& cache = FrameCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	for (auto it = cache.entries.begin (); it != cache.entries.end ();)
+	{
+		auto next = std::next (it);
+		if (it->key.bitmap == bitmap)
+			cache.remove (it);
+		it = next;
+	}
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<CBitmap> MultiFrameBitmapCache::getFrame (const CMultiFrameBitmap& bitmap,
+														uint16_t frameIndex, double scaleFactor)
+{
+	auto source = bitmap.getBestPlatformBitmapForScaleFactor (scaleFactor);
+	if (!source)
+		return nullptr;
+	FrameCacheKey key {&bitmap, frameIndex, source->getScaleFactor ()};
+
+	auto& cache = FrameCache::instance ();
+	{
+		std::lock_guard<std::mutex> guard (cache.mutex);
+		auto it = cache.map.find (key);
+		if (it != cache.map.end ())
+		{
+			if (it->second->source == source.get ())
+			{
+				++cache.stats.hits;
+				cache.entries.splice (cache.entries.begin (), cache.entries, it->second);
+				return it->second->frame;
+			}
+			cache.remove (it->second);
+		}
+		++cache.stats.misses;
+		if (cache.memoryBudget == 0)
+			return nullptr;
+	}
+
+	size_t byteSize = 0;
+	auto frame = extractFrame (source, bitmap.calcFrameRect (frameIndex), byteSize);
+	if (!frame)
+		return nullptr;
+
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	if (byteSize > cache.memoryBudget)
+		return nullptr;
+	if (cache.map.find (key) != cache.map.end ())
+		return frame;
+	cache.shrinkTo (cache.memoryBudget - byteSize);
+	cache.entries.push_front ({key, source.get (), frame, byteSize});
+	cache.map.emplace (key, cache.entries.begin ());
+	cache.stats.memoryUsage += byteSize;
+	return frame;
+}
+
 //-----------------------------------------------------------------------------
 // CNinePartTiledBitmap Implementation
 //-----------------------------------------------------------------------------
@@ -104,6 +104,7 @@ public:
 
 	CMultiFrameBitmap (const CResourceDescription& desc,
 					   CMultiFrameBitmapDescription multiFrameDesc);
+	~CMultiFrameBitmap () noexcept override;
 
 	/** set the multi frame description
 	 *
@@ -144,8 +145,84 @@ public:
 	 */
 	virtual float frameIndexToNormalizedValue (uint16_t frameIndex) const;
 
+	/** enable the frame cache
+	 *
+	 *	if enabled, drawFrame draws the frames from separate per frame bitmaps which are extracted
+	 *	on first use and managed by the MultiFrameBitmapCache. This avoids that the whole bitmap
+	 *	strip needs to be prepared for drawing for every frame drawn.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setFrameCacheEnabled (bool state);
+	/** check if the frame cache is enabled
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	bool isFrameCacheEnabled () const { return frameCacheEnabled; }
+	/** set if the frame cache of multi frame bitmaps created afterwards is enabled
+	 *
+	 *	the default is disabled. In UI descriptions the bitmap attribute "multiframe-frame-cache"
+	 *	overrides the default per bitmap.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	static void setFrameCacheEnabledByDefault (bool state);
+	/** check if the frame cache of new multi frame bitmaps is enabled
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	static bool isFrameCacheEnabledByDefault ();
+
 private:
 	CMultiFrameBitmapDescription description;
+	bool frameCacheEnabled {isFrameCacheEnabledByDefault ()};
+};
+
+//-----------------------------------------------------------------------------
+/** Process wide cache of single frame bitmaps extracted from CMultiFrameBitmaps
+ *
+ *	All multi frame bitmaps with an enabled frame cache share one memory budget. If adding a frame
+ *	would exceed the budget, the least recently used frames are evicted.
+ *
+ *	The cache is thread safe, but the frames are only extracted on the thread which draws.
+ *
+ *	@ingroup new_in_4_14
+ */
+class MultiFrameBitmapCache
+{
+public:
+	struct Statistics
+	{
+		uint64_t hits {0};
+		uint64_t misses {0};
+		uint64_t evictions {0};
+		size_t numFrames {0};
+		size_t memoryUsage {0};
+	};
+
+	/** set the memory budget in bytes, evicts frames if the current usage exceeds the budget */
+	static void setMemoryBudget (size_t bytes);
+	/** get the memory budget in bytes */
+	static size_t getMemoryBudget ();
+	/** get the current statistics */
+	static Statistics getStatistics ();
+	/** remove all cached frames */
+	static void clear ();
+	/** remove all cached frames of one bitmap */
+	static void clear (const CMultiFrameBitmap* bitmap);
+	/** get the bitmap for one frame
+	 *
+	 *	@param bitmap the multi frame bitmap
+	 *	@param frameIndex the index of the frame
+	 *	@param scaleFactor the scale factor the frame will be drawn with
+	 *	@return the frame bitmap or nullptr if the frame could not be extracted or does not fit
+	 *	into the memory budget
+	 */
+	static SharedPointer<CBitmap> getFrame (const CMultiFrameBitmap& bitmap, uint16_t frameIndex,
+											double scaleFactor);
+
+	/** the default memory budget (64 MB) */
+	static constexpr size_t kDefaultMemoryBudget = 64 * 1024 * 1024;
 };
 
 //------------------------------------------------------------------------
@@ -46,10 +46,47 @@ public:
 
 	bool drawFocusOnTop () override;
 	bool getFocusPath (CGraphicsPath& outPath) override;
+
+	struct Layout
+	{
+		CCoord lineWidth {0};
+		CColor lineColor;
+		/** row height including the row line */
+		CCoord rowHeight {0};
+		int32_t numRows {0};
+		/** start offset of every column plus the total width, including the column lines */
+		std::vector<CCoord> columnOffsets;
+		/** width of the column lines */
+		CCoord columnLineWidth {0};
+
+		int32_t getNumColumns () const { return static_cast<int32_t> (columnOffsets.size ()) - 1; }
+		CCoord getColumnWidth (int32_t column) const
+		{
+			return columnOffsets[column + 1] - columnOffsets[column] - columnLineWidth;
+		}
+		int32_t getRowAt (CCoord y) const
+		{
+			return rowHeight > 0. ? static_cast<int32_t> (y / rowHeight) : 0;
+		}
+		int32_t getColumnAt (CCoord x) const
+		{
+			auto it = std::upper_bound (columnOffsets.begin () + 1, columnOffsets.end (), x);
+			return static_cast<int32_t> (std::distance (columnOffsets.begin () + 1, it));
+		}
+	};
+
+	/** get the layout, with the kVirtualizedLayout style it is only updated after
+	 *	invalidateLayout was called */
+	const Layout& getLayout ();
+	void invalidateLayout () { layoutValid = false; }
+
 protected:
+	void updateLayout ();
 
 	IDataBrowserDelegate* db;
 	CDataBrowser* browser;
+	Layout layout;
+	bool layoutValid {false};
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -57,7 +94,8 @@ class CDataBrowserHeader : public CView
 //-----------------------------------------------------------------------------------------------
 {
 public:
-	CDataBrowserHeader (const CRect& size, IDataBrowserDelegate* db, CDataBrowser* browser);
+	CDataBrowserHeader (const CRect& size, IDataBrowserDelegate* db, CDataBrowser* browser,
+						CDataBrowserView* dbView);
 
 	void draw (CDrawContext* context) override;
 	void drawRect (CDrawContext* context, const CRect& updateRect) override;
@@ -71,6 +109,7 @@ protected:
 
 	IDataBrowserDelegate* db;
 	CDataBrowser* browser;
+	CDataBrowserView* dbView;
 
 	CPoint startMousePoint;
 	int32_t mouseColumn {0};
@@ -233,6 +272,7 @@ void CDataBrowser::recalculateSubViews ()
  */
 void CDataBrowser::recalculateLayout (bool rememberSelection)
 {
+	dbView->invalidateLayout ();
 	CCoord lineWidth = 0;
 	CColor lineColor;
 	db->dbGetLineWidthAndColor (lineWidth, lineColor, this);
@@ -267,7 +307,7 @@ void CDataBrowser::recalculateLayout (bool rememberSelection)
 			dbHeaderContainer->setAutosizeFlags (kAutosizeLeft|kAutosizeRight|kAutosizeTop);
 			dbHeaderContainer->setTransparency (true);
 			headerSize.offset (-headerSize.left, -headerSize.top);
-			dbHeader = new CDataBrowserHeader (headerSize, db, this);
+			dbHeader = new CDataBrowserHeader (headerSize, db, this, dbView);
 			dbHeader->setAutosizeFlags (kAutosizeLeft|kAutosizeRight|kAutosizeTop);
 			dbHeaderContainer->addView (dbHeader);
 			CViewContainer::addView (dbHeaderContainer, nullptr);
@@ -303,7 +343,7 @@ void CDataBrowser::recalculateLayout (bool rememberSelection)
 
 	if (style & kDrawHeader)
 	{
-		for (const auto& pV : getChildren ())
+		for (const auto& pV : getChildViews ())
 		{
 			CRect viewSize = pV->getViewSize ();
 			if (pV != dbHeaderContainer && viewSize.top < headerHeight+lineWidth)
@@ -326,6 +366,7 @@ void CDataBrowser::recalculateLayout (bool rememberSelection)
 		}
 	}
 	
+	dbView->invalidateLayout ();
 	if (isAttached ())
 		invalid ();
 		
@@ -497,26 +538,12 @@ void CDataBrowser::validateSelection ()
  */
 CRect CDataBrowser::getCellBounds (const Cell& cell)
 {
-	CCoord lineWidth = 0;
-	if (style & kDrawRowLines || style & kDrawColumnLines)
+	const auto& layout = dbView->getLayout ();
+	CRect result (0, layout.rowHeight * cell.row, 0, layout.rowHeight * (cell.row + 1));
+	if (cell.column >= 0 && cell.column < layout.getNumColumns ())
 	{
-		CColor lineColor;
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, this);
-	}
-	CCoord rowHeight = db->dbGetRowHeight (this);
-	if (style & kDrawRowLines)
-		rowHeight += lineWidth;
-	CRect result (0, rowHeight * cell.row, 0, rowHeight * (cell.row+1));
-	for (int32_t i = 0; i <= cell.column; i++)
-	{
-		CCoord colWidth = db->dbGetCurrentColumnWidth (i, this);
-		if (i != cell.column)
-		{
-			result.offset (colWidth, 0);
-			if (style & kDrawColumnLines)
-				result.offset (lineWidth, 0);
-		}
-		result.setWidth (colWidth);
+		result.left = layout.columnOffsets[cell.column];
+		result.setWidth (layout.getColumnWidth (cell.column));
 	}
 	CRect viewSize = dbView->getViewSize ();
 	result.offset (viewSize.left, viewSize.top);
@@ -583,10 +610,12 @@ CMessageResult CDataBrowser::notify (CBaseObject* sender, IdStringPtr message)
 //-----------------------------------------------------------------------------------------------
 //-----------------------------------------------------------------------------------------------
 //-----------------------------------------------------------------------------------------------
-CDataBrowserHeader::CDataBrowserHeader (const CRect& size, IDataBrowserDelegate* db, CDataBrowser* browser)
+CDataBrowserHeader::CDataBrowserHeader (const CRect& size, IDataBrowserDelegate* db, CDataBrowser* browser,
+										CDataBrowserView* dbView)
 : CView (size)
 , db (db)
 , browser (browser)
+, dbView (dbView)
 {
 	setTransparency (true);
 }
@@ -600,32 +629,25 @@ void CDataBrowserHeader::draw (CDrawContext* context)
 //-----------------------------------------------------------------------------------------------
 void CDataBrowserHeader::drawRect (CDrawContext* context, const CRect& updateRect)
 {
-	CColor lineColor;
-	CCoord lineWidth = 0;
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
-	{
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
-	}
+	const auto& layout = dbView->getLayout ();
 	CCoord headerHeight = db->dbGetHeaderHeight (browser);
 	if (browser->getStyle () & CDataBrowser::kDrawRowLines)
-		headerHeight += lineWidth;
-	int32_t numColumns = db->dbGetNumColumns (browser);
+		headerHeight += layout.lineWidth;
 
 	CRect r (getViewSize ().left, getViewSize ().top, 0, 0);
 	r.setHeight (headerHeight);
-	for (int32_t col = 0; col < numColumns; col++)
+	for (int32_t col = 0; col < layout.getNumColumns (); col++)
 	{
-		CCoord columnWidth = db->dbGetCurrentColumnWidth (col, browser);
-		r.setWidth (columnWidth);
-		if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
-			r.right += lineWidth;
+		r.left = getViewSize ().left + layout.columnOffsets[col];
+		r.right = getViewSize ().left + layout.columnOffsets[col + 1];
+		if (r.left >= updateRect.right)
+			break;
 		CRect testRect (r);
 		testRect.bound (updateRect);
 		if (!testRect.isEmpty ())
 		{
 			db->dbDrawHeader (context, r, col, 0, browser);
 		}
-		r.offset (r.getWidth (), 0);
 	}
 	setDirty (false);
 }
@@ -633,31 +655,15 @@ void CDataBrowserHeader::drawRect (CDrawContext* context, const CRect& updateRec
 //-----------------------------------------------------------------------------------------------
 int32_t CDataBrowserHeader::getColumnAtPoint (CPoint& where)
 {
-	// calculate column at point
-	CCoord lineWidth = 0;
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
-	{
-		CColor lineColor;
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
-	}
-	int32_t col = -1;
-	int32_t numColumns = db->dbGetNumColumns (browser);
-	CRect r (getViewSize ().left, getViewSize ().top, 0, getViewSize ().bottom);
-	for (int32_t c = 0; c < numColumns; c++)
-	{
-		CCoord columnWidth = db->dbGetCurrentColumnWidth (c, browser);
-		if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
-			columnWidth += lineWidth;
-		r.setWidth (columnWidth);
-		if (r.pointInside (where))
-		{
-			if (r.right - where.x < 5)
-				col = c;
-			break;
-		}
-		r.offset (columnWidth, 0);
-	}
-	return col;
+	const auto& layout = dbView->getLayout ();
+	if (!getViewSize ().pointInside (where))
+		return -1;
+	auto col = layout.getColumnAt (where.x - getViewSize ().left);
+	if (col >= layout.getNumColumns ())
+		return -1;
+	if (getViewSize ().left + layout.columnOffsets[col + 1] - where.x < 5)
+		return col;
+	return -1;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -743,21 +749,44 @@ CDataBrowserView::CDataBrowserView (const CRect& size, IDataBrowserDelegate* db,
 }
 
 //-----------------------------------------------------------------------------------------------
-CRect CDataBrowserView::getRowBounds (int32_t row)
+void CDataBrowserView::updateLayout ()
 {
-	CCoord lineWidth = 0;
+	layout.lineWidth = 0;
 	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
 	{
-		CColor lineColor;
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
+		db->dbGetLineWidthAndColor (layout.lineWidth, layout.lineColor, browser);
 	}
-	CCoord rowHeight = db->dbGetRowHeight (browser);
-
-	CRect where (getViewSize ());
-	where.originize ();
+	layout.rowHeight = db->dbGetRowHeight (browser);
 	if (browser->getStyle () & CDataBrowser::kDrawRowLines)
-		rowHeight+=lineWidth;
+		layout.rowHeight += layout.lineWidth;
+	layout.numRows = db->dbGetNumRows (browser);
+	layout.columnLineWidth =
+		(browser->getStyle () & CDataBrowser::kDrawColumnLines) ? layout.lineWidth : 0.;
+
+	int32_t numColumns = std::max<int32_t> (db->dbGetNumColumns (browser), 0);
+	layout.columnOffsets.resize (static_cast<size_t> (numColumns) + 1);
+	layout.columnOffsets[0] = 0.;
+	for (int32_t col = 0; col < numColumns; col++)
+	{
+		layout.columnOffsets[col + 1] = layout.columnOffsets[col] +
+										db->dbGetCurrentColumnWidth (col, browser) +
+										layout.columnLineWidth;
+	}
+	layoutValid = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+auto CDataBrowserView::getLayout () -> const Layout&
+{
+	if (!layoutValid || !(browser->getStyle () & CDataBrowser::kVirtualizedLayout))
+		updateLayout ();
+	return layout;
+}
 
+//-----------------------------------------------------------------------------------------------
+CRect CDataBrowserView::getRowBounds (int32_t row)
+{
+	CCoord rowHeight = getLayout ().rowHeight;
 	CRect r (getViewSize ().left, getViewSize ().top + rowHeight * row, getViewSize ().right, getViewSize ().top + rowHeight * (row+1));
 	return r;
 }
@@ -782,36 +811,44 @@ void CDataBrowserView::draw (CDrawContext* context)
 void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 {
 	const bool drawRowLines = (browser->getStyle () & CDataBrowser::kDrawRowLines) ? true : false;
-	CCoord lineWidth = 0;
-	CColor lineColor;
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
-	{
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
-	}
-
-	CCoord rowHeight = db->dbGetRowHeight (browser);
-	if (drawRowLines)
-		rowHeight += lineWidth;
-	int32_t numRows = db->dbGetNumRows (browser);
-	int32_t numColumns = db->dbGetNumColumns (browser);
+	const auto& layout = getLayout ();
+	const auto lineWidth = layout.lineWidth;
+	const auto rowHeight = layout.rowHeight;
+	const auto numColumns = layout.getNumColumns ();
 
 	const CDataBrowser::Selection& selection = browser->getSelection ();
 
 	CDrawContext::LineList lines;
 
+	// only visit the rows and columns intersecting the update rect, the row lines may reach into
+	// the update rect from the row above or below
+	int32_t firstRow = 0;
+	int32_t lastRow = -1;
+	if (layout.numRows > 0 && rowHeight > 0.)
+	{
+		firstRow = std::max<int32_t> (layout.getRowAt (updateRect.top - getViewSize ().top) - 1, 0);
+		lastRow = std::min<int32_t> (layout.getRowAt (updateRect.bottom - getViewSize ().top) + 1,
+									layout.numRows - 1);
+	}
+	int32_t firstColumn = std::min<int32_t> (
+		layout.getColumnAt (std::max<CCoord> (updateRect.left - getViewSize ().left, 0.)), numColumns);
+
 	CRect r (getViewSize ());
+	r.offset (0, rowHeight * firstRow);
 	r.setHeight (rowHeight - lineWidth);
-	for (int32_t row = 0; row < numRows; row++)
+	for (int32_t row = firstRow; row <= lastRow; row++)
 	{
 		CRect testRect (r);
 		testRect.bound (updateRect);
 		if (testRect.isEmpty () == false)
 		{
 			bool isSelected = std::find (selection.begin (), selection.end (), row) != selection.end ();
-			for (int32_t col = 0; col < numColumns; col++)
+			for (int32_t col = firstColumn; col < numColumns; col++)
 			{
-				CCoord columnWidth = db->dbGetCurrentColumnWidth (col, browser);
-				r.setWidth (columnWidth);
+				r.left = getViewSize ().left + layout.columnOffsets[col];
+				r.setWidth (layout.getColumnWidth (col));
+				if (r.left >= updateRect.right)
+					break;
 				testRect = r;
 				testRect.bound (updateRect);
 				if (testRect.isEmpty () == false)
@@ -822,9 +859,6 @@ void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 					cellSize.right++;
 					db->dbDrawCell (context, cellSize, row, col, isSelected ? IDataBrowserDelegate::kRowSelected : 0, browser);
 				}
-				r.offset (columnWidth, 0);
-				if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
-					r.offset (lineWidth, 0);
 			}
 		}
 		r.left = getViewSize ().left;
@@ -835,18 +869,12 @@ void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 	}
 	if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
 	{
-		
-		CPoint p1;
-		CPoint p2;
-		if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
+		CPoint p1 (0, getViewSize ().top);
+		CPoint p2 (0, getViewSize ().bottom);
+		for (int32_t col = 0; col < numColumns - 1; col++)
 		{
-			p1 (getViewSize ().left - lineWidth, getViewSize ().top);
-			p2 (getViewSize ().left - lineWidth, getViewSize ().bottom);
-			for (int32_t col = 0; col < numColumns - 1; col++)
-			{
-				p1.x = p2.x = p1.x + db->dbGetCurrentColumnWidth (col, browser) + lineWidth;
-				lines.emplace_back (p1, p2);
-			}
+			p1.x = p2.x = getViewSize ().left + layout.columnOffsets[col + 1] - lineWidth;
+			lines.emplace_back (p1, p2);
 		}
 	}
 	if (!lines.empty ())
@@ -854,7 +882,7 @@ void CDataBrowserView::drawRect (CDrawContext* context, const CRect& updateRect)
 		context->setClipRect (updateRect);
 		context->setDrawMode (kAntiAliasing);
 		context->setLineWidth (lineWidth);
-		context->setFrameColor (lineColor);
+		context->setFrameColor (layout.lineColor);
 		context->setLineStyle (kLineSolid);
 		context->drawLines (lines);
 	}
@@ -868,33 +896,15 @@ bool CDataBrowserView::getCell (const CPoint& where, CDataBrowser::Cell& cell)
 	_where.offset (-getViewSize ().left, -getViewSize ().top);
 	if (_where.x < 0)
 		return false;
-	
-	CCoord lineWidth = 0;
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines || browser->getStyle () & CDataBrowser::kDrawColumnLines)
-	{
-		CColor lineColor;
-		db->dbGetLineWidthAndColor (lineWidth, lineColor, browser);
-	}
-	CCoord rowHeight = db->dbGetRowHeight (browser);
-	int32_t numColumns = db->dbGetNumColumns (browser);
 
-	if (browser->getStyle () & CDataBrowser::kDrawRowLines)
-		rowHeight += lineWidth;
-	int32_t rowNum = (int32_t)(_where.y / rowHeight);
-	int32_t colNum = 0;
-	CCoord cw = 0;
-	for (int32_t i = 0; i < numColumns; i++)
+	const auto& layout = getLayout ();
+	int32_t rowNum = layout.getRowAt (_where.y);
+	int32_t colNum = layout.getColumnAt (_where.x);
+	if (rowNum < layout.numRows && colNum < layout.getNumColumns ())
 	{
-		cw += db->dbGetCurrentColumnWidth (i, browser);
-		if (browser->getStyle () & CDataBrowser::kDrawColumnLines)
-			cw += lineWidth;
-		if (_where.x < cw && rowNum < db->dbGetNumRows (browser) && colNum < db->dbGetNumColumns (browser))
-		{
-			colNum = i;
-			cell.row = rowNum;
-			cell.column = colNum;
-			return true;
-		}
+		cell.row = rowNum;
+		cell.column = colNum;
+		return true;
 	}
 	return false;
 }
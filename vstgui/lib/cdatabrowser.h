@@ -30,7 +30,8 @@ protected:
 		kDrawRowLinesFlag = kLastScrollViewStyleFlag,
 		kDrawColumnLinesFlag,
 		kDrawHeaderFlag,
-		kMultiSelectionStyleFlag
+		kMultiSelectionStyleFlag,
+		kVirtualizedLayoutFlag
 	};
 	
 public:
@@ -42,7 +43,11 @@ public:
 		kDrawRowLines			= 1 << kDrawRowLinesFlag,
 		kDrawColumnLines		= 1 << kDrawColumnLinesFlag,
 		kDrawHeader				= 1 << kDrawHeaderFlag,
-		kMultiSelectionStyle	= 1 << kMultiSelectionStyleFlag
+		kMultiSelectionStyle	= 1 << kMultiSelectionStyleFlag,
+		/** the row height, the line width and the column widths are only queried from the
+		 *	delegate in recalculateLayout, so the delegate must call recalculateLayout when one of
+		 *	them changes */
+		kVirtualizedLayout		= 1 << kVirtualizedLayoutFlag
 	};
 
 	enum
@@ -66,7 +71,8 @@ public:
 	/// @name CDataBrowser Methods
 	//-----------------------------------------------------------------------------
 	//@{
-	/** trigger recalculation, call if numRows or numColumns changed */
+	/** trigger recalculation, call if numRows or numColumns changed (or with the
+	 *	kVirtualizedLayout style if the row height or a column width changed) */
 	virtual void recalculateLayout (bool rememberSelection = false);
 	/** invalidates an individual cell */
 	virtual void invalidate (const Cell& cell);
@@ -343,13 +343,27 @@ CCoord CDrawContext::getStringWidth (IPlatformString* string)
 
 //------------------------------------------------------------------------
 void CDrawContext::drawString (IPlatformString* string, const CRect& _rect, const CHoriTxtAlign hAlign, bool antialias)
+{
+	if (auto layout = createTextLayout (string, antialias))
+		drawTextLayout (layout, _rect, hAlign);
+}
+
+//------------------------------------------------------------------------
+PlatformTextLayoutPtr CDrawContext::createTextLayout (IPlatformString* string, bool antialias)
 {
 	if (!string || impl->currentState.font == nullptr)
+		return nullptr;
+	if (auto painter = impl->currentState.font->getFontPainter ())
+		return painter->createTextLayout (impl->device, string, antialias);
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+void CDrawContext::drawTextLayout (IPlatformTextLayout* layout, const CRect& _rect, const CHoriTxtAlign hAlign)
+{
+	if (!layout || impl->currentState.font == nullptr)
 		return;
-	auto painter = impl->currentState.font->getFontPainter ();
-	if (painter == nullptr)
-		return;
-	
+
 	CRect rect (_rect);
 	
 	double capHeight = -1;
@@ -363,15 +377,14 @@ void CDrawContext::drawString (IPlatformString* string, const CRect& _rect, cons
 		rect.bottom -= (rect.getHeight () / 2. - impl->currentState.font->getSize () / 2.) + 1.;
 	if (hAlign != kLeftText)
 	{
-		CCoord stringWidth = painter->getStringWidth (impl->device, string, antialias);
+		CCoord stringWidth = layout->getWidth ();
 		if (hAlign == kRightText)
 			rect.left = rect.right - stringWidth;
 		else
 			rect.left = rect.left + (rect.getWidth () / 2.) - (stringWidth / 2.);
 	}
 
-	painter->drawString (impl->device, string, CPoint (rect.left, rect.bottom),
-						 impl->currentState.fontColor, antialias);
+	layout->draw (impl->device, CPoint (rect.left, rect.bottom), impl->currentState.fontColor);
 }
 
 //------------------------------------------------------------------------
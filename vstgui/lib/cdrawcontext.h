@@ -173,6 +173,18 @@ public:
 					 const CHoriTxtAlign hAlign = kCenterText, bool antialias = true);
 	/** draw a platform string */
 	void drawString (IPlatformString* string, const CPoint& _point, bool antialias = true);
+
+	/** create a text layout of a platform string with the current font
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	PlatformTextLayoutPtr createTextLayout (IPlatformString* string, bool antialias = true);
+	/** draw a text layout created with the current font like drawString
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void drawTextLayout (IPlatformTextLayout* layout, const CRect& _rect,
+						 const CHoriTxtAlign hAlign = kCenterText);
 	//@}
 	
 	//-----------------------------------------------------------------------------
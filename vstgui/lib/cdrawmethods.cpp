@@ -7,55 +7,89 @@
 #include "cstring.h"
 #include "cdrawcontext.h"
 #include "platform/iplatformfont.h"
+#include <iterator>
+#include <vector>
 
 namespace VSTGUI {
 
 namespace CDrawMethods {
 
+//------------------------------------------------------------------------
+static CCoord getTextLayoutWidth (const IFontPainter* painter, const UTF8String& text)
+{
+	auto layout = painter->createTextLayout (nullptr, text.getPlatformString (), true);
+	return layout ? layout->getWidth () : 0.;
+}
+
 //------------------------------------------------------------------------
 UTF8String createTruncatedText (TextTruncateMode mode, const UTF8String& text, CFontRef font,
                                 CCoord maxWidth, const CPoint& textInset, uint32_t flags)
 {
-	if (mode == kTextTruncateNone)
+	if (mode == kTextTruncateNone || text.empty ())
 		return text;
 	auto painter = font->getPlatformFont () ? font->getPlatformFont ()->getPainter () : nullptr;
 	if (!painter)
 		return text;
-	CCoord width = painter->getStringWidth (nullptr, text.getPlatformString (), true);
-	width += textInset.x * 2;
-	if (width > maxWidth)
+	auto layout = painter->createTextLayout (nullptr, text.getPlatformString (), true);
+	if (!layout || layout->getWidth () + textInset.x * 2 <= maxWidth)
+		return text;
+
+	// byte offsets of the grapheme clusters and the end of the text
+	const auto& str = text.getString ();
+	std::vector<size_t> boundaries;
+	size_t index = 0;
+	for (auto it = text.begin (), end = text.end (); it != end; ++it, ++index)
+	{
+		if (index == 0 || layout->isClusterBoundary (index))
+			boundaries.push_back (static_cast<size_t> (std::distance (str.begin (), it.base ())));
+	}
+	boundaries.push_back (str.size ());
+	layout = nullptr;
+
+	auto makeCandidate = [&] (size_t boundary) {
+		if (mode == kTextTruncateHead)
+			return UTF8String (".." + str.substr (boundaries[boundary]));
+		return UTF8String (str.substr (0, boundaries[boundary]) + "..");
+	};
+	auto fits = [&] (size_t boundary) {
+		return getTextLayoutWidth (painter, makeCandidate (boundary)) + textInset.x * 2 <=
+		       maxWidth;
+	};
+
+	// the width of the candidates grows with the number of kept clusters, so search for the
+	// longest candidate which fits with a binary search
+	auto lastBoundary = boundaries.size () - 1;
+	size_t result = mode == kTextTruncateHead ? lastBoundary : 0;
+	size_t low = mode == kTextTruncateHead ? 1 : 0;
+	size_t high = mode == kTextTruncateHead ? lastBoundary : lastBoundary - 1;
+	while (low <= high)
 	{
-		std::string truncatedText;
-		UTF8String result;
-		auto left = text.begin ();
-		auto right = text.end ();
-		while (width > maxWidth && left != right)
+		auto mid = low + (high - low) / 2;
+		if (fits (mid))
 		{
+			result = mid;
 			if (mode == kTextTruncateHead)
 			{
-				++left;
-				truncatedText = "..";
+				if (mid == low)
+					break;
+				high = mid - 1;
 			}
-			else if (mode == kTextTruncateTail)
-			{
-				--right;
-				truncatedText = "";
-			}
-
-			truncatedText += {left.base (), right.base ()};
-
-			if (mode == kTextTruncateTail)
-				truncatedText += "..";
-
-			result = truncatedText;
-			width = painter->getStringWidth (nullptr, result.getPlatformString (), true);
-			width += textInset.x * 2;
+			else
+				low = mid + 1;
+		}
+		else if (mode == kTextTruncateHead)
+			low = mid + 1;
+		else
+		{
+			if (mid == low)
+				break;
+			high = mid - 1;
 		}
-		if (left == right && flags & kReturnEmptyIfTruncationIsPlaceholderOnly)
-			result = "";
-		return result;
 	}
-	return text;
+	auto placeholderOnly = mode == kTextTruncateHead ? result == lastBoundary : result == 0;
+	if (placeholderOnly && flags & kReturnEmptyIfTruncationIsPlaceholderOnly)
+		return "";
+	return makeCandidate (result);
 }
 
 //------------------------------------------------------------------------
@@ -4,8 +4,12 @@
 
 #include "cfont.h"
 #include "cstring.h"
+#include "cpoint.h"
 #include "platform/platformfactory.h"
 #include "platform/iplatformfont.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 namespace VSTGUI {
 
@@ -110,13 +114,18 @@ void CFontDesc::cleanup ()
 	kNormalFontSmaller = nullptr;
 	kNormalFontVerySmall = nullptr;
 	kSymbolFont = nullptr;
+
+	PlatformFontCache::clear ();
 }
 
 //-----------------------------------------------------------------------------
 // CFontDesc Implementation
 /*! @class CFontDesc
 The CFontDesc class replaces the old font handling. You have now the possibilty to use whatever font you like
-as long as it is available on the system. You should cache your own CFontDesc as this speeds up drawing on some systems.
+as long as it is available on the system.
+
+\note New in 4.14: The platform fonts are shared via the PlatformFontCache between all CFontDesc instances with
+the same name, size and style.
 
 \note New in 4.9: It's now possible to use custom fonts. Fonts must reside inside the Bundle/Package at PackageRoot/Resources/Fonts/.
 */
@@ -154,7 +163,7 @@ void CFontDesc::beforeDelete ()
 auto CFontDesc::getPlatformFont () const -> const PlatformFontPtr
 {
 	if (platformFont == nullptr)
-		platformFont = getPlatformFactory ().createFont (name, size, style);
+		platformFont = PlatformFontCache::getFont (name, size, style);
 	return platformFont;
 }
 
@@ -218,4 +227,197 @@ bool CFontDesc::operator == (const CFontDesc& f) const
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// IFontPainter Implementation
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+/** text layout for font painters without native text layouts, measures the string once */
+class FontPainterTextLayout : public IPlatformTextLayout
+{
+public:
+	FontPainterTextLayout (const IFontPainter* painter,
+						   const PlatformGraphicsDeviceContextPtr& context,
+						   IPlatformString* string, bool antialias)
+	: painter (painter), context (context), string (string), antialias (antialias)
+	{
+	}
+
+	CCoord getWidth () const override
+	{
+		if (width < 0.)
+			width = painter->getStringWidth (context, string, antialias);
+		return width;
+	}
+	bool isClusterBoundary (size_t index) const override { return true; }
+	CCoord getCharacterOffset (size_t index) const override { return -1.; }
+	void draw (const PlatformGraphicsDeviceContextPtr& context, const CPoint& p,
+			   const CColor& color) const override
+	{
+		painter->drawString (context, string, p, color, antialias);
+	}
+
+private:
+	const IFontPainter* painter;
+	PlatformGraphicsDeviceContextPtr context;
+	PlatformStringPtr string;
+	mutable CCoord width {-1.};
+	bool antialias;
+};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+PlatformTextLayoutPtr IFontPainter::createTextLayout (
+	const PlatformGraphicsDeviceContextPtr& context, IPlatformString* string, bool antialias) const
+{
+	if (!string)
+		return nullptr;
+	return makeOwned<FontPainterTextLayout> (this, context, string, antialias);
+}
+
+//-----------------------------------------------------------------------------
+// PlatformFontCache Implementation
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+struct FontCacheKey
+{
+	std::string name;
+	CCoord size;
+	int32_t style;
+
+	bool operator== (const FontCacheKey& o) const
+	{
+		return size == o.size && style == o.style && name == o.name;
+	}
+};
+
+//-----------------------------------------------------------------------------
+struct FontCacheKeyHash
+{
+	size_t operator() (const FontCacheKey& key) const
+	{
+		auto h = std::hash<std::string> {}(key.name);
+		h ^= std::hash<double> {}(key.size) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		h ^= std::hash<int32_t> {}(key.style) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		return h;
+	}
+};
+
+//-----------------------------------------------------------------------------
+struct FontCache
+{
+	using Map = std::unordered_map<FontCacheKey, PlatformFontPtr, FontCacheKeyHash>;
+
+	std::mutex mutex;
+	Map map;
+	size_t maxNumFonts {PlatformFontCache::kDefaultMaxNumFonts};
+	PlatformFontCache::Statistics stats;
+
+	static FontCache& instance ()
+	{
+		static FontCache gInstance;
+		return gInstance;
+	}
+
+	static bool isUnused (const Map::value_type& entry)
+	{
+		return entry.second->getNbReference () == 1;
+	}
+
+	size_t releaseUnused ()
+	{
+		size_t numReleased = 0;
+		for (auto it = map.begin (); it != map.end ();)
+		{
+			if (isUnused (*it))
+			{
+				it = map.erase (it);
+				++numReleased;
+			}
+			else
+				++it;
+		}
+		stats.released += numReleased;
+		return numReleased;
+	}
+};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+PlatformFontPtr PlatformFontCache::getFont (const UTF8String& name, const CCoord& size,
+											int32_t style)
+{
+	FontCacheKey key {name.getString (), size, style};
+
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	auto it = cache.map.find (key);
+	if (it != cache.map.end ())
+	{
+		++cache.stats.hits;
+		return it->second;
+	}
+	++cache.stats.misses;
+	auto font = getPlatformFactory ().createFont (name, size, style);
+	if (!font)
+		return nullptr;
+	if (cache.map.size () >= cache.maxNumFonts)
+		cache.releaseUnused ();
+	cache.map.emplace (std::move (key), font);
+	return font;
+}
+
+//-----------------------------------------------------------------------------
+size_t PlatformFontCache::trim ()
+{
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	return cache.releaseUnused ();
+}
+
+//-----------------------------------------------------------------------------
+void PlatformFontCache::clear ()
+{
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	cache.map.clear ();
+}
+
+//-----------------------------------------------------------------------------
+void PlatformFontCache::setMaxNumFonts (size_t num)
+{
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	cache.maxNumFonts = num;
+	if (cache.map.size () > num)
+		cache.releaseUnused ();
+}
+
+//-----------------------------------------------------------------------------
+size_t PlatformFontCache::getMaxNumFonts ()
+{
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	return cache.maxNumFonts;
+}
+
+//-----------------------------------------------------------------------------
+auto PlatformFontCache::getStatistics () -> Statistics
+{
+	auto& cache = FontCache::instance ();
+	std::lock_guard<std::mutex> guard (cache.mutex);
+	auto result = cache.stats;
+	result.numFonts = cache.map.size ();
+	result.numUnusedFonts = static_cast<size_t> (
+		std::count_if (cache.map.begin (), cache.map.end (), FontCache::isUnused));
+	return result;
+}
+
 } // VSTGUI
@@ -61,6 +61,55 @@ protected:
 	mutable PlatformFontPtr platformFont;
 };
 
+//-----------------------------------------------------------------------------
+/** Process wide cache of platform fonts
+ *
+ *	All CFontDesc instances with the same name, size and style share one platform font. The cache
+ *	holds one reference to every font it created, fonts which are only referenced by the cache are
+ *	unused and are released by trim () or when the number of cached fonts exceeds the limit.
+ *
+ *	The limit is not a hard limit: if all cached fonts are in use when a new font is added, the
+ *	cache grows beyond it. Releasing a CFontDesc does not shrink the cache, its unused platform
+ *	font stays cached until the next font is added while the cache is full or trim () is called.
+ *
+ *	The cache is thread safe.
+ *
+ *	@ingroup new_in_4_14
+ */
+class PlatformFontCache
+{
+public:
+	struct Statistics
+	{
+		uint64_t hits {0};
+		uint64_t misses {0};
+		uint64_t released {0};
+		size_t numFonts {0};
+		size_t numUnusedFonts {0};
+	};
+
+	/** get the shared platform font, creates it via the platform factory if not cached */
+	static PlatformFontPtr getFont (const UTF8String& name, const CCoord& size, int32_t style);
+	/** release all fonts which are not used outside of the cache
+	 *
+	 *	@return the number of released fonts
+	 */
+	static size_t trim ();
+	/** remove all fonts from the cache, fonts still in use are released by their users */
+	static void clear ();
+	/** set the number of fonts after which unused fonts are released when a new font is added,
+	 *	fonts which are still in use are kept even if the cache is larger than this
+	 */
+	static void setMaxNumFonts (size_t num);
+	/** get the number of fonts after which unused fonts are released */
+	static size_t getMaxNumFonts ();
+	/** get the current statistics */
+	static Statistics getStatistics ();
+
+	/** the default number of fonts after which unused fonts are released */
+	static constexpr size_t kDefaultMaxNumFonts = 128;
+};
+
 //-----------------------------------------------------------------------------
 // Global fonts
 //-----------------------------------------------------------------------------
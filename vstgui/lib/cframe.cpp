@@ -8,6 +8,7 @@
 #include "coffscreencontext.h"
 #include "ctooltipsupport.h"
 #include "cinvalidrectlist.h"
+#include "drawprofiler.h"
 #include "itouchevent.h"
 #include "iscalefactorchangedlistener.h"
 #include "idatapackage.h"
@@ -203,7 +204,7 @@ void CFrame::close ()
 //-----------------------------------------------------------------------------
 bool CFrame::open (void* systemWin, PlatformType systemWindowType, IPlatformFrameConfig* config)
 {
-	if (!systemWin || isAttached ())
+	if ((!systemWin && systemWindowType != PlatformType::kHeadless) || isAttached ())
 		return false;
 
 	pImpl->platformFrame = getPlatformFactory ().createFrame (this, getViewSize (), systemWin,
@@ -234,7 +235,7 @@ bool CFrame::attached (CView* parent)
 	{
 		setParentView (nullptr);
 
-		for (const auto& pV : getChildren ())
+		for (const auto& pV : getChildViews ())
 			pV->attached (this);
 		
 		return true;
@@ -1501,7 +1502,7 @@ void CFrame::scrollRect (const CRect& src, const CPoint& distance)
 //-----------------------------------------------------------------------------
 void CFrame::invalidate (const CRect &rect)
 {
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		CRect rectView = pV->getViewSize ();
 		if (rect.rectOverlap (rectView))
@@ -1509,6 +1510,16 @@ void CFrame::invalidate (const CRect &rect)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void CFrame::invalid ()
+{
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	DrawProfiler::InvalidationOrigin profilerOrigin (this, VSTGUI_DRAW_PROFILER_CALL_SITE);
+#endif
+	invalidRect (getViewSize ());
+	setDirty (false);
+}
+
 //-----------------------------------------------------------------------------
 void CFrame::invalidRect (const CRect& rect)
 {
@@ -1518,6 +1529,9 @@ void CFrame::invalidRect (const CRect& rect)
 	CRect _rect (rect);
 	getTransform ().transform (_rect);
 	_rect.makeIntegral ();
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	DrawProfiler::instance ().recordInvalidation (this, _rect, VSTGUI_DRAW_PROFILER_CALL_SITE);
+#endif
 	if (pImpl->collectInvalidRects)
 		pImpl->collectInvalidRects->addRect (_rect);
 	else
@@ -1664,11 +1678,23 @@ IPlatformFrame* CFrame::getPlatformFrame () const
 void CFrame::platformDrawRects (const PlatformGraphicsDeviceContextPtr& context, double scaleFactor,
 								const std::vector<CRect>& rects)
 {
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	DrawProfiler::FrameScope profilerScope;
+#endif
 	CDrawContext drawContext (context, getViewSize (), scaleFactor);
 	for (auto rect : rects)
 		drawRect (&drawContext, rect);
 }
 
+//-----------------------------------------------------------------------------
+bool CFrame::platformPrepareConcurrentDraw (const CRect& rect)
+{
+	// the focus drawing remembers the last drawn focus rect
+	if (focusDrawingEnabled () && getFocusView ())
+		return false;
+	return prepareConcurrentDraw (rect);
+}
+
 //-----------------------------------------------------------------------------
 void CFrame::platformOnEvent (Event& event)
 {
@@ -205,7 +205,7 @@ public:
 	void onStartLocalEventLoop ();
 	bool performDrag (const DragDescription& desc, const SharedPointer<IDragCallback>& callback);
 
-	void invalid () override { invalidRect (getViewSize ()); setDirty (false); }
+	void invalid () override;
 	void invalidRect (const CRect& rect) override;
 
 	bool removeView (CView* pView, bool withForget = true) override;
@@ -260,6 +260,7 @@ protected:
 	// platform frame
 	void platformDrawRects (const PlatformGraphicsDeviceContextPtr& context, double scaleFactor,
 							const std::vector<CRect>& rects) override;
+	bool platformPrepareConcurrentDraw (const CRect& rect) override;
 	void platformOnEvent (Event& event) override;
 	DragOperation platformOnDragEnter (DragEventData data) override;
 	DragOperation platformOnDragMove (DragEventData data) override;
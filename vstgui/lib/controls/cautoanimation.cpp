@@ -256,6 +256,7 @@ void CAutoAnimation::nextPixmap ()
 	value += (float)heightOfOneImage;
 	if (value >= (totalHeightOfBitmap - heightOfOneImage))
 		value = 0;
+	markValueDirty ();
 #endif
 }
 
@@ -277,6 +278,7 @@ void CAutoAnimation::previousPixmap ()
 	value -= (float)heightOfOneImage;
 	if (value < 0.f)
 		value = (float)(totalHeightOfBitmap - heightOfOneImage - 1);
+	markValueDirty ();
 #endif
 }
 
@@ -220,7 +220,11 @@ void CControl::endEdit ()
 }
 
 //------------------------------------------------------------------------
-void CControl::setValue (float val) { value = clamp (val, getMin (), getMax ()); }
+void CControl::setValue (float val)
+{
+	value = clamp (val, getMin (), getMax ());
+	markValueDirty ();
+}
 
 //------------------------------------------------------------------------
 void CControl::setValueNormalized (float val)
@@ -228,6 +232,7 @@ void CControl::setValueNormalized (float val)
 	if (getRange () == 0.f)
 	{
 		value = getMin ();
+		markValueDirty ();
 		return;
 	}
 	val = clampNorm (val);
@@ -246,6 +251,7 @@ float CControl::getValueNormalized () const
 //------------------------------------------------------------------------
 void CControl::valueChanged ()
 {
+	markValueDirty ();
 	if (listener)
 		listener->valueChanged (this);
 	impl->subListeners.forEach ([this] (IControlListener* l) { l->valueChanged (this); });
@@ -262,6 +268,9 @@ bool CControl::isDirty () const
 //------------------------------------------------------------------------
 void CControl::setDirty (bool val)
 {
+	// the old value was set before, see CViewContainer::prepareConcurrentDraw
+	if (isDrawingConcurrently ())
+		return;
 	CView::setDirty (val);
 	if (val)
 	{
@@ -275,7 +284,23 @@ void CControl::setDirty (bool val)
 }
 
 //------------------------------------------------------------------------
-void CControl::bounceValue () { value = clamp (value, getMin (), getMax ()); }
+void CControl::bounceValue ()
+{
+	value = clamp (value, getMin (), getMax ());
+	markValueDirty ();
+}
+
+//------------------------------------------------------------------------
+void CControl::markValueDirty ()
+{
+	if (value == getOldValue ())
+		return;
+	if (auto parent = getParentView ())
+	{
+		if (auto container = parent->asViewContainer ())
+			container->markSubtreeDirty ();
+	}
+}
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
 //------------------------------------------------------------------------
@@ -120,6 +120,14 @@ protected:
 	~CControl () noexcept override;
 	VSTGUI_DEPRECATED (static int32_t mapVstKeyModifier (int32_t vstModifier);)
 
+	/** marks the subtree of the parent container dirty if the value differs from the drawn value.
+	 *	Subclasses which change value directly without calling setValue or valueChanged must call
+	 *	this, or declare it via setHasUntrackedDirtyState.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void markValueDirty ();
+
 	IControlListener* listener;
 	int32_t  tag;
 	float value;
@@ -8,6 +8,8 @@
 #include "../cstring.h"
 #include "../cgraphicspath.h"
 #include "../cdrawcontext.h"
+#include "../platform/iplatformfont.h"
+#include <cmath>
 #include <string>
 
 namespace VSTGUI {
@@ -177,23 +179,39 @@ void CParamDisplay::draw (CDrawContext *pContext)
 	if (hasBit (style, kNoDrawStyle))
 		return;
 
-	std::string string;
+	const auto& string = getValueString ();
 
-	bool converted = false;
+	drawBack (pContext);
+	drawPlatformText (pContext, string);
+	setDirty (false);
+}
+
+//------------------------------------------------------------------------
+const UTF8String& CParamDisplay::getValueString ()
+{
+	auto& cache = valueStringCache;
 	if (valueToStringFunction)
-		converted = valueToStringFunction (value, string, this);
-	if (!converted)
 	{
-		char tmp[255];
-		char precisionStr[10];
-		snprintf (precisionStr, 10, "%%.%hhuf", valuePrecision);
-		snprintf (tmp, 255, precisionStr, value);
-		string = tmp;
+		cache.buffer.clear ();
+		if (valueToStringFunction (value, cache.buffer, this))
+		{
+			cache.formatted = false;
+			if (cache.buffer != cache.string)
+				cache.string = cache.buffer;
+			return cache.string;
+		}
 	}
-
-	drawBack (pContext);
-	drawPlatformText (pContext, UTF8String (string));
-	setDirty (false);
+	if (!cache.formatted || cache.value != value || std::signbit (cache.value) != std::signbit (value) ||
+		cache.precision != valuePrecision)
+	{
+		char buffer[320];
+		auto length = formatNumber (buffer, buffer + sizeof (buffer), value, valuePrecision);
+		cache.string = UTF8String::StringType (buffer, length);
+		cache.value = value;
+		cache.precision = valuePrecision;
+		cache.formatted = true;
+	}
+	return cache.string;
 }
 
 //------------------------------------------------------------------------
@@ -346,18 +364,18 @@ void CParamDisplay::drawPlatformText (CDrawContext* pContext, const UTF8String&
 			pContext->setDrawMode (kAntiAliasing);
 			pContext->setFont (fontID);
 
+			auto layout = pContext->createTextLayout (string.getPlatformString (),
+													  hasBit (style, kAntialias));
 			// draw darker text (as shadow)
 			if (hasBit (style, kShadowText))
 			{
 				CRect newSize (textRect);
 				newSize.offset (shadowTextOffset);
 				pContext->setFontColor (shadowColor);
-				pContext->drawString (string.getPlatformString (), newSize, horiTxtAlign,
-									  hasBit (style, kAntialias));
+				pContext->drawTextLayout (layout, newSize, horiTxtAlign);
 			}
 			pContext->setFontColor (fontColor);
-			pContext->drawString (string.getPlatformString (), textRect, horiTxtAlign,
-								  hasBit (style, kAntialias));
+			pContext->drawTextLayout (layout, textRect, horiTxtAlign);
 		});
 		pContext->restoreGlobalState ();
 	}
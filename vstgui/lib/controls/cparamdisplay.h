@@ -128,6 +128,14 @@ protected:
 
 	virtual void drawStyleChanged ();
 
+	/** the string shown for the current value
+	 *
+	 *	The string is only formatted again if the value or the precision changed, the string of the
+	 *	value to string function is only copied if it differs from the last one.
+	 *	@ingroup new_in_4_14
+	 */
+	const UTF8String& getValueString ();
+
 	ValueToStringFunction2 valueToStringFunction;
 
 	enum StylePrivate {
@@ -149,6 +157,17 @@ protected:
 	CCoord		roundRectRadius;
 	CCoord		frameWidth;
 	double		textRotation;
+
+private:
+	struct ValueStringCache
+	{
+		UTF8String string;
+		std::string buffer;
+		float value {0.f};
+		uint8_t precision {0};
+		bool formatted {false};
+	};
+	ValueStringCache valueStringCache;
 };
 
 } // VSTGUI
@@ -163,6 +163,7 @@ void CSplashScreen::valueChanged (CControl *pControl)
 void CSplashScreen::unSplash ()
 {
 	value = getMin ();
+	markValueDirty ();
 
 	if (auto frame = getFrame ())
 	{
@@ -235,6 +236,7 @@ CMouseEventResult CAnimationSplashScreen::onMouseDown (CPoint& where, const CBut
 void CAnimationSplashScreen::unSplash ()
 {
 	value = getMin ();
+	markValueDirty ();
 
 	if (auto frame = getFrame ())
 	{
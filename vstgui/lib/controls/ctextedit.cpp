@@ -120,11 +120,9 @@ void CTextEdit::setValue (float val)
 		converted = valueToStringFunction (getValue (), string, this);
 	if (!converted)
 	{
-		char tmp[255];
-		char precisionStr[10];
-		snprintf (precisionStr, 10, "%%.%hhuf", valuePrecision);
-		snprintf (tmp, 255, precisionStr, getValue ());
-		string = tmp;
+		char tmp[320];
+		auto length = formatNumber (tmp, tmp + sizeof (tmp), getValue (), valuePrecision);
+		string.assign (tmp, length);
 	}
 
 	if (converted)
@@ -6,6 +6,7 @@
 #include "../platform/iplatformfont.h"
 #include "../cdrawmethods.h"
 #include "../cdrawcontext.h"
+#include <algorithm>
 #include <sstream>
 
 namespace VSTGUI {
@@ -118,7 +119,8 @@ bool CTextLabel::sizeToFit ()
 {
 	if (fontID == nullptr || fontID->getPlatformFont () == nullptr || fontID->getPlatformFont ()->getPainter () == nullptr)
 		return false;
-	CCoord width = fontID->getPlatformFont ()->getPainter ()->getStringWidth (nullptr, text.getPlatformString (), true);
+	auto layout = fontID->getPlatformFont ()->getPainter ()->createTextLayout (nullptr, text.getPlatformString ());
+	CCoord width = layout ? layout->getWidth () : 0.;
 	if (width > 0)
 	{
 		width += (getTextInset ().x * 2.);
@@ -201,6 +203,18 @@ void CMultiLineTextLabel::setLineLayout (LineLayout layout)
 	lines.clear ();
 }
 
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::setAntialias (bool state)
+{
+	if (getAntialias () == state)
+		return;
+	CTextLabel::setAntialias (state);
+	// the cached layouts were shaped with the previous antialias state
+	paragraphs.clear ();
+	paragraphsFont = nullptr;
+	lines.clear ();
+}
+
 //------------------------------------------------------------------------
 void CMultiLineTextLabel::setAutoHeight (bool state)
 {
@@ -210,7 +224,7 @@ void CMultiLineTextLabel::setAutoHeight (bool state)
 	if (autoHeight && isAttached ())
 	{
 		if (lines.empty ())
-			recalculateLines (nullptr);
+			recalculateLines ();
 		recalculateHeight ();
 	}
 }
@@ -228,7 +242,7 @@ void CMultiLineTextLabel::setVerticalCentered (bool state)
 CCoord CMultiLineTextLabel::getMaxLineWidth ()
 {
 	if (lines.empty () && getText ().empty () == false)
-		recalculateLines (nullptr);
+		recalculateLines ();
 	CCoord maxWidth {};
 	for (const auto& line : lines)
 	{
@@ -241,8 +255,12 @@ CCoord CMultiLineTextLabel::getMaxLineWidth ()
 //------------------------------------------------------------------------
 void CMultiLineTextLabel::drawRect (CDrawContext* pContext, const CRect& updateRect)
 {
+	// the antialias state may also change via setStyle or by subclasses writing the style directly
+	if (paragraphsFont &&
+	    (paragraphsFont != getFont ()->getPlatformFont () || paragraphsAntialias != getAntialias ()))
+		lines.clear ();
 	if (getText ().empty () == false && lines.empty ())
-		recalculateLines (pContext);
+		recalculateLines ();
 	drawBack (pContext);
 	
 	CRect newClip (updateRect);
@@ -257,26 +275,32 @@ void CMultiLineTextLabel::drawRect (CDrawContext* pContext, const CRect& updateR
 
 	CDrawContext::Transform t (*pContext, CGraphicsTransform ().translate (getViewSize ().getTopLeft ()));
 
-	if (style & kShadowText)
+	std::vector<const Line*> visibleLines;
+	for (auto& line : lines)
 	{
-		CDrawContext::Transform t2 (*pContext, CGraphicsTransform ().translate (shadowTextOffset));
-		pContext->setFontColor (getShadowColor ());
-		for (const auto& line : lines)
+		if (line.r.rectOverlap (newClip))
 		{
-			if (line.r.rectOverlap (newClip))
-				pContext->drawString (line.str.getPlatformString (), line.r, getHoriAlign (), getAntialias ());
+			if (!line.layout)
+				line.layout =
+				    pContext->createTextLayout (line.str.getPlatformString (), getAntialias ());
+			visibleLines.emplace_back (&line);
 		}
+		else if (line.r.bottom > newClip.bottom)
+			break;
 	}
 
-	pContext->setFontColor (getFontColor ());
-	for (const auto& line : lines)
+	if (style & kShadowText)
 	{
-		if (line.r.rectOverlap (newClip))
-			pContext->drawString (line.str.getPlatformString (), line.r, getHoriAlign (), getAntialias ());
-		else if (line.r.bottom > newClip.bottom)
-			break;
+		CDrawContext::Transform t2 (*pContext, CGraphicsTransform ().translate (shadowTextOffset));
+		pContext->setFontColor (getShadowColor ());
+		for (const auto& line : visibleLines)
+			pContext->drawTextLayout (line->layout, line->r, getHoriAlign ());
 	}
 
+	pContext->setFontColor (getFontColor ());
+	for (const auto& line : visibleLines)
+		pContext->drawTextLayout (line->layout, line->r, getHoriAlign ());
+
 	setDirty (false);
 }
 
@@ -295,7 +319,7 @@ void CMultiLineTextLabel::setText (const UTF8String& txt)
 	lines.clear ();
 	if (autoHeight && isAttached ())
 	{
-		recalculateLines (nullptr);
+		recalculateLines ();
 		recalculateHeight ();
 	}
 }
@@ -323,9 +347,12 @@ void CMultiLineTextLabel::setViewSize (const CRect& rect, bool invalid)
 	normRect.originize ();
 	if (viewSize != normRect)
 	{
-		if (lineLayout != LineLayout::clip ||
-		    (lineLayout == LineLayout::clip &&
-		     viewSize.getHeight () != normRect.getHeight ()))
+		// only wrapped and truncated lines depend on the width. The shaped paragraphs are kept, so
+		// that the lines are re-wrapped without measuring the text again.
+		auto widthChanged = viewSize.getWidth () != normRect.getWidth ();
+		auto heightChanged = viewSize.getHeight () != normRect.getHeight ();
+		if ((widthChanged && lineLayout != LineLayout::clip) ||
+		    (heightChanged && (verticalCentered || lineLayout == LineLayout::clip)))
 		{
 			lines.clear ();
 		}
@@ -363,55 +390,126 @@ inline bool isLineBreakSeparator (char32_t c)
 }
 
 //------------------------------------------------------------------------
-void CMultiLineTextLabel::calculateWrapLine  (CDrawContext* context,
-                                       std::pair<UTF8String, double>& element,
-                                       const IFontPainter* const& fontPainter, double lineHeight,
-                                       double lineWidth, double maxWidth, const CPoint& textInset,
-                                       CCoord& y)
+inline bool isRightToLeftCharacter (char32_t c)
 {
-	auto start = element.first.begin ();
+	return (c >= 0x0590 && c <= 0x08FF) || // Hebrew, Arabic, Syriac, Thaana, NKo, ...
+		   (c >= 0xFB1D && c <= 0xFDFF) || // Hebrew and Arabic presentation forms
+		   (c >= 0xFE70 && c <= 0xFEFF) || // Arabic presentation forms B
+		   (c >= 0x10800 && c <= 0x10FFF) || (c >= 0x1E800 && c <= 0x1EFFF) ||
+		   c == 0x200F || c == 0x202B || c == 0x202E || c == 0x2067; // RLM, RLE, RLO, RLI
+}
+
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::calculateWrapLine (const Paragraph& paragraph,
+											 const IFontPainter* fontPainter, double lineHeight,
+											 double lineWidth, double maxWidth,
+											 const CPoint& textInset, CCoord& y)
+{
+	using Iterator = UTF8String::CodePointIterator;
+	// the width of the characters from start to end, taken from the character offsets of the
+	// paragraph layout if supported and the text is left-to-right only, otherwise the characters
+	// are measured
+	auto getWidth = [&] (Iterator start, size_t startIndex, Iterator end, size_t endIndex) {
+		if (paragraph.layout && !paragraph.rightToLeft)
+		{
+			auto startOffset = paragraph.layout->getCharacterOffset (startIndex);
+			auto endOffset = paragraph.layout->getCharacterOffset (endIndex);
+			if (startOffset >= 0. && endOffset >= 0.)
+				return endOffset - startOffset;
+		}
+		UTF8String tmp ({start.base (), end.base ()});
+		auto layout =
+			fontPainter->createTextLayout (nullptr, tmp.getPlatformString (), getAntialias ());
+		return layout ? layout->getWidth () : 0.;
+	};
+
+	const auto& str = paragraph.str;
+	auto start = str.begin ();
 	auto lastSeparator = start;
 	auto pos = start;
-	while (pos != element.first.end () && *pos != 0)
+	size_t startIndex = 0;
+	size_t lastSeparatorIndex = 0;
+	size_t posIndex = 0;
+	while (pos != str.end () && *pos != 0)
 	{
 		if (isspace (*pos))
+		{
 			lastSeparator = pos;
+			lastSeparatorIndex = posIndex;
+		}
 		else if (isLineBreakSeparator (*pos))
+		{
 			lastSeparator = ++pos;
-		if (pos == element.first.end ())
+			lastSeparatorIndex = ++posIndex;
+		}
+		if (pos == str.end ())
 			break;
 		auto tmpEnd = pos;
-		UTF8String tmp ({start.base (), (++tmpEnd).base ()});
-		auto width = fontPainter->getStringWidth (
-			context ? context->getPlatformDeviceContext () : nullptr, tmp.getPlatformString ());
+		auto width = getWidth (start, startIndex, ++tmpEnd, posIndex + 1);
 		if (width > maxWidth)
 		{
-			if (lastSeparator == element.first.end ())
-				lastSeparator = pos;
-			if (start == lastSeparator)
+			if (lastSeparator == str.end () || start == lastSeparator)
+			{
 				lastSeparator = pos;
+				lastSeparatorIndex = posIndex;
+			}
 			lines.emplace_back (
 			    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
 			          UTF8String ({start.base (), lastSeparator.base ()})});
 			y += lineHeight;
 			pos = lastSeparator;
+			posIndex = lastSeparatorIndex;
 			start = pos;
+			startIndex = posIndex;
 			if (isspace (*start))
+			{
 				++start;
-			lastSeparator = element.first.end ();
+				++startIndex;
+			}
+			lastSeparator = str.end ();
 		}
 		++pos;
+		++posIndex;
 	}
-	if (start != element.first.end ())
+	if (start != str.end ())
 	{
 		lines.emplace_back (Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
-		                          UTF8String ({start.base (), element.first.end ().base ()})});
+		                          UTF8String ({start.base (), str.end ().base ()})});
 		y += lineHeight;
 	}
 }
 
 //------------------------------------------------------------------------
-void CMultiLineTextLabel::recalculateLines (CDrawContext* context)
+void CMultiLineTextLabel::updateParagraphs ()
+{
+	const auto& font = getFont ()->getPlatformFont ();
+	if (paragraphsFont == font && paragraphsText == getText () &&
+	    paragraphsAntialias == getAntialias ())
+		return;
+
+	paragraphs.clear ();
+	paragraphsText = getText ();
+	paragraphsFont = font;
+	paragraphsAntialias = getAntialias ();
+
+	const auto& fontPainter = getFont ()->getFontPainter ();
+	std::stringstream stream (getText ().getString ());
+	std::string line;
+	while (std::getline (stream, line, '\n'))
+	{
+		UTF8String str (std::move (line));
+		// created without a context, the layouts are drawn into any context later
+		auto layout =
+			fontPainter->createTextLayout (nullptr, str.getPlatformString (), getAntialias ());
+		auto width = layout ? layout->getWidth () : 0.;
+		auto rightToLeft = std::any_of (str.begin (), str.end (), isRightToLeftCharacter);
+		paragraphs.emplace_back (
+			Paragraph {std::move (str), std::move (layout), width, rightToLeft});
+	}
+}
+
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::recalculateLines ()
 {
 	const auto& font = getFont ()->getPlatformFont ();
 	const auto& fontPainter = getFont ()->getFontPainter ();
@@ -423,48 +521,44 @@ void CMultiLineTextLabel::recalculateLines (CDrawContext* context)
 	const auto& textInset = getTextInset ();
 	auto maxWidth = getWidth () - (textInset.x * 2);
 
-	std::vector<std::pair<UTF8String, CCoord>> elements;
-	std::stringstream stream (getText ().getString ());
-	std::string line;
-	while (std::getline (stream, line, '\n'))
-	{
-		UTF8String str (std::move (line));
-		auto width = fontPainter->getStringWidth (
-			context ? context->getPlatformDeviceContext () : nullptr, str.getPlatformString ());
-		elements.emplace_back (std::move (str), width);
-	}
+	updateParagraphs ();
 
 	CCoord y = textInset.y;
 
 	auto lineWidth = getWidth () - textInset.x;
 	
-	for (auto& element : elements)
+	for (const auto& paragraph : paragraphs)
 	{
 		if (lineLayout == LineLayout::clip)
 		{
 			lines.emplace_back (Line {
-			    CRect (textInset.x, y, element.second + textInset.x, y + lineHeight + textInset.y),
-			    std::move (element.first)});
+			    CRect (textInset.x, y, paragraph.width + textInset.x, y + lineHeight + textInset.y),
+			    paragraph.str, paragraph.layout});
 		}
 		else
 		{
-			if (element.second > maxWidth)
+			if (paragraph.width > maxWidth)
 			{
 				if (lineLayout == LineLayout::truncate)
 				{
-					element.first = CDrawMethods::createTruncatedText (
-					    CDrawMethods::kTextTruncateTail, element.first, fontID, maxWidth);
+					lines.emplace_back (
+					    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
+					          CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail,
+					                                             paragraph.str, fontID, maxWidth)});
 				}
 				else // wrap
 				{
-					calculateWrapLine (context, element, fontPainter, lineHeight, lineWidth,
-					                   maxWidth, textInset, y);
+					calculateWrapLine (paragraph, fontPainter, lineHeight, lineWidth, maxWidth,
+					                   textInset, y);
 					continue;
 				}
 			}
-			lines.emplace_back (
-			    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
-			          std::move (element.first)});
+			else
+			{
+				lines.emplace_back (
+				    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
+				          paragraph.str, paragraph.layout});
+			}
 		}
 		y += lineHeight;
 	}
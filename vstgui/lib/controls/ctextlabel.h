@@ -8,6 +8,7 @@
 #include "itextlabellistener.h"
 #include "../dispatchlist.h"
 #include "../cstring.h"
+#include "../platform/iplatformfont.h"
 
 namespace VSTGUI {
 
@@ -120,11 +121,30 @@ public:
 	void setViewSize (const CRect& rect, bool invalid = true) override;
 	void setTextTruncateMode (TextTruncateMode mode) override;
 	void setValue (float val) override;
+	void setAntialias (bool state) override;
 private:
+	/** a line of the text, shaped once and cached until the text, the font or the antialias
+	 *	state changes
+	 */
+	struct Paragraph
+	{
+		UTF8String str;
+		PlatformTextLayoutPtr layout;
+		CCoord width;
+		/** the text contains right-to-left characters, the character offsets of the layout are
+		 *	visual positions then and cannot be used to measure parts of the text
+		 */
+		bool rightToLeft;
+	};
+	using Paragraphs = std::vector<Paragraph>;
+
 	void drawStyleChanged () override;
-	void calculateWrapLine  (CDrawContext *context, std::pair<UTF8String, double> &element, const IFontPainter *const &fontPainter, double lineHeight, double lineWidth, double maxWidth, const CPoint &textInset, CCoord &y);
-	
-	void recalculateLines (CDrawContext* context);
+	void calculateWrapLine (const Paragraph& paragraph, const IFontPainter* fontPainter,
+							double lineHeight, double lineWidth, double maxWidth,
+							const CPoint& textInset, CCoord& y);
+
+	void updateParagraphs ();
+	void recalculateLines ();
 	void recalculateHeight ();
 	
 	bool autoHeight {false};
@@ -135,9 +155,15 @@ private:
 	{
 		CRect r;
 		UTF8String str;
+		PlatformTextLayoutPtr layout;
 	};
 	using Lines = std::vector<Line>;
 	Lines lines;
+
+	Paragraphs paragraphs;
+	UTF8String paragraphsText;
+	PlatformFontPtr paragraphsFont;
+	bool paragraphsAntialias {true};
 };
 
 } // VSTGUI
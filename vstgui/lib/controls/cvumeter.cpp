@@ -6,6 +6,8 @@
 #include "../coffscreencontext.h"
 #include "../cbitmap.h"
 #include "../cvstguitimer.h"
+#include "../cframe.h"
+#include <algorithm>
 #include <list>
 
 namespace VSTGUI {
@@ -48,6 +50,8 @@ CVuMeter::CVuMeter (const CVuMeter& v)
 , decreaseValue (v.decreaseValue)
 , rectOn (v.rectOn)
 , rectOff (v.rectOff)
+, peakHoldTime (v.peakHoldTime)
+, peakFalloff (v.peakFalloff)
 {
 	setOffBitmap (v.offBitmap);
 	setWantsIdle (true);
@@ -93,17 +97,141 @@ void CVuMeter::setOffBitmap (CBitmap* bitmap)
 		offBitmap->remember ();
 }
 
+//-----------------------------------------------------------------------------
+void CVuMeter::setPeakHoldTime (uint32_t milliseconds)
+{
+	if (peakHoldTime == milliseconds)
+		return;
+	peakHoldTime = milliseconds;
+	resetPeak ();
+	invalid ();
+}
+
+//-----------------------------------------------------------------------------
+void CVuMeter::resetPeak ()
+{
+	if (drawnPeakLed > 0)
+		invalidLedRange (drawnPeakLed - 1, drawnPeakLed);
+	peakValue = getOldValue ();
+	peakTicks = lastIdleTicks;
+}
+
 //------------------------------------------------------------------------
 void CVuMeter::setDirty (bool state)
 {
 	CView::setDirty (state);
 }
 
+//------------------------------------------------------------------------
+bool CVuMeter::isDirty () const
+{
+	// when idle is enabled onIdle invalidates the changed LED segments itself
+	if (wantsIdle ())
+		return CView::isDirty ();
+	return CControl::isDirty ();
+}
+
+//------------------------------------------------------------------------
+int32_t CVuMeter::valueToLedCount (float v) const
+{
+	auto normValue = (v - getMin ()) / getRange ();
+	return std::clamp (static_cast<int32_t> (nbLed * normValue + 0.5f), 0, std::max (nbLed, 0));
+}
+
+//------------------------------------------------------------------------
+/** returns the rect covering the LEDs [fromLed, toLed), LEDs are counted from the left for
+ *	horizontal and from the bottom for vertical meters
+ */
+CRect CVuMeter::getLedRangeRect (int32_t fromLed, int32_t toLed) const
+{
+	if (fromLed > toLed)
+		std::swap (fromLed, toLed);
+	fromLed = std::clamp (fromLed, 0, std::max (nbLed, 0));
+	toLed = std::clamp (toLed, 0, std::max (nbLed, 0));
+
+	CRect r (rectOn);
+	if (!getOnBitmap () || nbLed <= 0)
+		return r;
+	if (style & kHorizontal)
+	{
+		auto width = getOnBitmap ()->getWidth ();
+		r.left = rectOn.left + (CCoord)((fromLed / (float)nbLed) * width);
+		if (toLed < nbLed)
+			r.right = rectOn.left + (CCoord)((toLed / (float)nbLed) * width);
+	}
+	else
+	{
+		auto height = getOnBitmap ()->getHeight ();
+		r.top = rectOn.top + (CCoord)(((nbLed - toLed) / (float)nbLed) * height);
+		if (fromLed > 0)
+			r.bottom = rectOn.top + (CCoord)(((nbLed - fromLed) / (float)nbLed) * height);
+	}
+	return r;
+}
+
+//------------------------------------------------------------------------
+void CVuMeter::invalidLedRange (int32_t fromLed, int32_t toLed)
+{
+	fromLed = std::clamp (fromLed, 0, std::max (nbLed, 0));
+	toLed = std::clamp (toLed, 0, std::max (nbLed, 0));
+	if (fromLed == toLed)
+		return;
+	auto r = getLedRangeRect (fromLed, toLed);
+	r.makeIntegral ();
+	r.bound (getViewSize ());
+	if (!r.isEmpty ())
+		invalidRect (r);
+}
+
+//------------------------------------------------------------------------
+void CVuMeter::updatePeak (float newValue, uint64_t ticks)
+{
+	if (newValue >= peakValue)
+	{
+		peakValue = newValue;
+		peakTicks = ticks;
+		return;
+	}
+	auto falloffStart = peakTicks + peakHoldTime;
+	if (ticks <= falloffStart)
+		return;
+	auto elapsed = ticks - std::max (falloffStart, lastIdleTicks);
+	peakValue = std::max (newValue, peakValue - peakFalloff * (elapsed / 1000.f));
+}
+
 //------------------------------------------------------------------------
 void CVuMeter::onIdle ()
 {
-	if (getOldValue () != value)
-		invalid ();
+	bounceValue ();
+
+	float newValue = getOldValue () - decreaseValue;
+	if (newValue < value)
+		newValue = value;
+	setOldValue (newValue);
+
+	auto ticks = getFrame () ? getFrame ()->getTicks () : lastIdleTicks;
+	if (peakHoldTime > 0)
+		updatePeak (newValue, ticks);
+	lastIdleTicks = ticks;
+
+	if (drawnLedCount < 0)
+	{
+		if (isAttached ())
+			invalid ();
+		return;
+	}
+	auto ledCount = valueToLedCount (newValue);
+	if (ledCount != drawnLedCount)
+		invalidLedRange (drawnLedCount, ledCount);
+	if (peakHoldTime > 0)
+	{
+		auto peakLed = valueToLedCount (peakValue);
+		if (peakLed != drawnPeakLed)
+		{
+			invalidLedRange (drawnPeakLed - 1, drawnPeakLed);
+			invalidLedRange (peakLed - 1, peakLed);
+		}
+	}
 }
 
 //------------------------------------------------------------------------
@@ -118,18 +246,21 @@ void CVuMeter::draw (CDrawContext *_pContext)
 	CPoint pointOff;
 	CDrawContext *pContext = _pContext;
 
-	bounceValue ();
-	
-	float newValue = getOldValue () - decreaseValue;
-	if (newValue < value)
-		newValue = value;
-	setOldValue (newValue);
+	if (!wantsIdle ())
+	{
+		bounceValue ();
+
+		float newValue = getOldValue () - decreaseValue;
+		if (newValue < value)
+			newValue = value;
+		setOldValue (newValue);
+	}
 
-	newValue = (newValue - getMin ()) / getRange (); // normalize
+	auto ledCount = valueToLedCount (getOldValue ());
 	
 	if (style & kHorizontal) 
 	{
-		auto tmp = (CCoord)(((int32_t)(nbLed * newValue + 0.5f) / (float)nbLed) * getOnBitmap ()->getWidth ());
+		auto tmp = (CCoord)((ledCount / (float)nbLed) * getOnBitmap ()->getWidth ());
 		pointOff (tmp, 0);
 
 		_rectOff.left += tmp;
@@ -137,19 +268,43 @@ void CVuMeter::draw (CDrawContext *_pContext)
 	}
 	else 
 	{
-		auto tmp = (CCoord)(((int32_t)(nbLed * (1.f - newValue) + 0.5f) / (float)nbLed) * getOnBitmap ()->getHeight ());
+		auto tmp = (CCoord)(((nbLed - ledCount) / (float)nbLed) * getOnBitmap ()->getHeight ());
 		pointOn (0, tmp);
 
 		_rectOff.bottom = tmp + rectOff.top;
 		_rectOn.top     += tmp;
 	}
 
+	// only draw the parts of the bitmaps inside the dirty region
+	CRect clipRect;
+	pContext->getClipRect (clipRect);
+	auto drawClipped = [&] (CBitmap* bitmap, CRect r, CPoint offset) {
+		auto topLeft = r.getTopLeft ();
+		r.bound (clipRect);
+		if (r.isEmpty ())
+			return;
+		offset += r.getTopLeft () - topLeft;
+		bitmap->draw (pContext, r, offset);
+	};
+
 	if (getOffBitmap ())
 	{
-		getOffBitmap ()->draw (pContext, _rectOff, pointOff);
+		drawClipped (getOffBitmap (), _rectOff, pointOff);
 	}
 
-	getOnBitmap ()->draw (pContext, _rectOn, pointOn);
+	drawClipped (getOnBitmap (), _rectOn, pointOn);
+
+	drawnLedCount = ledCount;
+	drawnPeakLed = -1;
+	if (peakHoldTime > 0)
+	{
+		drawnPeakLed = valueToLedCount (peakValue);
+		if (drawnPeakLed > ledCount)
+		{
+			auto peakRect = getLedRangeRect (drawnPeakLed - 1, drawnPeakLed);
+			drawClipped (getOnBitmap (), peakRect, peakRect.getTopLeft () - rectOn.getTopLeft ());
+		}
+	}
 
 	setDirty (false);
 }
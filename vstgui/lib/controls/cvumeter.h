@@ -48,11 +48,21 @@ public:
 	
 	void setStyle (int32_t newStyle) { style = newStyle; invalid (); }
 	int32_t getStyle () const { return style; }
+
+	/** set the time in milliseconds the peak LED is held before it falls off. 0 disables the peak indicator */
+	void setPeakHoldTime (uint32_t milliseconds);
+	uint32_t getPeakHoldTime () const { return peakHoldTime; }
+	/** set the amount of value units per second the peak LED falls off after the hold time elapsed */
+	void setPeakFalloff (float valuePerSecond) { peakFalloff = valuePerSecond; }
+	float getPeakFalloff () const { return peakFalloff; }
+	float getPeakValue () const { return peakValue; }
+	void resetPeak ();
 	//@}
 
 
 	// overrides
 	void setDirty (bool state) override;
+	bool isDirty () const override;
 	void draw (CDrawContext* pContext) override;
 	void setViewSize (const CRect& newSize, bool invalid = true) override;
 	bool sizeToFit () override;
@@ -62,6 +72,11 @@ public:
 protected:
 	~CVuMeter () noexcept override;	
 
+	int32_t valueToLedCount (float v) const;
+	CRect getLedRangeRect (int32_t fromLed, int32_t toLed) const;
+	void invalidLedRange (int32_t fromLed, int32_t toLed);
+	void updatePeak (float newValue, uint64_t ticks);
+
 	CBitmap* offBitmap;
 	
 	int32_t     nbLed;
@@ -70,6 +85,14 @@ protected:
 
 	CRect    rectOn;
 	CRect    rectOff;
+
+	uint32_t peakHoldTime {0};
+	float peakFalloff {1.f};
+	float peakValue {0.f};
+	uint64_t peakTicks {0};
+	uint64_t lastIdleTicks {0};
+	int32_t drawnLedCount {-1};
+	int32_t drawnPeakLed {-1};
 };
 
 } // VSTGUI
@@ -137,7 +137,7 @@ void CScrollContainer::setScrollOffset (CPoint newOffset, bool redraw)
 		return;
 	offset = newOffset;
 	inScrolling = true;
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		CRect r = pV->getViewSize ();
 		CRect mr = pV->getMouseableArea ();
@@ -182,8 +182,10 @@ bool CScrollContainer::isDirty () const
 {
 	if (CView::isDirty ())
 		return true;
+	if (!isSubtreeDirty () && !hasUntrackedDirtyViews ())
+		return false;
 
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		if (pV->isDirty () && pV->isVisible ())
 		{
@@ -7,9 +7,85 @@
 #include <cstring>
 #include <sstream>
 #include <algorithm>
+#include <charconv>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define VSTGUI_FLOATINGPOINT_CHARCONV 1
+#else
+#define VSTGUI_FLOATINGPOINT_CHARCONV 0
+#endif
 
 namespace VSTGUI {
 
+#if !VSTGUI_FLOATINGPOINT_CHARCONV
+//-----------------------------------------------------------------------------
+static char getLocaleDecimalPoint ()
+{
+	auto lc = std::localeconv ();
+	if (lc && lc->decimal_point && lc->decimal_point[0] && !lc->decimal_point[1])
+		return lc->decimal_point[0];
+	return '.';
+}
+#endif
+
+//-----------------------------------------------------------------------------
+size_t formatNumber (char* first, char* last, double value, uint32_t precision) noexcept
+{
+	if (last <= first)
+		return 0;
+#if VSTGUI_FLOATINGPOINT_CHARCONV
+	auto result = std::to_chars (first, last, value, std::chars_format::fixed,
+								 static_cast<int> (precision));
+	if (result.ec != std::errc ())
+		return 0;
+	return static_cast<size_t> (result.ptr - first);
+#else
+	// snprintf needs room for the null character and uses the decimal point of the C locale
+	auto size = static_cast<size_t> (last - first);
+	auto length = snprintf (first, size, "%.*f", static_cast<int> (precision), value);
+	if (length < 0 || static_cast<size_t> (length) >= size)
+		return 0;
+	auto decimalPoint = getLocaleDecimalPoint ();
+	if (decimalPoint != '.')
+		std::replace (first, first + length, decimalPoint, '.');
+	return static_cast<size_t> (length);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+Optional<double> parseNumber (const char* first, const char* last) noexcept
+{
+	while (first < last && std::isspace (static_cast<unsigned char> (*first)))
+		++first;
+	if (first < last && *first == '+')
+		++first;
+	if (first >= last)
+		return {};
+#if VSTGUI_FLOATINGPOINT_CHARCONV
+	double value;
+	auto result = std::from_chars (first, last, value);
+	if (result.ec != std::errc ())
+		return {};
+	return makeOptional (value);
+#else
+	char buffer[128];
+	auto length = std::min (static_cast<size_t> (last - first), sizeof (buffer) - 1);
+	std::copy (first, first + length, buffer);
+	buffer[length] = 0;
+	auto decimalPoint = getLocaleDecimalPoint ();
+	if (decimalPoint != '.')
+		std::replace (buffer, buffer + length, '.', decimalPoint);
+	char* end = nullptr;
+	auto value = std::strtod (buffer, &end);
+	if (end == buffer)
+		return {};
+	return makeOptional (value);
+#endif
+}
+
 //-----------------------------------------------------------------------------
 double UTF8StringView::toDouble (uint32_t precision) const
 {
@@ -159,6 +159,29 @@ private:
 //-----------------------------------------------------------------------------
 UTF8String trim (const UTF8String& str, TrimOptions options = TrimOptions ().left ().right ());
 
+//-----------------------------------------------------------------------------
+/** write a number with a fixed count of fractional digits to the character range [first, last)
+ *
+ *	The number is always formatted like in the classic "C" locale and no memory is allocated.
+ *	The result is not null terminated.
+ *
+ *	@return number of characters written or zero if the range is too small
+ *	@ingroup new_in_4_14
+ */
+size_t formatNumber (char* first, char* last, double value, uint32_t precision) noexcept;
+
+//-----------------------------------------------------------------------------
+/** parse a number from the character range [first, last)
+ *
+ *	Like a std::istream with the classic "C" locale leading white space and a plus sign are
+ *	skipped and parsing stops at the first character which is not part of the number. No memory
+ *	is allocated.
+ *
+ *	@return the number or nothing if the range does not start with a number
+ *	@ingroup new_in_4_14
+ */
+Optional<double> parseNumber (const char* first, const char* last) noexcept;
+
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
 //-----------------------------------------------------------------------------
 namespace String {
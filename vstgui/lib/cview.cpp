@@ -9,15 +9,16 @@
 #include "cvstguitimer.h"
 #include "cgraphicspath.h"
 #include "dispatchlist.h"
+#include "drawprofiler.h"
 #include "idatapackage.h"
 #include "iviewlistener.h"
-#include "malloc.h"
 #include "events.h"
 #include "animation/animator.h"
 #include "../uidescription/icontroller.h"
 #include "platform/iplatformframe.h"
+#include <array>
 #include <cassert>
-#include <unordered_map>
+#include <vector>
 #if DEBUG
 #include <list>
 #include <typeinfo>
@@ -56,41 +57,163 @@ public:
 #endif // VSTGUI_CHECK_VIEW_RELEASING
 
 //-----------------------------------------------------------------------------
+/** the data of an attribute. Small attributes like pointers are stored inline. */
 class AttributeEntry
 {
 public:
-	AttributeEntry (uint32_t _size, const void* _data)
-	{
-		updateData (_size, _data);
-	}
-	
+	static constexpr uint32_t kInlineSize = 16;
+
+	AttributeEntry () = default;
 	AttributeEntry (const AttributeEntry& me) = delete;
 	AttributeEntry& operator= (const AttributeEntry& me) = delete;
 	AttributeEntry (AttributeEntry&& me) noexcept
 	{
 		*this = std::move (me);
 	}
-	
+	~AttributeEntry () noexcept { clear (); }
+
 	AttributeEntry& operator=(AttributeEntry&& me) noexcept
 	{
-		data = std::move (me.data);
+		clear ();
+		size = me.size;
+		if (isInline ())
+			std::memcpy (inlineData, me.inlineData, size);
+		else
+			heapData = me.heapData;
+		me.size = 0;
 		return *this;
 	}
-	
-	uint32_t getSize () const { return static_cast<uint32_t> (data.size ()); }
-	const void* getData () const { return data.get (); }
-	
+
+	bool empty () const { return size == 0; }
+	uint32_t getSize () const { return size; }
+	const void* getData () const { return isInline () ? inlineData : heapData; }
+
 	void updateData (uint32_t _size, const void* _data)
 	{
-		data.allocate (_size);
-		if (!data.empty ())
+		if (_size != size)
 		{
-			std::memcpy (data.get (), _data, data.size ());
+			clear ();
+			if (_size > kInlineSize)
+				heapData = new int8_t[_size];
+			size = _size;
 		}
+		std::memcpy (isInline () ? inlineData : heapData, _data, size);
 	}
-	
-protected:
-	Buffer<int8_t> data;
+
+	void clear ()
+	{
+		if (!isInline ())
+			delete[] heapData;
+		size = 0;
+	}
+
+private:
+	bool isInline () const { return size <= kInlineSize; }
+
+	uint32_t size {0};
+	union
+	{
+		int8_t inlineData[kInlineSize];
+		int8_t* heapData;
+	};
+};
+
+//-----------------------------------------------------------------------------
+/** the attributes of a view. The attributes which most views have get their own slot, all others
+ *	are kept in a flat list as views only have a few attributes.
+ */
+class Attributes
+{
+public:
+	AttributeEntry* find (CViewAttributeID id)
+	{
+		auto index = fastIndex (id);
+		if (index < fast.size ())
+			return fast[index].empty () ? nullptr : &fast[index];
+		for (auto& other : others)
+		{
+			if (other.first == id)
+				return &other.second;
+		}
+		return nullptr;
+	}
+
+	const AttributeEntry* find (CViewAttributeID id) const
+	{
+		return const_cast<Attributes*> (this)->find (id);
+	}
+
+	AttributeEntry& getOrAdd (CViewAttributeID id)
+	{
+		auto index = fastIndex (id);
+		if (index < fast.size ())
+			return fast[index];
+		if (auto entry = find (id))
+			return *entry;
+		others.emplace_back (id, AttributeEntry ());
+		return others.back ().second;
+	}
+
+	bool remove (CViewAttributeID id)
+	{
+		auto index = fastIndex (id);
+		if (index < fast.size ())
+		{
+			if (fast[index].empty ())
+				return false;
+			fast[index].clear ();
+			return true;
+		}
+		for (auto it = others.begin (); it != others.end (); ++it)
+		{
+			if (it->first == id)
+			{
+				if (&*it != &others.back ())
+					*it = std::move (others.back ());
+				others.pop_back ();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void clear ()
+	{
+		for (auto& entry : fast)
+			entry.clear ();
+		others.clear ();
+	}
+
+	template<typename Proc>
+	void forEach (Proc proc) const
+	{
+		for (auto index = 0u; index < fast.size (); ++index)
+		{
+			if (!fast[index].empty ())
+				proc (kFastIDs[index], fast[index]);
+		}
+		for (auto& other : others)
+			proc (other.first, other.second);
+	}
+
+private:
+	/** the view name attribute is set by the UIViewFactory for every view it creates */
+	static constexpr CViewAttributeID kViewNameAttrID = 'cvcr';
+	static constexpr std::array<CViewAttributeID, 3> kFastIDs = {
+		kCViewControllerAttribute, kCViewTooltipAttribute, kViewNameAttrID};
+
+	static size_t fastIndex (CViewAttributeID id)
+	{
+		for (auto index = 0u; index < kFastIDs.size (); ++index)
+		{
+			if (kFastIDs[index] == id)
+				return index;
+		}
+		return kFastIDs.size ();
+	}
+
+	std::array<AttributeEntry, kFastIDs.size ()> fast;
+	std::vector<std::pair<CViewAttributeID, AttributeEntry>> others;
 };
 
 //-----------------------------------------------------------------------------
@@ -145,6 +268,9 @@ protected:
 };
 std::unique_ptr<IdleViewUpdater> IdleViewUpdater::gInstance;
 
+//-----------------------------------------------------------------------------
+static thread_local bool gDrawingConcurrently = false;
+
 } // CViewInternal
 
 /// @endcond
@@ -175,7 +301,7 @@ static constexpr CViewAttributeID kCViewDisabledBackgroundBitmapAttrID = 'cvdb';
 //-----------------------------------------------------------------------------
 struct CView::Impl
 {
-	using ViewAttributes = std::unordered_map<CViewAttributeID, std::unique_ptr<CViewInternal::AttributeEntry>>;
+	using ViewAttributes = CViewInternal::Attributes;
 	using ViewListenerDispatcher = DispatchList<IViewListener*>;
 	using ViewEventListenerDispatcher = DispatchList<IViewEventListener*>;
 
@@ -223,8 +349,9 @@ CView::CView (const CView& v)
 	setBackground (v.getBackground ());
 	setDisabledBackground (v.getDisabledBackground ());
 
-	for (auto& attribute : v.pImpl->attributes)
-		setAttribute (attribute.first, attribute.second->getSize (), attribute.second->getData ());
+	v.pImpl->attributes.forEach ([this] (CViewAttributeID id, const auto& entry) {
+		setAttribute (id, entry.getSize (), entry.getData ());
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -285,6 +412,11 @@ void CView::setMouseableArea (const CRect& rect)
 		setViewFlag (kHasMouseableArea, true);
 		setAttribute (kCViewMouseableAreaAttrID, rect);
 	}
+	if (auto parent = getParentView ())
+	{
+		if (auto container = parent->asViewContainer ())
+			container->invalidateHitTestIndex ();
+	}
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -402,6 +534,9 @@ void CView::setWantsIdle (bool state)
 //-----------------------------------------------------------------------------
 void CView::setDirty (bool state)
 {
+	// the dirty state was reset before, see CViewContainer::prepareConcurrentDraw
+	if (isDrawingConcurrently ())
+		return;
 	if (kDirtyCallAlwaysOnMainThread && isAttached ())
 	{
 		if (state)
@@ -416,9 +551,49 @@ void CView::setDirty (bool state)
 	else
 	{
 		setViewFlag (kDirty, state);
+		if (state)
+		{
+			if (auto parent = getParentView ())
+			{
+				if (auto container = parent->asViewContainer ())
+					container->markSubtreeDirty ();
+			}
+		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+bool CView::isDrawingConcurrently ()
+{
+	return CViewInternal::gDrawingConcurrently;
+}
+
+//-----------------------------------------------------------------------------
+CView::ConcurrentDrawScope::ConcurrentDrawScope ()
+: previous (CViewInternal::gDrawingConcurrently)
+{
+	CViewInternal::gDrawingConcurrently = true;
+}
+
+//-----------------------------------------------------------------------------
+CView::ConcurrentDrawScope::~ConcurrentDrawScope () noexcept
+{
+	CViewInternal::gDrawingConcurrently = previous;
+}
+
+//-----------------------------------------------------------------------------
+void CView::setHasUntrackedDirtyState (bool state)
+{
+	if (hasUntrackedDirtyState () == state)
+		return;
+	setViewFlag (kUntrackedDirtyState, state);
+	auto parent = getParentView ();
+	if (!isAttached () || !parent || parent == this)
+		return;
+	if (auto container = parent->asViewContainer ())
+		container->updateUntrackedDirtyViewCount (state ? 1 : -1);
+}
+
 //-----------------------------------------------------------------------------
 void CView::setSubviewState (bool state)
 {
@@ -439,6 +614,16 @@ bool CView::attached (CView* parent)
 	pImpl->parentView = parent;
 	pImpl->parentFrame = parent->getFrame ();
 	setViewFlag (kIsAttached, true);
+	if (parent != this)
+	{
+		if (auto container = parent->asViewContainer ())
+		{
+			if (hasUntrackedDirtyState ())
+				container->updateUntrackedDirtyViewCount (1);
+			if (isDirty ())
+				container->markSubtreeDirty ();
+		}
+	}
 	if (pImpl->parentFrame)
 		pImpl->parentFrame->onViewAdded (this);
 	if (wantsIdle ())
@@ -469,6 +654,11 @@ bool CView::removed (CView* parent)
 	}
 	if (pImpl->parentFrame)
 		pImpl->parentFrame->onViewRemoved (this);
+	if (hasUntrackedDirtyState () && pImpl->parentView && pImpl->parentView != this)
+	{
+		if (auto container = pImpl->parentView->asViewContainer ())
+			container->updateUntrackedDirtyViewCount (-1);
+	}
 	pImpl->parentView = nullptr;
 	pImpl->parentFrame = nullptr;
 	setViewFlag (kIsAttached, false);
@@ -856,6 +1046,17 @@ CGraphicsTransform CView::getGlobalTransform (bool ignoreFrame) const
 	return transform;
 }
 
+//-----------------------------------------------------------------------------
+void CView::invalid ()
+{
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	// record the caller of invalid instead of this function as the call site
+	DrawProfiler::InvalidationOrigin profilerOrigin (this, VSTGUI_DRAW_PROFILER_CALL_SITE);
+#endif
+	setDirty (false);
+	invalidRect (getViewSize ());
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @param rect rect to invalidate
@@ -865,6 +1066,9 @@ void CView::invalidRect (const CRect& rect)
 	if (isAttached () && hasViewFlag (kVisible))
 	{
 		vstgui_assert (pImpl->parentView);
+	#if VSTGUI_ENABLE_DRAW_PROFILER
+		DrawProfiler::InvalidationOrigin profilerOrigin (this, VSTGUI_DRAW_PROFILER_CALL_SITE);
+	#endif
 		pImpl->parentView->invalidRect (rect);
 	}
 }
@@ -998,8 +1202,12 @@ void CView::setViewSize (const CRect& newSize, bool doInvalid)
 		pImpl->size = newSize;
 		if (doInvalid)
 			setDirty ();
-		if (getParentView ())
-			getParentView ()->notify (this, kMsgViewSizeChanged);
+		if (auto parent = getParentView ())
+		{
+			if (auto container = parent->asViewContainer ())
+				container->invalidateHitTestIndex ();
+			parent->notify (this, kMsgViewSizeChanged);
+		}
 		if (pImpl->viewListeners)
 		{
 			pImpl->viewListeners->forEach (
@@ -1219,10 +1427,9 @@ void CView::setDisabledBackground (CBitmap* background)
  */
 bool CView::getAttributeSize (const CViewAttributeID aId, uint32_t& outSize) const
 {
-	auto it = pImpl->attributes.find (aId);
-	if (it != pImpl->attributes.end ())
+	if (auto entry = pImpl->attributes.find (aId))
 	{
-		outSize = it->second->getSize ();
+		outSize = entry->getSize ();
 		return true;
 	}
 	return false;
@@ -1238,14 +1445,13 @@ bool CView::getAttributeSize (const CViewAttributeID aId, uint32_t& outSize) con
  */
 bool CView::getAttribute (const CViewAttributeID aId, const uint32_t inSize, void* outData, uint32_t& outSize) const
 {
-	auto it = pImpl->attributes.find (aId);
-	if (it != pImpl->attributes.end ())
+	if (auto entry = pImpl->attributes.find (aId))
 	{
-		if (inSize >= it->second->getSize ())
+		if (inSize >= entry->getSize ())
 		{
-			outSize = it->second->getSize ();
+			outSize = entry->getSize ();
 			if (outSize > 0)
-				std::memcpy (outData, it->second->getData (), static_cast<size_t> (outSize));
+				std::memcpy (outData, entry->getData (), static_cast<size_t> (outSize));
 			return true;
 		}
 	}
@@ -1264,24 +1470,14 @@ bool CView::setAttribute (const CViewAttributeID aId, const uint32_t inSize, con
 {
 	if (inData == nullptr || inSize <= 0)
 		return false;
-	auto it = pImpl->attributes.find (aId);
-	if (it != pImpl->attributes.end ())
-		it->second->updateData (inSize, inData);
-	else
-		pImpl->attributes.emplace (aId, std::unique_ptr<CViewInternal::AttributeEntry> (new CViewInternal::AttributeEntry (inSize, inData)));
+	pImpl->attributes.getOrAdd (aId).updateData (inSize, inData);
 	return true;
 }
 
 //-----------------------------------------------------------------------------
 bool CView::removeAttribute (const CViewAttributeID aId)
 {
-	auto it = pImpl->attributes.find (aId);
-	if (it != pImpl->attributes.end ())
-	{
-		pImpl->attributes.erase (aId);
-		return true;
-	}
-	return false;
+	return pImpl->attributes.remove (aId);
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -73,7 +73,7 @@ public:
 	/** mark rect as invalid */
 	virtual void invalidRect (const CRect& rect);
 	/** mark whole view as invalid */
-	virtual void invalid () { setDirty (false); invalidRect (getViewSize ()); }
+	virtual void invalid ();
 
 	/** set visibility state */
 	virtual void setVisible (bool state);
@@ -386,6 +386,48 @@ public:
 	inline static uint32_t idleRate = 30;
 	//@}
 
+	/** declare that this view can be drawn on a worker thread while other views are drawn.
+	 *
+	 *	The view must only read its own state while drawing and must not invalidate itself. It may
+	 *	use colors, lines, paths and bitmaps, but no text and no gradients, as those are not safe
+	 *	to use from several threads. Views are drawn in parallel only if all views in the drawn
+	 *	area declare it, see LinuxFactory::setTileParallelDrawingEnabled.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setThreadSafeToDraw (bool state) { setViewFlag (kThreadSafeToDraw, state); }
+	bool isThreadSafeToDraw () const { return hasViewFlag (kThreadSafeToDraw); }
+
+	/** returns true while the calling thread draws views concurrently with other threads.
+	 *
+	 *	The dirty states are reset before the concurrent drawing, setDirty does nothing and the
+	 *	child views are visited without changing their reference counts.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	static bool isDrawingConcurrently ();
+
+	/** marks the calling thread as drawing concurrently while the scope exists */
+	struct ConcurrentDrawScope
+	{
+		ConcurrentDrawScope ();
+		~ConcurrentDrawScope () noexcept;
+
+	private:
+		bool previous;
+	};
+
+	/** declare that isDirty of this view may return true without a call to setDirty.
+	 *
+	 *	The parent containers only look for dirty views in the branches which were marked via
+	 *	CViewContainer::markSubtreeDirty and in the branches with views which declare this.
+	 *	Disabled per default, as these branches are searched on every dirty scan.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setHasUntrackedDirtyState (bool state);
+	bool hasUntrackedDirtyState () const { return hasViewFlag (kUntrackedDirtyState); }
+
 	/** whether this view wants to be informed if the window's active state changes */
 	virtual bool wantsWindowActiveStateChangeNotification () const { return false; }
 	/** called when the active state of the window changes */
@@ -463,7 +505,9 @@ protected:
 		kHasBackground			= 1 << 9,
 		kHasDisabledBackground	= 1 << 10,
 		kHasMouseableArea		= 1 << 11,
-		kLastCViewFlag			= 11
+		kThreadSafeToDraw		= 1 << 12,
+		kUntrackedDirtyState	= 1 << 13,
+		kLastCViewFlag			= 13
 	};
 
 	~CView () noexcept override;
@@ -15,11 +15,14 @@
 #include "controls/ccontrol.h"
 #include "dragging.h"
 #include "dispatchlist.h"
+#include "drawprofiler.h"
 #include "events.h"
 #include "finally.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -37,15 +40,234 @@ struct CViewContainer::Impl
 {
 	using ViewContainerListenerDispatcher = DispatchList<IViewContainerListener*>;
 	
+	/** uniform grid over the mouseable areas of the child views.
+	 *
+	 *	Every cell holds the indices of the child views overlapping it in ascending z order, stored
+	 *	contiguously for all cells.
+	 */
+	struct HitTestIndex
+	{
+		bool enabled {false};
+		bool dirty {true};
+
+		CRect bounds;
+		uint32_t columns {0};
+		uint32_t rows {0};
+		CCoord cellWidth {1.};
+		CCoord cellHeight {1.};
+		std::vector<CView*> views;
+		std::vector<uint32_t> cellOffsets;
+		std::vector<uint32_t> cellItems;
+
+		void build (const ChildViewList& children);
+		void clear ();
+
+		uint32_t columnAt (CCoord x) const
+		{
+			auto c = std::floor ((x - bounds.left) / cellWidth);
+			return static_cast<uint32_t> (std::clamp<CCoord> (c, 0., columns - 1));
+		}
+		uint32_t rowAt (CCoord y) const
+		{
+			auto r = std::floor ((y - bounds.top) / cellHeight);
+			return static_cast<uint32_t> (std::clamp<CCoord> (r, 0., rows - 1));
+		}
+
+		/** call proc for all views which may contain the point, top->down. Stops when proc
+		 *	returns false.
+		 */
+		template<typename Proc>
+		void forEachCandidate (const CPoint& where, Proc proc) const
+		{
+			if (!bounds.pointInside (where))
+				return;
+			auto cell = rowAt (where.y) * columns + columnAt (where.x);
+			auto first = cellItems.data () + cellOffsets[cell];
+			auto last = cellItems.data () + cellOffsets[cell + 1];
+			while (last != first)
+			{
+				--last;
+				if (!proc (views[*last]))
+					return;
+			}
+		}
+	};
+
+	/** call proc for the child views which may contain the point, top->down. Stops when proc
+	 *	returns false.
+	 */
+	template<typename Proc>
+	void forEachChildAt (const CPoint& where, Proc proc)
+	{
+		if (hitTestIndex.enabled)
+		{
+			if (hitTestIndex.dirty)
+				hitTestIndex.build (children);
+			hitTestIndex.forEachCandidate (where, proc);
+			return;
+		}
+		for (auto it = children.rbegin (), end = children.rend (); it != end; ++it)
+		{
+			if (!proc (it->get ()))
+				return;
+		}
+	}
+
+	/** call proc for all child views, tolerating that child views are added or removed by proc.
+	 *	If proc returns a bool, iteration stops when it returns false.
+	 */
+	template<typename Proc>
+	void visitChildren (Proc proc)
+	{
+		size_t index = 0;
+		while (index < children.size ())
+		{
+			auto view = children[index];
+			auto generation = childrenGeneration;
+			if (!callVisitor (proc, view))
+				return;
+			if (generation != childrenGeneration)
+			{
+				auto newIndex = findChild (view.get (), index);
+				if (newIndex == children.size ())
+					continue; // view was removed, the next one took its place
+				index = newIndex;
+			}
+			++index;
+		}
+	}
+
+	/** same as visitChildren, but top->down */
+	template<typename Proc>
+	void visitChildrenReverse (Proc proc)
+	{
+		size_t index = children.size ();
+		while (index > 0)
+		{
+			auto view = children[--index];
+			auto generation = childrenGeneration;
+			if (!callVisitor (proc, view))
+				return;
+			if (generation != childrenGeneration)
+			{
+				auto newIndex = findChild (view.get (), index);
+				if (newIndex == children.size ())
+					index = std::min (index, children.size ()); // view was removed
+				else
+					index = newIndex;
+			}
+		}
+	}
+
+	template<typename Proc>
+	static bool callVisitor (Proc& proc, const SharedPointer<CView>& view)
+	{
+		if constexpr (std::is_void_v<decltype (proc (view))>)
+		{
+			proc (view);
+			return true;
+		}
+		else
+			return proc (view);
+	}
+
+	/** the index of view or children.size () if it is not a child view */
+	size_t findChild (CView* view, size_t hint = 0) const
+	{
+		if (hint < children.size () && children[hint] == view)
+			return hint;
+		auto it = std::find (children.begin (), children.end (), view);
+		return static_cast<size_t> (std::distance (children.begin (), it));
+	}
+
+	void childrenChanged () { ++childrenGeneration; }
+
 	ViewContainerListenerDispatcher viewContainerListeners;
 	CGraphicsTransform transform;
 	
-	ViewList children;
+	ChildViewList children;
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+	ViewList deprecatedChildList;
+#endif
+	uint32_t childrenGeneration {0};
+	uint32_t numUntrackedDirtyViews {0};
+	HitTestIndex hitTestIndex;
 	
 	CDrawStyle backgroundColorDrawStyle {kDrawFilledAndStroked};
 	CColor backgroundColor {kBlackCColor};
 };
 
+//-----------------------------------------------------------------------------
+void CViewContainer::Impl::HitTestIndex::build (const ChildViewList& children)
+{
+	clear ();
+	dirty = false;
+	if (children.empty ())
+		return;
+
+	views.reserve (children.size ());
+	bool first = true;
+	for (const auto& child : children)
+	{
+		views.emplace_back (child.get ());
+		auto r = child->getMouseableArea ();
+		if (r.isEmpty ())
+			continue;
+		if (first)
+			bounds = r;
+		else
+			bounds.unite (r);
+		first = false;
+	}
+	if (first)
+		return;
+
+	// about one child view per cell for evenly distributed views
+	auto dim = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (views.size ()))));
+	columns = std::clamp<uint32_t> (dim, 1u, 256u);
+	rows = columns;
+	cellWidth = bounds.getWidth () / columns;
+	cellHeight = bounds.getHeight () / rows;
+
+	auto forEachCell = [this] (const CRect& r, auto&& proc) {
+		if (r.isEmpty ())
+			return;
+		auto c0 = columnAt (r.left);
+		auto c1 = columnAt (r.right);
+		auto r0 = rowAt (r.top);
+		auto r1 = rowAt (r.bottom);
+		for (auto row = r0; row <= r1; ++row)
+		{
+			for (auto column = c0; column <= c1; ++column)
+				proc (row * columns + column);
+		}
+	};
+
+	cellOffsets.assign (columns * rows + 1, 0);
+	for (auto view : views)
+		forEachCell (view->getMouseableArea (), [&] (uint32_t cell) { ++cellOffsets[cell + 1]; });
+	for (auto i = 1u; i < cellOffsets.size (); ++i)
+		cellOffsets[i] += cellOffsets[i - 1];
+	cellItems.resize (cellOffsets.back ());
+	std::vector<uint32_t> fill (cellOffsets.begin (), cellOffsets.end () - 1);
+	for (auto index = 0u; index < views.size (); ++index)
+	{
+		forEachCell (views[index]->getMouseableArea (),
+		             [&] (uint32_t cell) { cellItems[fill[cell]++] = index; });
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CViewContainer::Impl::HitTestIndex::clear ()
+{
+	bounds = {};
+	columns = rows = 0;
+	views.clear ();
+	cellOffsets.clear ();
+	cellItems.clear ();
+	dirty = true;
+}
+
 //------------------------------------------------------------------------
 struct CViewContainerDropTarget : public IDropTarget, public NonAtomicReferenceCounted
 {
@@ -191,8 +413,8 @@ void CViewContainer::unregisterViewContainerListener (IViewContainerListener* li
 //-----------------------------------------------------------------------------
 void CViewContainer::parentSizeChanged ()
 {
-	for (const auto& pV : pImpl->children)
-		pV->parentSizeChanged ();	// notify children that the size of the parent or this container has changed
+	// notify children that the size of the parent or this container has changed
+	pImpl->visitChildren ([] (CView* pV) { pV->parentSizeChanged (); });
 }
 
 //-----------------------------------------------------------------------------
@@ -253,11 +475,20 @@ void CViewContainer::setLastDrawnFocus (CRect r)
 }
 
 //-----------------------------------------------------------------------------
-auto CViewContainer::getChildren () const -> const ViewList&
+auto CViewContainer::getChildViews () const -> const ChildViewList&
 {
 	return pImpl->children;
 }
 
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+//-----------------------------------------------------------------------------
+auto CViewContainer::getChildren () const -> const ViewList&
+{
+	pImpl->deprecatedChildList.assign (pImpl->children.begin (), pImpl->children.end ());
+	return pImpl->deprecatedChildList;
+}
+#endif
+
 //-----------------------------------------------------------------------------
 void CViewContainer::setTransform (const CGraphicsTransform& t)
 {
@@ -276,6 +507,28 @@ const CGraphicsTransform& CViewContainer::getTransform () const
 	return pImpl->transform;
 }
 
+//-----------------------------------------------------------------------------
+void CViewContainer::setHitTestIndexEnabled (bool state)
+{
+	if (pImpl->hitTestIndex.enabled == state)
+		return;
+	pImpl->hitTestIndex.clear ();
+	pImpl->hitTestIndex.enabled = state;
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::getHitTestIndexEnabled () const
+{
+	return pImpl->hitTestIndex.enabled;
+}
+
+//-----------------------------------------------------------------------------
+void CViewContainer::invalidateHitTestIndex ()
+{
+	if (pImpl->hitTestIndex.enabled && !pImpl->hitTestIndex.dirty)
+		pImpl->hitTestIndex.clear ();
+}
+
 //-----------------------------------------------------------------------------
 void CViewContainer::setAutosizingEnabled (bool state)
 {
@@ -526,6 +779,8 @@ bool CViewContainer::addView (CView *pView, CView* pBefore)
 	{
 		pImpl->children.emplace_back (pView);
 	}
+	pImpl->childrenChanged ();
+	invalidateHitTestIndex ();
 
 	pView->setSubviewState (true);
 
@@ -568,20 +823,24 @@ bool CViewContainer::removeAll (bool withForget)
 {
 	clearMouseDownView ();
 	
-	auto it = pImpl->children.begin ();
-	while (it != pImpl->children.end ())
+	// remove from back to front, so that no child views need to be moved
+	while (!pImpl->children.empty ())
 	{
-		auto view = *it;
+		auto view = pImpl->children.back ();
 		if (isAttached ())
 			view->removed (this);
-		pImpl->children.erase (it);
+		auto index = pImpl->findChild (view, pImpl->children.size () - 1);
+		if (index == pImpl->children.size ())
+			continue;
+		pImpl->children.erase (pImpl->children.begin () + index);
+		pImpl->childrenChanged ();
+		invalidateHitTestIndex ();
 		view->setSubviewState (false);
 		pImpl->viewContainerListeners.forEach ([&] (IViewContainerListener* listener) {
 			listener->viewContainerViewRemoved (this, view);
 		});
 		if (withForget)
 			view->forget ();
-		it = pImpl->children.begin ();
 	}
 	return true;
 }
@@ -594,8 +853,8 @@ bool CViewContainer::removeAll (bool withForget)
  */
 bool CViewContainer::removeView (CView *pView, bool withForget)
 {
-	auto it = std::find (pImpl->children.begin (), pImpl->children.end (), pView);
-	if (it != pImpl->children.end ())
+	auto index = pImpl->findChild (pView);
+	if (index < pImpl->children.size ())
 	{
 		pView->invalid ();
 		if (pView == getMouseDownView ())
@@ -608,7 +867,12 @@ bool CViewContainer::removeView (CView *pView, bool withForget)
 		});
 		if (withForget)
 			pView->forget ();
-		pImpl->children.erase (it);
+		// the children may have been changed by the calls above
+		index = pImpl->findChild (pView, index);
+		if (index < pImpl->children.size ())
+			pImpl->children.erase (pImpl->children.begin () + index);
+		pImpl->childrenChanged ();
+		invalidateHitTestIndex ();
 		return true;
 	}
 	return false;
@@ -631,10 +895,8 @@ bool CViewContainer::isChild (CView *pView, bool deep) const
 
 	if (deep)
 	{
-		auto it = pImpl->children.begin ();
-		while (!found && it != pImpl->children.end ())
+		for (const auto& v : pImpl->children)
 		{
-			CView* v = (*it);
 			if (pView == v)
 			{
 				found = true;
@@ -642,12 +904,13 @@ bool CViewContainer::isChild (CView *pView, bool deep) const
 			}
 			if (CViewContainer* container = v->asViewContainer ())
 				found = container->isChild (pView, true);
-			++it;
+			if (found)
+				break;
 		}
 	}
 	else
 	{
-		found = std::find (pImpl->children.begin (), pImpl->children.end (), pView) != pImpl->children.end ();
+		found = pImpl->findChild (pView) < pImpl->children.size ();
 	}
 	return found;
 }
@@ -674,10 +937,8 @@ uint32_t CViewContainer::getNbViews () const
  */
 CView* CViewContainer::getView (uint32_t index) const
 {
-	auto it = pImpl->children.begin ();
-	std::advance (it, index);
-	if (it != pImpl->children.end ())
-		return *it;
+	if (index < pImpl->children.size ())
+		return pImpl->children[index];
 	return nullptr;
 }
 
@@ -691,21 +952,19 @@ bool CViewContainer::changeViewZOrder (CView* view, uint32_t newIndex)
 {
 	if (newIndex < getNbViews ())
 	{
-		uint32_t oldIndex = 0;
-		auto src = pImpl->children.begin ();
-		for (;src != pImpl->children.end () && *src != view; ++src, ++oldIndex);
-		if (src != pImpl->children.end ())
+		auto oldIndex = pImpl->findChild (view);
+		if (oldIndex < pImpl->children.size ())
 		{
 			if (newIndex == oldIndex)
 				return true;
-			if (newIndex > oldIndex)
-				++newIndex;
 
-			auto dest = pImpl->children.begin ();
-			std::advance (dest, newIndex);
-
-			pImpl->children.insert (dest, view);
-			pImpl->children.erase (src);
+			auto first = pImpl->children.begin ();
+			if (newIndex < oldIndex)
+				std::rotate (first + newIndex, first + oldIndex, first + oldIndex + 1);
+			else
+				std::rotate (first + oldIndex, first + oldIndex + 1, first + newIndex + 1);
+			pImpl->childrenChanged ();
+			invalidateHitTestIndex ();
 
 			pImpl->viewContainerListeners.forEach ([&] (IViewContainerListener* listener) {
 				listener->viewContainerViewZOrderChanged (this, view);
@@ -721,12 +980,17 @@ bool CViewContainer::invalidateDirtyViews ()
 {
 	if (!isVisible ())
 		return true;
+	// clear the mark before invalidating, views which get dirty meanwhile will set it again
+	bool subtreeDirty = isSubtreeDirty ();
+	setViewFlag (kSubtreeDirty, false);
 	if (CView::isDirty ())
 	{
 		if (auto parent = getParentView ())
 			parent->invalidRect (getViewSize ());
 		return true;
 	}
+	if (!subtreeDirty && !hasUntrackedDirtyViews ())
+		return true;
 	for (const auto& pV : pImpl->children)
 	{
 		if (pV->isDirty () && pV->isVisible ())
@@ -740,11 +1004,46 @@ bool CViewContainer::invalidateDirtyViews ()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void CViewContainer::markSubtreeDirty ()
+{
+	// always walk up to the frame, the parents may have been cleared independently
+	CViewContainer* container = this;
+	while (container)
+	{
+		container->setViewFlag (kSubtreeDirty, true);
+		auto parent = container->getParentView ();
+		container = parent && parent != container ? parent->asViewContainer () : nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CViewContainer::updateUntrackedDirtyViewCount (int32_t delta)
+{
+	CViewContainer* container = this;
+	while (container)
+	{
+		vstgui_assert (delta > 0 || container->pImpl->numUntrackedDirtyViews >= uint32_t (-delta));
+		container->pImpl->numUntrackedDirtyViews += delta;
+		auto parent = container->getParentView ();
+		container = parent && parent != container ? parent->asViewContainer () : nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::hasUntrackedDirtyViews () const
+{
+	return pImpl->numUntrackedDirtyViews > 0;
+}
+
 //-----------------------------------------------------------------------------
 void CViewContainer::invalid ()
 {
 	if (!isVisible ())
 		return;
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	DrawProfiler::InvalidationOrigin profilerOrigin (this, VSTGUI_DRAW_PROFILER_CALL_SITE);
+#endif
 	CRect _rect (getViewSize ());
 	if (auto parent = getParentView ())
 		parent->invalidRect (_rect);
@@ -761,6 +1060,9 @@ void CViewContainer::invalidRect (const CRect& rect)
 	_rect.bound (getViewSize ());
 	if (_rect.isEmpty ())
 		return;
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	DrawProfiler::InvalidationOrigin profilerOrigin (this, VSTGUI_DRAW_PROFILER_CALL_SITE);
+#endif
 	if (auto parent = getParentView ())
 		parent->invalidRect (_rect);
 }
@@ -833,6 +1135,16 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 	CRect newClip (clientRect);
 	newClip.bound (oldClip);
 	pContext->setClipRect (newClip);
+
+	// all child views are drawn, views which get dirty while drawing will set the mark again. When
+	// drawing concurrently the mark was cleared before, see prepareConcurrentDraw.
+	bool subtreeMarkCleared = false;
+	if (_updateRect == getViewSize () && newClip == clientRect && isSubtreeDirty () &&
+		!isDrawingConcurrently ())
+	{
+		setViewFlag (kSubtreeDirty, false);
+		subtreeMarkCleared = true;
+	}
 	
 	// draw the background
 	drawBackgroundRect (pContext, clientRect);
@@ -853,8 +1165,7 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 		getTransform ().transform (oldClip2);
 		
 		// draw each view
-		for (const auto& pV : pImpl->children)
-		{
+		auto drawChild = [&] (CView* pV) {
 			if (pV->isVisible ())
 			{
 				if (frame && _focusDrawing && _focusView == pV && !_focusDrawing->drawFocusOnTop ())
@@ -885,19 +1196,44 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 					CRect viewSize = pV->getViewSize ();
 					viewSize.bound (newClip);
 					if (viewSize.getWidth () == 0 || viewSize.getHeight () == 0)
-						continue;
+						return;
 					pContext->setClipRect (viewSize);
 					float globalContextAlpha = pContext->getGlobalAlpha ();
 					pContext->setGlobalAlpha (globalContextAlpha * pV->getAlphaValue ());
+				#if VSTGUI_ENABLE_DRAW_PROFILER
+					DrawProfiler::ViewDrawScope profilerScope (pV, viewSize);
+				#endif
 					pV->drawRect (pContext, viewSize);
 					pContext->setGlobalAlpha (globalContextAlpha);
 				}
 			}
+		};
+		if (isDrawingConcurrently ())
+		{
+			// the child views don't change while drawing concurrently and the reference counts
+			// must not be changed from several threads
+			for (const auto& pV : pImpl->children)
+				drawChild (pV.get ());
 		}
+		else
+			pImpl->visitChildren (drawChild);
 	}
 	
 	pContext->setClipRect (oldClip2);
 
+	// views which were not drawn or are still dirty after drawing must keep the mark
+	if (subtreeMarkCleared && !isSubtreeDirty ())
+	{
+		for (const auto& pV : pImpl->children)
+		{
+			if (pV->isVisible () && pV->isDirty ())
+			{
+				markSubtreeDirty ();
+				break;
+			}
+		}
+	}
+
 	if (frame && _focusView)
 	{
 		SharedPointer<CGraphicsPath> focusPath = owned (pContext->createGraphicsPath ());
@@ -931,6 +1267,36 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 	setDirty (false);
 }
 
+//-----------------------------------------------------------------------------
+bool CViewContainer::prepareConcurrentDraw (const CRect& updateRect)
+{
+	if (!isThreadSafeToDraw ())
+		return false;
+
+	CRect _updateRect (updateRect);
+	_updateRect.bound (getViewSize ());
+	if (_updateRect == getViewSize ())
+		setViewFlag (kSubtreeDirty, false);
+	setDirty (false);
+
+	CRect clientRect (_updateRect);
+	clientRect.offset (-getViewSize ().left, -getViewSize ().top);
+	getTransform ().inverse ().transform (clientRect);
+
+	bool result = true;
+	pImpl->visitChildren ([&] (CView* view) {
+		if (!result || !checkUpdateRect (view, clientRect))
+			return;
+		if (!view->isThreadSafeToDraw ())
+			result = false;
+		else if (auto container = view->asViewContainer ())
+			result = container->prepareConcurrentDraw (clientRect);
+		else
+			view->setDirty (false);
+	});
+	return result;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * check if view needs to be updated for rect
@@ -955,21 +1321,21 @@ bool CViewContainer::hitTestSubViews (const CPoint& where, const Event& event)
 	where2.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where2);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	bool result = false;
+	pImpl->forEachChildAt (where2, [&] (CView* pV) {
 		if (pV && pV->isVisible () && pV->getMouseEnabled () && pV->hitTest (where2, event))
 		{
 			if (auto container = pV->asViewContainer ())
 			{
 				if (container->hitTestSubViews (where2, event))
-					return true;
+					result = true;
 			}
 			else
-				return true;
+				result = true;
 		}
-	}
-	return false;
+		return !result;
+	});
+	return result;
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -990,18 +1356,16 @@ void CViewContainer::dispatchEventToSubViews (Event& event)
 		auto f = finally ([&] () { mouseEvent->mousePosition = mousePos; });
 		mouseEvent->mousePosition.offset (-getViewSize ().left, -getViewSize ().top);
 		getTransform ().inverse ().transform (mouseEvent->mousePosition);
-		for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end;
-			 ++it)
-		{
-			const auto& pV = *it;
+		pImpl->visitChildrenReverse ([&] (const SharedPointer<CView>& pV) {
 			if (pV && pV->isVisible () && pV->getMouseEnabled () &&
 				pV->getMouseableArea ().pointInside (mouseEvent->mousePosition))
 			{
 				pV->dispatchEvent (event);
 				if (!pV->getTransparency () || event.consumed)
-					return;
+					return false;
 			}
-		}
+			return true;
+		});
 	}
 }
 
@@ -1033,9 +1397,7 @@ void CViewContainer::onMouseDownEvent (MouseDownEvent& event)
 	auto f = finally ([&, pos = event.mousePosition] () { event.mousePosition = pos; });
 	event.mousePosition.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (event.mousePosition);
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	pImpl->visitChildrenReverse ([&] (const SharedPointer<CView>& pV) {
 		if (pV && pV->isVisible () && pV->getMouseEnabled () &&
 		    pV->hitTest (event.mousePosition, event))
 		{
@@ -1048,7 +1410,7 @@ void CViewContainer::onMouseDownEvent (MouseDownEvent& event)
 						if (listener->controlModifierClicked (control, buttonState) != 0)
 						{
 							event.consumed = true;
-							return;
+							return false;
 						}
 					}
 				}
@@ -1062,13 +1424,14 @@ void CViewContainer::onMouseDownEvent (MouseDownEvent& event)
 				event.consumed = true;
 				if (mouseResult == kMouseMoveEventHandledButDontNeedMoreEvents)
 					event.ignoreFollowUpMoveAndUpEvents (true);
-				return;
+				return false;
 			}
 #endif
 			pV->dispatchEvent (event);
 			if (event.consumed)
 			{
-				if (pV->getNbReference () >1)
+				// the view may have removed itself while handling the event
+				if (isChild (pV))
 				{
 					if (pV->wantsFocus () && frame && frame->getFocusView () == previousFocusView &&
 					    dynamic_cast<CControl*> (pV.get ()))
@@ -1078,12 +1441,13 @@ void CViewContainer::onMouseDownEvent (MouseDownEvent& event)
 					if (!event.ignoreFollowUpMoveAndUpEvents ())
 						setMouseDownView (pV);
 				}
-				return;
+				return false;
 			}
 			if (!pV->getTransparency ())
-				return;
+				return false;
 		}
-	}
+		return true;
+	});
 }
 
 //------------------------------------------------------------------------
@@ -1328,6 +1692,8 @@ bool CViewContainer::isDirty () const
 {
 	if (CView::isDirty ())
 		return true;
+	if (!isSubtreeDirty () && !hasUntrackedDirtyViews ())
+		return false;
 	
 	CRect viewSize (getViewSize ());
 	viewSize.offset (-getViewSize ().left, -getViewSize ().top);
@@ -1357,33 +1723,35 @@ CView* CViewContainer::getViewAt (const CPoint& p, const GetViewOptions& options
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	CView* result = nullptr;
+	pImpl->forEachChildAt (where, [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return true;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled () == false)
-					continue;
+					return true;
 			}
 			if (options.getDeep ())
 			{
 				if (auto container = pV->asViewContainer ())
 				{
 					CView* view = container->getViewAt (where, options);
-					return options.getIncludeViewContainer () ? (view ? view : container) : view;
+					result = options.getIncludeViewContainer () ? (view ? view : container) : view;
+					return false;
 				}
 			}
 			if (!options.getIncludeViewContainer () && pV->asViewContainer ())
-				continue;
-			return pV;
+				return true;
+			result = pV;
+			return false;
 		}
-	}
+		return true;
+	});
 
-	return nullptr;
+	return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -1401,17 +1769,15 @@ bool CViewContainer::getViewsAt (const CPoint& p, ViewList& views, const GetView
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	pImpl->forEachChildAt (where, [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return true;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled () == false)
-					continue;
+					return true;
 			}
 			if (options.getDeep ())
 			{
@@ -1421,12 +1787,13 @@ bool CViewContainer::getViewsAt (const CPoint& p, ViewList& views, const GetView
 			if (options.getIncludeViewContainer () == false)
 			{
 				if (pV->asViewContainer ())
-					continue;
+					return true;
 			}
 			views.emplace_back (pV);
 			result = true;
 		}
-	}
+		return true;
+	});
 
 	return result;
 }
@@ -1443,28 +1810,28 @@ CViewContainer* CViewContainer::getContainerAt (const CPoint& p, const GetViewOp
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	CViewContainer* result = const_cast<CViewContainer*> (this);
+	pImpl->forEachChildAt (where, [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return true;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled() == false)
-					continue;
+					return true;
 			}
 			if (options.getDeep ())
 			{
 				if (CViewContainer* container = pV->asViewContainer ())
-					return container->getContainerAt (where, options);
+					result = container->getContainerAt (where, options);
 			}
-			break;
+			return false;
 		}
-	}
+		return true;
+	});
 
-	return const_cast<CViewContainer*>(this);
+	return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -1491,8 +1858,7 @@ bool CViewContainer::removed (CView* parent)
 	if (!isAttached ())
 		return false;
 
-	for (const auto& pV : pImpl->children)
-		pV->removed (this);
+	pImpl->visitChildren ([this] (CView* pV) { pV->removed (this); });
 	
 	return CView::removed (parent);
 }
@@ -1508,8 +1874,9 @@ bool CViewContainer::attached (CView* parent)
 	bool result = CView::attached (parent);
 	if (result)
 	{
-		for (const auto& pV : pImpl->children)
-			pV->attached (this);
+		// child views may have changed their size while detached without notifying us
+		invalidateHitTestIndex ();
+		pImpl->visitChildren ([this] (CView* pV) { pV->attached (this); });
 	}
 	return result;
 }
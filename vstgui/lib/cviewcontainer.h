@@ -12,6 +12,7 @@
 #endif
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -52,7 +53,13 @@ private:
 class CViewContainer : public CView
 {
 public:
+	/** list of views, i.e. the result of getViewsAt */
 	using ViewList = std::list<SharedPointer<CView>>;
+	/** contiguous storage of the child views, see getChildViews.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	using ChildViewList = std::vector<SharedPointer<CView>>;
 
 	explicit CViewContainer (const CRect& size);
 	CViewContainer (const CViewContainer& viewContainer);
@@ -90,6 +97,23 @@ public:
 
 	virtual bool hitTestSubViews (const CPoint& where, const Event& event);
 
+	/** enable or disable a spatial index for hit testing the child views.
+	 *
+	 *	Per default this is disabled. Enable it for containers with many child views to speed up
+	 *	getViewAt, getViewsAt, getContainerAt and hitTestSubViews. The index is rebuilt lazily
+	 *	when child views were added, removed, resized or changed their z order or mouseable area.
+	 *	It assumes that a child view only hits points inside its mouseable area.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setHitTestIndexEnabled (bool state);
+	/** @ingroup new_in_4_14 */
+	bool getHitTestIndexEnabled () const;
+	/** mark the hit test index as outdated, normally called automatically by the child views.
+	 *	@ingroup new_in_4_14
+	 */
+	void invalidateHitTestIndex ();
+
 	/** enable or disable autosizing subviews. Per default this is enabled. */
 	virtual void setAutosizingEnabled (bool state);
 	bool getAutosizingEnabled () const { return hasViewFlag (kAutosizeSubviews); }
@@ -98,7 +122,7 @@ public:
 	template<class ViewClass, class ContainerClass>
 	uint32_t getChildViewsOfType (ContainerClass& result, bool deep = false) const;
 
-	/** execute proc for each child view */
+	/** execute proc for each child view, proc may add or remove child views */
 	template<typename Proc>
 	void forEachChild (Proc proc) const;
 
@@ -125,6 +149,32 @@ public:
 
 	virtual bool advanceNextFocusView (CView* oldFocus, bool reverse = false);
 	virtual bool invalidateDirtyViews ();
+	/** mark that a view in the subtree of this container became dirty.
+	 *
+	 *	This is called by the child views when they become dirty and propagates to the parent
+	 *	containers, so that isDirty and invalidateDirtyViews only need to descend into the
+	 *	branches of the view hierarchy which have dirty views. The mark is cleared by
+	 *	invalidateDirtyViews and when the whole container is drawn.
+	 *	Views which override isDirty must call this on their parent when they get dirty without
+	 *	calling setDirty, or declare it via CView::setHasUntrackedDirtyState.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void markSubtreeDirty ();
+	/** @ingroup new_in_4_14 */
+	bool isSubtreeDirty () const { return hasViewFlag (kSubtreeDirty); }
+	/** called by the attached views of the subtree when they enable or disable
+	 *	CView::setHasUntrackedDirtyState, the count propagates to the parent containers
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void updateUntrackedDirtyViewCount (int32_t delta);
+	/** returns true if the subtree contains views with an untracked dirty state, these subtrees
+	 *	are always searched for dirty views
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	bool hasUntrackedDirtyViews () const;
 	virtual CRect getVisibleSize (const CRect& rect) const;
 
 	void setTransform (const CGraphicsTransform& t);
@@ -175,64 +225,64 @@ public:
 	CPoint& localToFrame (CPoint& point) const override;
 
 	//-----------------------------------------------------------------------------
+	/** iterators of the deprecated getChildren, use ChildViewList iterators instead */
 	using ChildViewConstIterator = ViewList::const_iterator;
 	using ChildViewConstReverseIterator = ViewList::const_reverse_iterator;
 
 	//-----------------------------------------------------------------------------
+	/** iterates over the child views the container had when the iterator was created, so child
+	 *	views may be added or removed while iterating
+	 */
 	template<bool reverse>
 	class Iterator
 	{
 	public:
-		using IteratorType = typename std::conditional<reverse, ChildViewConstReverseIterator,
-													   ChildViewConstIterator>::type;
-
-		explicit Iterator (const CViewContainer* container) : children (container->getChildren ())
+		explicit Iterator (const CViewContainer* container)
+		: children (container->getChildViews ())
 		{
-			if constexpr (reverse)
-				iterator = children.rbegin ();
-			else
-				iterator = children.begin ();
 		}
 
 		explicit Iterator (const Iterator<reverse>& vi)
-		: children (vi.children), iterator (vi.iterator)
+		: children (vi.children), index (vi.index)
 		{
 		}
 
-		Iterator (Iterator<reverse>&& o) : children (o.children), iterator (std::move (o.iterator))
+		Iterator (Iterator<reverse>&& o) : children (std::move (o.children)), index (o.index)
 		{
 		}
 
 		Iterator<reverse>& operator++ ()
 		{
-			++iterator;
+			++index;
 			return *this;
 		}
 
 		Iterator<reverse> operator++ (int)
 		{
 			Iterator<reverse> old (*this);
-			++iterator;
+			++index;
 			return old;
 		}
 		
 		Iterator<reverse>& operator-- ()
 		{
-			--iterator;
+			--index;
 			return *this;
 		}
 		
 		CView* operator* () const
 		{
+			if (index >= children.size ())
+				return nullptr;
 			if constexpr (reverse)
-				return (iterator == children.rend ()) ? nullptr : *iterator;
+				return children[children.size () - 1 - index];
 			else
-				return (iterator == children.end ()) ? nullptr : *iterator;
+				return children[index];
 		}
 		
 	protected:
-		const ViewList& children;
-		IteratorType iterator;
+		ChildViewList children;
+		size_t index {0};
 	};
 
 	//-------------------------------------------
@@ -248,18 +298,31 @@ public:
 
 protected:
 	enum {
-		kAutosizeSubviews = 1 << (CView::kLastCViewFlag + 1)
+		kAutosizeSubviews = 1 << (CView::kLastCViewFlag + 1),
+		kSubtreeDirty = 1 << (CView::kLastCViewFlag + 2)
 	};
 	
 	~CViewContainer () noexcept override;
 	void beforeDelete () override;
 	
 	virtual bool checkUpdateRect (CView* view, const CRect& rect);
+	/** check that all views in the update rect are thread-safe to draw and clear the flags which
+	 *	drawing would write, so that the update rect can be drawn in parallel tiles afterwards
+	 */
+	bool prepareConcurrentDraw (const CRect& updateRect);
 
 	void setMouseDownView (CView* view);
 	CView* getMouseDownView () const;
 	
-	const ViewList& getChildren () const;
+	/** the child views in z order. Adding or removing child views invalidates iterators into
+	 *	this list, copy it if the child views may change while iterating.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	const ChildViewList& getChildViews () const;
+	VSTGUI_DEPRECATED_MSG (
+	/** a copy of the child views as a ViewList, made on every call */
+	const ViewList& getChildren () const;, "Use getChildViews instead")
 private:
 	void dispatchEventToSubViews (Event& event);
 	
@@ -278,8 +341,11 @@ using ReverseViewIterator = CViewContainer::Iterator<true>;
 template<class ViewClass, class ContainerClass>
 inline uint32_t CViewContainer::getChildViewsOfType (ContainerClass& result, bool deep) const
 {
-	for (auto& child : getChildren ())
+	// index based, so that the loop stays valid if the child views change meanwhile
+	const auto& children = getChildViews ();
+	for (size_t i = 0; i < children.size (); ++i)
 	{
+		auto child = children[i];
 		auto vObj = child.cast<ViewClass> ();
 		if (vObj)
 		{
@@ -300,7 +366,9 @@ inline uint32_t CViewContainer::getChildViewsOfType (ContainerClass& result, boo
 template <typename Proc>
 inline void CViewContainer::forEachChild (Proc proc) const
 {
-	for (auto& child : getChildren ())
+	// iterate a copy, proc may add or remove child views
+	auto children = getChildViews ();
+	for (auto& child : children)
 	{
 		proc (child);
 	}
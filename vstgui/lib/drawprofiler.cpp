@@ -0,0 +1,574 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "drawprofiler.h"
+#include "cview.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+#if !WINDOWS
+#include <dlfcn.h>
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+//------------------------------------------------------------------------
+struct ProfilerThreadState
+{
+	uint32_t depth {0};
+	int64_t childTime {0};
+	const CView* originView {nullptr};
+	const void* originCallSite {nullptr};
+	const char* tag {nullptr};
+};
+
+std::atomic<uint32_t> gNextProfilerThreadIndex {0};
+thread_local ProfilerThreadState gProfilerThreadState;
+thread_local uint32_t gProfilerThreadIndex = gNextProfilerThreadIndex++;
+
+//------------------------------------------------------------------------
+void appendJSONString (std::ostream& stream, const std::string& str)
+{
+	stream << '"';
+	for (auto c : str)
+	{
+		if (c == '"' || c == '\\')
+			stream << '\\';
+		stream << c;
+	}
+	stream << '"';
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+/** one record of the ring buffer, guarded by a sequence lock
+ *
+ *	The sequence is odd while the record is written and 2 * (index + 1) when the record of the
+ *	write index is complete. A reader copies the record and checks that the sequence did not change.
+ *	The record is stored in relaxed atomic words, so that a reader racing with a writer reads torn
+ *	but defined values, which it then discards.
+ */
+struct DrawProfiler::Slot
+{
+	static_assert (std::is_trivially_copyable<Record>::value, "the record is copied in words");
+	static constexpr size_t kNumWords =
+		(sizeof (Record) + sizeof (uint64_t) - 1) / sizeof (uint64_t);
+	using Words = std::array<uint64_t, kNumWords>;
+
+	std::atomic<uint64_t> sequence {0};
+	std::array<std::atomic<uint64_t>, kNumWords> words {};
+
+	void store (const Record& record)
+	{
+		Words data {};
+		std::memcpy (data.data (), &record, sizeof (Record));
+		for (auto i = 0u; i < kNumWords; ++i)
+			words[i].store (data[i], std::memory_order_relaxed);
+	}
+
+	void load (Record& record) const
+	{
+		Words data;
+		for (auto i = 0u; i < kNumWords; ++i)
+			data[i] = words[i].load (std::memory_order_relaxed);
+		std::memcpy (static_cast<void*> (&record), data.data (), sizeof (Record));
+	}
+};
+
+//------------------------------------------------------------------------
+struct DrawProfiler::Impl
+{
+	static constexpr uint64_t kCapacity = 1 << 15; // must be a power of two
+
+	std::unique_ptr<Slot[]> slots;
+	std::atomic<uint64_t> writeIndex {0};
+	std::atomic<uint64_t> firstIndex {0};
+	std::atomic<uint32_t> numActiveFrameScopes {0};
+	std::atomic<int64_t> frameStartTime {0};
+	std::chrono::steady_clock::time_point epoch {std::chrono::steady_clock::now ()};
+
+	bool read (uint64_t index, Record& record) const
+	{
+		const auto& slot = slots[index & (kCapacity - 1)];
+		auto sequence = slot.sequence.load (std::memory_order_acquire);
+		// still written or already overwritten
+		if (sequence != (index + 1) * 2)
+			return false;
+		slot.load (record);
+		std::atomic_thread_fence (std::memory_order_acquire);
+		return slot.sequence.load (std::memory_order_relaxed) == sequence;
+	}
+};
+
+//------------------------------------------------------------------------
+DrawProfiler& DrawProfiler::instance ()
+{
+	static DrawProfiler gInstance;
+	return gInstance;
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::DrawProfiler () { impl = std::make_unique<Impl> (); }
+
+//------------------------------------------------------------------------
+DrawProfiler::~DrawProfiler () noexcept = default;
+
+//------------------------------------------------------------------------
+void DrawProfiler::setEnabled (bool state)
+{
+	if (!isAvailable ())
+		return;
+	if (state && !impl->slots)
+		impl->slots = std::unique_ptr<Slot[]> (new Slot[Impl::kCapacity]);
+	enabled.store (state, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+void DrawProfiler::clear ()
+{
+	impl->firstIndex.store (impl->writeIndex.load (std::memory_order_acquire),
+							std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+int64_t DrawProfiler::now () const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds> (
+			   std::chrono::steady_clock::now () - impl->epoch)
+		.count ();
+}
+
+//------------------------------------------------------------------------
+void DrawProfiler::push (const Record& record)
+{
+	auto index = impl->writeIndex.fetch_add (1, std::memory_order_relaxed);
+	auto& slot = impl->slots[index & (Impl::kCapacity - 1)];
+	slot.sequence.store (index * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+	slot.store (record);
+	slot.sequence.store ((index + 1) * 2, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------
+std::vector<DrawProfiler::Record> DrawProfiler::getRecords (uint64_t firstFrame) const
+{
+	std::vector<Record> records;
+	if (!impl->slots)
+		return records;
+	auto end = impl->writeIndex.load (std::memory_order_acquire);
+	auto oldest = std::max (impl->firstIndex.load (std::memory_order_acquire),
+							end > Impl::kCapacity ? end - Impl::kCapacity : 0);
+	auto begin = oldest;
+	if (firstFrame > 0)
+	{
+		// the records are written in frame order, so only the newest records are visited
+		Record record;
+		for (begin = end; begin > oldest; --begin)
+		{
+			if (impl->read (begin - 1, record) && record.frameIndex < firstFrame)
+				break;
+		}
+	}
+	records.reserve (static_cast<size_t> (end - begin));
+	Record record;
+	for (auto index = begin; index < end; ++index)
+	{
+		if (impl->read (index, record) && record.frameIndex >= firstFrame)
+			records.emplace_back (record);
+	}
+	return records;
+}
+
+//------------------------------------------------------------------------
+std::vector<DrawProfiler::FrameStatistics> DrawProfiler::getFrameStatistics (
+	uint64_t firstFrame) const
+{
+	std::vector<FrameStatistics> result;
+	for (const auto& record : getRecords (firstFrame))
+	{
+		if (record.type != RecordType::Frame)
+			continue;
+		result.push_back ({record.frameIndex, record.startTime, record.duration});
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------
+std::vector<DrawProfiler::ViewStatistics> DrawProfiler::getViewStatistics (
+	uint64_t firstFrame) const
+{
+	std::unordered_map<const CView*, ViewStatistics> map;
+	for (const auto& record : getRecords (firstFrame))
+	{
+		if (record.type == RecordType::Frame)
+			continue;
+		auto& stats = map[record.view];
+		stats.view = record.view;
+		stats.typeName = record.typeName;
+		if (record.type == RecordType::ViewDraw)
+		{
+			++stats.numDraws;
+			stats.totalTime += record.duration;
+			stats.selfTime += record.selfDuration;
+		}
+		else
+		{
+			++stats.numInvalidations;
+		}
+	}
+	std::vector<ViewStatistics> result;
+	result.reserve (map.size ());
+	for (const auto& entry : map)
+		result.emplace_back (entry.second);
+	std::sort (result.begin (), result.end (),
+			   [] (const auto& lhs, const auto& rhs) { return lhs.selfTime > rhs.selfTime; });
+	return result;
+}
+
+//------------------------------------------------------------------------
+std::vector<DrawProfiler::InvalidationStatistics> DrawProfiler::getInvalidationStatistics (
+	uint64_t firstFrame) const
+{
+	using Key = std::tuple<uint64_t, const CView*, const void*, const char*>;
+	std::map<Key, size_t> indices;
+	std::vector<InvalidationStatistics> result;
+	for (const auto& record : getRecords (firstFrame))
+	{
+		if (record.type != RecordType::Invalidation)
+			continue;
+		Key key (record.frameIndex, record.view, record.callSite, record.tag);
+		auto it = indices.find (key);
+		if (it == indices.end ())
+		{
+			InvalidationStatistics stats;
+			stats.frameIndex = record.frameIndex;
+			stats.view = record.view;
+			stats.typeName = record.typeName;
+			stats.callSite = record.callSite;
+			stats.tag = record.tag;
+			stats.bounds = record.rect;
+			it = indices.emplace (key, result.size ()).first;
+			result.emplace_back (stats);
+		}
+		auto& stats = result[it->second];
+		++stats.count;
+		stats.bounds.unite (record.rect);
+		stats.area += record.rect.getWidth () * record.rect.getHeight ();
+	}
+	std::stable_sort (result.begin (), result.end (), [] (const auto& lhs, const auto& rhs) {
+		if (lhs.frameIndex != rhs.frameIndex)
+			return lhs.frameIndex < rhs.frameIndex;
+		return lhs.area > rhs.area;
+	});
+	return result;
+}
+
+//------------------------------------------------------------------------
+std::string DrawProfiler::describeCallSite (const void* callSite)
+{
+	if (!callSite)
+		return {};
+	std::ostringstream stream;
+	stream.imbue (std::locale::classic ());
+#if !WINDOWS
+	Dl_info info {};
+	if (dladdr (callSite, &info))
+	{
+		auto address = reinterpret_cast<uintptr_t> (callSite);
+		if (info.dli_sname && info.dli_saddr)
+		{
+			stream << demangle (info.dli_sname) << "+0x" << std::hex
+				   << (address - reinterpret_cast<uintptr_t> (info.dli_saddr));
+			return stream.str ();
+		}
+		if (info.dli_fname && info.dli_fbase)
+		{
+			std::string module (info.dli_fname);
+			auto pos = module.find_last_of ('/');
+			if (pos != std::string::npos)
+				module.erase (0, pos + 1);
+			stream << module << "+0x" << std::hex
+				   << (address - reinterpret_cast<uintptr_t> (info.dli_fbase));
+			return stream.str ();
+		}
+	}
+#endif
+	stream << callSite;
+	return stream.str ();
+}
+
+//------------------------------------------------------------------------
+std::string DrawProfiler::demangle (const char* typeName)
+{
+	if (!typeName)
+		return {};
+#if defined(__GNUC__) || defined(__clang__)
+	int status = 0;
+	if (auto name = abi::__cxa_demangle (typeName, nullptr, nullptr, &status))
+	{
+		std::string result (name);
+		std::free (name);
+		return result;
+	}
+#endif
+	return typeName;
+}
+
+//------------------------------------------------------------------------
+std::string DrawProfiler::createChromeTrace () const
+{
+	std::unordered_map<const char*, std::string> names;
+	auto getName = [&] (const char* typeName) -> const std::string& {
+		auto it = names.find (typeName);
+		if (it == names.end ())
+			it = names.emplace (typeName, demangle (typeName)).first;
+		return it->second;
+	};
+	std::unordered_map<const void*, std::string> callSites;
+	auto getCallSite = [&] (const void* callSite) -> const std::string& {
+		auto it = callSites.find (callSite);
+		if (it == callSites.end ())
+			it = callSites.emplace (callSite, describeCallSite (callSite)).first;
+		return it->second;
+	};
+
+	std::ostringstream stream;
+	stream.imbue (std::locale::classic ());
+	stream.setf (std::ios::fixed);
+	stream.precision (3);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto& record : getRecords ())
+	{
+		stream << (first ? "\n" : ",\n");
+		first = false;
+		stream << "{\"name\":";
+		switch (record.type)
+		{
+			case RecordType::ViewDraw:
+				appendJSONString (stream, getName (record.typeName));
+				stream << ",\"cat\":\"draw\",\"ph\":\"X\"";
+				break;
+			case RecordType::Frame:
+				stream << "\"Frame\",\"cat\":\"frame\",\"ph\":\"X\"";
+				break;
+			case RecordType::Invalidation:
+				appendJSONString (stream, "invalid " + getName (record.typeName));
+				stream << ",\"cat\":\"invalid\",\"ph\":\"i\",\"s\":\"t\"";
+				break;
+		}
+		stream << ",\"ts\":" << record.startTime / 1000.;
+		if (record.type != RecordType::Invalidation)
+			stream << ",\"dur\":" << record.duration / 1000.;
+		stream << ",\"pid\":1,\"tid\":" << record.threadIndex;
+		stream << ",\"args\":{\"frame\":" << record.frameIndex;
+		if (record.type != RecordType::Frame)
+		{
+			stream << ",\"view\":\"" << static_cast<const void*> (record.view) << "\"";
+			stream << ",\"rect\":[" << record.rect.left << "," << record.rect.top << ","
+				   << record.rect.right << "," << record.rect.bottom << "]";
+		}
+		if (record.type == RecordType::ViewDraw)
+			stream << ",\"self\":" << record.selfDuration / 1000.;
+		if (record.type == RecordType::Invalidation)
+		{
+			stream << ",\"site\":";
+			appendJSONString (stream, getCallSite (record.callSite));
+			if (record.tag)
+			{
+				stream << ",\"tag\":";
+				appendJSONString (stream, record.tag);
+			}
+		}
+		stream << "}}";
+	}
+	stream << "\n]}\n";
+	return stream.str ();
+}
+
+//------------------------------------------------------------------------
+std::string DrawProfiler::createInvalidationReport (uint64_t firstFrame) const
+{
+	std::ostringstream stream;
+	stream.imbue (std::locale::classic ());
+	stream << "{\"frames\":[";
+	uint64_t currentFrame = 0;
+	bool firstEntry = true;
+	for (const auto& stats : getInvalidationStatistics (firstFrame))
+	{
+		if (firstEntry || stats.frameIndex != currentFrame)
+		{
+			if (!firstEntry)
+				stream << "\n]},";
+			stream << "\n{\"frame\":" << stats.frameIndex << ",\"invalidations\":[";
+			currentFrame = stats.frameIndex;
+		}
+		else
+		{
+			stream << ",";
+		}
+		firstEntry = false;
+		stream << "\n{\"view\":";
+		appendJSONString (stream, demangle (stats.typeName));
+		stream << ",\"address\":\"" << static_cast<const void*> (stats.view) << "\"";
+		stream << ",\"site\":";
+		appendJSONString (stream, describeCallSite (stats.callSite));
+		if (stats.tag)
+		{
+			stream << ",\"tag\":";
+			appendJSONString (stream, stats.tag);
+		}
+		stream << ",\"count\":" << stats.count << ",\"area\":" << stats.area;
+		stream << ",\"bounds\":[" << stats.bounds.left << "," << stats.bounds.top << ","
+			   << stats.bounds.right << "," << stats.bounds.bottom << "]}";
+	}
+	if (!firstEntry)
+		stream << "\n]}";
+	stream << "\n]}\n";
+	return stream.str ();
+}
+
+//------------------------------------------------------------------------
+void DrawProfiler::recordInvalidation (const CView* view, const CRect& rect,
+									   const void* callSite)
+{
+	if (!isEnabled ())
+		return;
+	const auto& state = gProfilerThreadState;
+	if (state.originView)
+	{
+		view = state.originView;
+		callSite = state.originCallSite;
+	}
+	Record record;
+	record.type = RecordType::Invalidation;
+	record.threadIndex = gProfilerThreadIndex;
+	record.frameIndex = getFrameIndex ();
+	record.view = view;
+	record.typeName = typeid (*view).name ();
+	record.startTime = now ();
+	record.rect = rect;
+	record.callSite = callSite;
+	record.tag = state.tag;
+	push (record);
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::InvalidationOrigin::InvalidationOrigin (const CView* view, const void* callSite)
+{
+	auto& state = gProfilerThreadState;
+	if (state.originView || !instance ().isEnabled ())
+		return;
+	active = true;
+	state.originView = view;
+	state.originCallSite = callSite;
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::InvalidationOrigin::~InvalidationOrigin () noexcept
+{
+	if (!active)
+		return;
+	auto& state = gProfilerThreadState;
+	state.originView = nullptr;
+	state.originCallSite = nullptr;
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::InvalidationTag::InvalidationTag (const char* tag)
+{
+	auto& state = gProfilerThreadState;
+	previousTag = state.tag;
+	state.tag = tag;
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::InvalidationTag::~InvalidationTag () noexcept { gProfilerThreadState.tag = previousTag; }
+
+//------------------------------------------------------------------------
+DrawProfiler::ViewDrawScope::ViewDrawScope (const CView* v, const CRect& r)
+{
+	auto& profiler = instance ();
+	if (!profiler.isEnabled ())
+		return;
+	view = v;
+	rect = r;
+	auto& state = gProfilerThreadState;
+	parentChildTime = state.childTime;
+	state.childTime = 0;
+	++state.depth;
+	startTime = profiler.now ();
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::ViewDrawScope::~ViewDrawScope () noexcept
+{
+	if (!view)
+		return;
+	auto& profiler = instance ();
+	auto& state = gProfilerThreadState;
+	Record record;
+	record.type = RecordType::ViewDraw;
+	record.depth = --state.depth;
+	record.threadIndex = gProfilerThreadIndex;
+	record.frameIndex = profiler.getFrameIndex ();
+	record.view = view;
+	record.typeName = typeid (*view).name ();
+	record.startTime = startTime;
+	record.duration = profiler.now () - startTime;
+	record.selfDuration = record.duration - state.childTime;
+	record.rect = rect;
+	state.childTime = parentChildTime + record.duration;
+	profiler.push (record);
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::FrameScope::FrameScope ()
+{
+	auto& profiler = instance ();
+	if (!profiler.isEnabled ())
+		return;
+	active = true;
+	if (profiler.impl->numActiveFrameScopes.fetch_add (1, std::memory_order_acq_rel) == 0)
+		profiler.impl->frameStartTime.store (profiler.now (), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+DrawProfiler::FrameScope::~FrameScope () noexcept
+{
+	if (!active)
+		return;
+	auto& profiler = instance ();
+	if (profiler.impl->numActiveFrameScopes.fetch_sub (1, std::memory_order_acq_rel) != 1)
+		return;
+	Record record;
+	record.type = RecordType::Frame;
+	record.threadIndex = gProfilerThreadIndex;
+	record.frameIndex = profiler.getFrameIndex ();
+	record.startTime = profiler.impl->frameStartTime.load (std::memory_order_relaxed);
+	record.duration = profiler.now () - record.startTime;
+	profiler.push (record);
+	profiler.frameIndex.fetch_add (1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
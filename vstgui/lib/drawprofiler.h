@@ -0,0 +1,213 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "vstguifwd.h"
+#include "crect.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VSTGUI_DRAW_PROFILER_CALL_SITE __builtin_return_address (0)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define VSTGUI_DRAW_PROFILER_CALL_SITE _ReturnAddress ()
+#else
+#define VSTGUI_DRAW_PROFILER_CALL_SITE nullptr
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** Records the draw time of the views, the duration of the frames and the invalidations
+ *
+ *	The recording is only compiled in when VSTGUI_ENABLE_DRAW_PROFILER is set and must in
+ *	addition be enabled at runtime with setEnabled. The records are written into a fixed size
+ *	ring buffer without locking, so that views drawn concurrently on several threads can be
+ *	recorded. When the ring buffer is full the oldest records are overwritten.
+ *
+ *	A frame is one paint pass of the platform frame. Nested and concurrent FrameScopes (e.g. of
+ *	the tiles of one paint pass) are recorded as one frame.
+ *
+ *	Every rect which reaches CFrame::invalidRect is recorded in frame coordinates together with
+ *	its provenance: the view which started the invalidation, the return address of its
+ *	invalidRect or invalid call and the innermost InvalidationTag of the thread. Invalidations are recorded
+ *	with the index of the frame which will draw them.
+ *
+ *	@ingroup new_in_4_14
+ */
+class DrawProfiler
+{
+public:
+	enum class RecordType : uint32_t
+	{
+		ViewDraw,
+		Frame,
+		Invalidation
+	};
+
+	struct Record
+	{
+		RecordType type {RecordType::ViewDraw};
+		/** nesting depth of the draw scopes on the thread */
+		uint32_t depth {0};
+		uint32_t threadIndex {0};
+		uint64_t frameIndex {0};
+		/** only use the pointer for comparison, the view may be destroyed */
+		const CView* view {nullptr};
+		/** the mangled type name of the view */
+		const char* typeName {nullptr};
+		/** nanoseconds since the profiler was created */
+		int64_t startTime {0};
+		int64_t duration {0};
+		/** duration without the nested draw scopes */
+		int64_t selfDuration {0};
+		/** the drawn rect in view coordinates or the invalid rect in frame coordinates */
+		CRect rect;
+		/** invalidations only: the code which called invalidRect and the InvalidationTag */
+		const void* callSite {nullptr};
+		const char* tag {nullptr};
+	};
+
+	struct ViewStatistics
+	{
+		const CView* view {nullptr};
+		const char* typeName {nullptr};
+		uint64_t numDraws {0};
+		uint64_t numInvalidations {0};
+		int64_t totalTime {0};
+		int64_t selfTime {0};
+	};
+
+	/** the invalidations of one frame with the same origin, call site and tag */
+	struct InvalidationStatistics
+	{
+		uint64_t frameIndex {0};
+		const CView* view {nullptr};
+		const char* typeName {nullptr};
+		const void* callSite {nullptr};
+		const char* tag {nullptr};
+		uint32_t count {0};
+		/** the union of the rects in frame coordinates */
+		CRect bounds;
+		/** the sum of the areas of the rects */
+		double area {0.};
+	};
+
+	struct FrameStatistics
+	{
+		uint64_t frameIndex {0};
+		int64_t startTime {0};
+		int64_t duration {0};
+	};
+
+	static DrawProfiler& instance ();
+	/** returns true if the recording was compiled in */
+	static constexpr bool isAvailable () { return VSTGUI_ENABLE_DRAW_PROFILER != 0; }
+
+	/** enable or disable the recording, the ring buffer is allocated when first enabled */
+	void setEnabled (bool state);
+	bool isEnabled () const { return enabled.load (std::memory_order_acquire); }
+	/** remove all records */
+	void clear ();
+
+	/** index of the current or the next frame */
+	uint64_t getFrameIndex () const { return frameIndex.load (std::memory_order_relaxed); }
+
+	/** copy the records of the frames since firstFrame which were not yet overwritten, oldest
+	 *	first
+	 */
+	std::vector<Record> getRecords (uint64_t firstFrame = 0) const;
+	/** the frames since firstFrame, oldest first */
+	std::vector<FrameStatistics> getFrameStatistics (uint64_t firstFrame = 0) const;
+	/** the draw costs of the views since firstFrame, sorted by self time, most expensive first */
+	std::vector<ViewStatistics> getViewStatistics (uint64_t firstFrame = 0) const;
+	/** the invalidations since firstFrame grouped by frame, origin, call site and tag, sorted by
+	 *	frame and by area, largest first
+	 */
+	std::vector<InvalidationStatistics> getInvalidationStatistics (uint64_t firstFrame = 0) const;
+	/** export the records in the Chrome trace event format (chrome://tracing, Perfetto) */
+	std::string createChromeTrace () const;
+	/** export the invalidation statistics since firstFrame as JSON */
+	std::string createInvalidationReport (uint64_t firstFrame = 0) const;
+
+	/** returns the readable name of a mangled type name */
+	static std::string demangle (const char* typeName);
+	/** returns the symbol name and offset of a call site if available, otherwise its address */
+	static std::string describeCallSite (const void* callSite);
+
+	/** records the draw of one view */
+	struct ViewDrawScope
+	{
+		ViewDrawScope (const CView* view, const CRect& rect);
+		~ViewDrawScope () noexcept;
+
+	private:
+		const CView* view {nullptr};
+		CRect rect;
+		int64_t startTime {0};
+		int64_t parentChildTime {0};
+	};
+
+	/** records one paint pass */
+	struct FrameScope
+	{
+		FrameScope ();
+		~FrameScope () noexcept;
+
+	private:
+		bool active {false};
+	};
+
+	/** marks the view which starts an invalidation on this thread, only the outermost origin is
+	 *	recorded when the rect is passed on to the parent views
+	 */
+	struct InvalidationOrigin
+	{
+		InvalidationOrigin (const CView* view, const void* callSite);
+		~InvalidationOrigin () noexcept;
+
+	private:
+		bool active {false};
+	};
+
+	/** a compact tag for the invalidations on this thread while the tag exists, e.g.
+	 *	InvalidationTag tag ("meter update"). The string must outlive the profiler.
+	 */
+	struct InvalidationTag
+	{
+		explicit InvalidationTag (const char* tag);
+		~InvalidationTag () noexcept;
+
+	private:
+		const char* previousTag {nullptr};
+	};
+
+	/** record the invalid rect in frame coordinates. The view and the call site are only used
+	 *	when there is no InvalidationOrigin on this thread.
+	 */
+	void recordInvalidation (const CView* view, const CRect& rect,
+							 const void* callSite = nullptr);
+
+	~DrawProfiler () noexcept;
+
+private:
+	DrawProfiler ();
+
+	int64_t now () const;
+	void push (const Record& record);
+
+	struct Slot;
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+	std::atomic<bool> enabled {false};
+	std::atomic<uint64_t> frameIndex {0};
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
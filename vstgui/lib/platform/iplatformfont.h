@@ -18,6 +18,16 @@ class IFontPainter
 public:
 	virtual ~IFontPainter () noexcept = default;
 
+	/** create a text layout which shapes the string once for measuring and drawing
+	 *
+	 *	the default implementation uses getStringWidth and drawString
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	virtual PlatformTextLayoutPtr createTextLayout (const PlatformGraphicsDeviceContextPtr& context,
+													IPlatformString* string,
+													bool antialias = true) const;
+
 	virtual void drawString (const PlatformGraphicsDeviceContextPtr& context,
 							 IPlatformString* string, const CPoint& p, const CColor& color,
 							 bool antialias = true) const = 0;
@@ -25,6 +35,33 @@ public:
 								   IPlatformString* string, bool antialias = true) const = 0;
 };
 
+//-----------------------------------------------------------------------------
+// IPlatformTextLayout Declaration
+//! @brief a shaped single line text
+///
+/// Created by IFontPainter::createTextLayout. The text is shaped once and can then be measured
+/// and drawn multiple times. A text layout must not outlive the platform font it was created with.
+///
+/// @ingroup new_in_4_14
+//-----------------------------------------------------------------------------
+class IPlatformTextLayout : public AtomicReferenceCounted
+{
+public:
+	/** returns the width of the text */
+	virtual CCoord getWidth () const = 0;
+	/** returns if the text can be split before the character (unicode code point) at index
+	 *	without breaking a grapheme cluster. The start and the end of the text are boundaries. */
+	virtual bool isClusterBoundary (size_t index) const = 0;
+	/** returns the horizontal offset of the character (unicode code point) at index from the start
+	 *	of the text, characters inside a grapheme cluster have the offset of the cluster. The offset
+	 *	of the index after the last character is the width of the text. If not supported returns -1
+	 */
+	virtual CCoord getCharacterOffset (size_t index) const = 0;
+	/** draw the text with its baseline starting at p */
+	virtual void draw (const PlatformGraphicsDeviceContextPtr& context, const CPoint& p,
+					   const CColor& color) const = 0;
+};
+
 //-----------------------------------------------------------------------------
 // IPlatformFont declaration
 //! @brief platform font class
@@ -20,6 +20,7 @@ enum class PlatformType : int32_t {
 	kHWNDTopLevel,	// Windows HWDN Top Level (non child)
 	kX11EmbedWindowID,	// X11 XID
 	kGdkWindow, // GdkWindow
+	kHeadless, // no window, draws into an offscreen surface (Linux only)
 
 	kDefaultNative = -1
 };
@@ -34,6 +35,10 @@ public:
 
 	virtual void platformDrawRects (const PlatformGraphicsDeviceContextPtr& context,
 									double scaleFactor, const std::vector<CRect>& rects) = 0;
+	/** called before the rect is drawn in tiles on several threads via platformDrawRects, return
+	 *	false to draw it on the calling thread instead
+	 */
+	virtual bool platformPrepareConcurrentDraw (const CRect& rect) { return false; }
 	
 	virtual void platformOnEvent (Event& event) = 0;
 
@@ -6,6 +6,7 @@
 #include "../../cresourcedescription.h"
 #include "linuxfactory.h"
 #include "cairobitmap.h"
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -231,6 +232,7 @@ SharedPointer<IPlatformBitmapPixelAccess> Bitmap::lockPixels (bool alphaPremulti
 void Bitmap::setScaleFactor (double factor)
 {
 	scaleFactor = factor;
+	scaledSurface = {};
 }
 
 //-----------------------------------------------------------------------------
@@ -239,6 +241,52 @@ double Bitmap::getScaleFactor () const
 	return scaleFactor;
 }
 
+//-----------------------------------------------------------------------------
+const SurfaceHandle& Bitmap::getScaledSurface (double deviceScaleFactor, cairo_filter_t filter)
+{
+	static const SurfaceHandle empty;
+	if (locked || isRenderTarget || !surface)
+		return empty;
+	if (scaledSurface.surface && scaledSurface.deviceScaleFactor == deviceScaleFactor &&
+		scaledSurface.filter == filter)
+		return scaledSurface.surface;
+
+	scaledSurface = {};
+	auto factor = deviceScaleFactor / scaleFactor;
+	auto width = static_cast<int> (std::ceil (size.x * factor));
+	auto height = static_cast<int> (std::ceil (size.y * factor));
+	if (width <= 0 || height <= 0)
+		return empty;
+	SurfaceHandle scaled (cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height));
+	if (cairo_surface_status (scaled) != CAIRO_STATUS_SUCCESS)
+		return empty;
+	ContextHandle context (cairo_create (scaled));
+	cairo_scale (context, factor, factor);
+	cairo_set_source_surface (context, surface, 0, 0);
+	cairo_pattern_set_filter (cairo_get_source (context), filter);
+	cairo_paint (context);
+	cairo_surface_flush (scaled);
+
+	scaledSurface.surface = std::move (scaled);
+	scaledSurface.deviceScaleFactor = deviceScaleFactor;
+	scaledSurface.filter = filter;
+	return scaledSurface.surface;
+}
+
+//-----------------------------------------------------------------------------
+void Bitmap::setIsRenderTarget ()
+{
+	isRenderTarget = true;
+	scaledSurface = {};
+}
+
+//-----------------------------------------------------------------------------
+void Bitmap::unlock ()
+{
+	locked = false;
+	scaledSurface = {};
+}
+
 //-----------------------------------------------------------------------------
 PNGBitmapBuffer Bitmap::createMemoryPNGRepresentation () const
 {
@@ -48,13 +48,31 @@ public:
 		return surface;
 	}
 
-	void unlock () { locked = false; }
+	/** get a copy of the surface resampled for the backing scale factor of a draw context
+	 *
+	 *	The copy is kept until the backing scale factor or the filter changes or the pixels are
+	 *	modified via lockPixels, so that drawing the bitmap becomes a 1:1 copy. Bitmaps which are
+	 *	used as the target of a draw context are not cached and return an empty handle.
+	 */
+	const SurfaceHandle& getScaledSurface (double deviceScaleFactor, cairo_filter_t filter);
+	void setIsRenderTarget ();
+
+	void unlock ();
 
 private:
+	struct ScaledSurface
+	{
+		SurfaceHandle surface;
+		double deviceScaleFactor {0.};
+		cairo_filter_t filter {CAIRO_FILTER_GOOD};
+	};
+
 	double scaleFactor {1.0};
 	SurfaceHandle surface;
+	ScaledSurface scaledSurface;
 	CPoint size;
 	bool locked {false};
+	bool isRenderTarget {false};
 };
 
 //------------------------------------------------------------------------
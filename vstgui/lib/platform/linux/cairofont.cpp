@@ -14,6 +14,10 @@
 #include <pango/pango-features.h>
 #include <pango/pangofc-fontmap.h>
 #include <fontconfig/fontconfig.h>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -135,6 +139,10 @@ struct Font::Impl
 	CCoord descent {-1.};
 	CCoord leading {-1.};
 	CCoord capHeight {-1.};
+
+	using TextPath = std::unique_ptr<cairo_path_t, decltype (&cairo_path_destroy)>;
+	static constexpr size_t kMaxTextPaths = 64;
+	mutable std::unordered_map<std::string, TextPath> textPaths;
 };
 
 //------------------------------------------------------------------------
@@ -209,25 +217,25 @@ double Font::getCapHeight () const { return impl->capHeight; }
 const IFontPainter* Font::getPainter () const { return this; }
 
 //------------------------------------------------------------------------
-void Font::drawString (const PlatformGraphicsDeviceContextPtr& context, IPlatformString* string,
-					   const CPoint& p, const CColor& color, bool antialias) const
+namespace {
+
+//------------------------------------------------------------------------
+PangoLayout* createPangoLayout (PangoFont* font, int32_t style, IPlatformString* string,
+								bool withAttributes)
 {
-	auto cairoContext = std::dynamic_pointer_cast<CairoGraphicsDeviceContext> (context);
-	if (!cairoContext)
-		return;
 	auto linuxString = dynamic_cast<LinuxString*> (string);
 	if (!linuxString)
-		return;
+		return nullptr;
 	PangoContext* pangoContext = FontList::instance ().getFontContext ();
 	if (!pangoContext)
-		return;
+		return nullptr;
 	PangoLayout* layout = pango_layout_new (pangoContext);
 	if (!layout)
-		return;
+		return nullptr;
 
-	if (impl->font)
+	if (font)
 	{
-		PangoFontDescription* desc = pango_font_describe (impl->font);
+		PangoFontDescription* desc = pango_font_describe (font);
 		if (desc)
 		{
 			pango_layout_set_font_description (layout, desc);
@@ -235,66 +243,180 @@ void Font::drawString (const PlatformGraphicsDeviceContextPtr& context, IPlatfor
 		}
 	}
 
-	PangoAttrList* attrs = pango_attr_list_new ();
-	if (attrs)
+	if (withAttributes && (style & (kUnderlineFace | kStrikethroughFace)))
 	{
-		if (impl->style & kUnderlineFace)
-			pango_attr_list_insert (attrs, pango_attr_underline_new (PANGO_UNDERLINE_SINGLE));
-		if (impl->style & kStrikethroughFace)
-			pango_attr_list_insert (attrs, pango_attr_strikethrough_new (true));
-		pango_layout_set_attributes (layout, attrs);
-		pango_attr_list_unref (attrs);
+		PangoAttrList* attrs = pango_attr_list_new ();
+		if (attrs)
+		{
+			if (style & kUnderlineFace)
+				pango_attr_list_insert (attrs, pango_attr_underline_new (PANGO_UNDERLINE_SINGLE));
+			if (style & kStrikethroughFace)
+				pango_attr_list_insert (attrs, pango_attr_strikethrough_new (true));
+			pango_layout_set_attributes (layout, attrs);
+			pango_attr_list_unref (attrs);
+		}
 	}
 
 	pango_layout_set_text (layout, linuxString->get ().c_str (), -1);
+	return layout;
+}
 
-	PangoRectangle extents {};
-	pango_layout_get_pixel_extents (layout, nullptr, &extents);
+//------------------------------------------------------------------------
+class TextLayout : public IPlatformTextLayout
+{
+public:
+	TextLayout (PangoLayout* layout) : layout (layout)
+	{
+		int pangoWidth = 0;
+		pango_layout_get_pixel_size (layout, &pangoWidth, nullptr);
+		width = pangoWidth;
+
+		PangoRectangle extents {};
+		pango_layout_get_pixel_extents (layout, nullptr, &extents);
+		PangoLayoutIter* iter = pango_layout_get_iter (layout);
+		CCoord baseline = 0.0;
+		if (iter)
+		{
+			baseline = pango_units_to_double (pango_layout_iter_get_baseline (iter));
+			pango_layout_iter_free (iter);
+		}
+		drawOffset = {static_cast<CCoord> (extents.x), extents.y - baseline};
+	}
+
+	~TextLayout () noexcept override { g_object_unref (layout); }
+
+	CCoord getWidth () const override { return width; }
+
+	bool isClusterBoundary (size_t index) const override
+	{
+		gint numAttrs = 0;
+		auto attrs = pango_layout_get_log_attrs_readonly (layout, &numAttrs);
+		if (!attrs || index >= static_cast<size_t> (numAttrs))
+			return false;
+		return attrs[index].is_cursor_position;
+	}
 
-	PangoLayoutIter* iter = pango_layout_get_iter (layout);
-	CCoord baseline = 0.0;
-	if (iter)
+	CCoord getCharacterOffset (size_t index) const override
 	{
-		baseline = pango_units_to_double (pango_layout_iter_get_baseline (iter));
-		pango_layout_iter_free (iter);
+		if (characterOffsets.empty ())
+			calculateCharacterOffsets ();
+		if (index >= characterOffsets.size ())
+			return -1.;
+		return characterOffsets[index];
+	}
+
+	void draw (const PlatformGraphicsDeviceContextPtr& context, const CPoint& p,
+			   const CColor& color) const override
+	{
+		if (auto cairoContext = std::dynamic_pointer_cast<CairoGraphicsDeviceContext> (context))
+			cairoContext->drawPangoLayout (layout, p + drawOffset, color);
+	}
+
+private:
+	/** one pass over the clusters of the shaped text */
+	void calculateCharacterOffsets () const
+	{
+		const char* text = pango_layout_get_text (layout);
+		auto numBytes = strlen (text);
+		std::vector<CCoord> clusterOffsets (numBytes + 1, -1.);
+		if (PangoLayoutIter* iter = pango_layout_get_iter (layout))
+		{
+			do
+			{
+				auto byteIndex = static_cast<size_t> (pango_layout_iter_get_index (iter));
+				if (byteIndex >= numBytes)
+					continue;
+				PangoRectangle logical {};
+				pango_layout_iter_get_cluster_extents (iter, nullptr, &logical);
+				clusterOffsets[byteIndex] = pango_units_to_double (logical.x);
+			} while (pango_layout_iter_next_cluster (iter));
+			pango_layout_iter_free (iter);
+		}
+		characterOffsets.reserve (g_utf8_strlen (text, -1) + 1);
+		CCoord offset = 0.;
+		for (auto pos = text; *pos; pos = g_utf8_next_char (pos))
+		{
+			auto clusterOffset = clusterOffsets[static_cast<size_t> (pos - text)];
+			if (clusterOffset >= 0.)
+				offset = clusterOffset;
+			characterOffsets.push_back (offset);
+		}
+		characterOffsets.push_back (width);
 	}
 
-	cairoContext->drawPangoLayout (layout, {p.x + extents.x, p.y + extents.y - baseline}, color);
+	PangoLayout* layout;
+	CCoord width;
+	CPoint drawOffset;
+	mutable std::vector<CCoord> characterOffsets;
+};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PlatformTextLayoutPtr Font::createTextLayout (const PlatformGraphicsDeviceContextPtr&,
+											  IPlatformString* string, bool antialias) const
+{
+	if (auto layout = createPangoLayout (impl->font, impl->style, string, true))
+		return makeOwned<TextLayout> (layout);
+	return nullptr;
+}
 
-	g_object_unref (layout);
+//------------------------------------------------------------------------
+void Font::drawString (const PlatformGraphicsDeviceContextPtr& context, IPlatformString* string,
+					   const CPoint& p, const CColor& color, bool antialias) const
+{
+	if (!std::dynamic_pointer_cast<CairoGraphicsDeviceContext> (context))
+		return;
+	if (auto layout = createTextLayout (context, string, antialias))
+		layout->draw (context, p, color);
 }
 
 //------------------------------------------------------------------------
 CCoord Font::getStringWidth (const PlatformGraphicsDeviceContextPtr&, IPlatformString* string,
 							 bool antialias) const
 {
-	if (auto linuxString = dynamic_cast<LinuxString*> (string))
+	int pangoWidth = 0;
+	if (auto layout = createPangoLayout (impl->font, impl->style, string, false))
 	{
-		int pangoWidth = 0;
-		PangoContext* context = FontList::instance ().getFontContext ();
-		if (context)
+		pango_layout_get_pixel_size (layout, &pangoWidth, nullptr);
+		g_object_unref (layout);
+	}
+	return pangoWidth;
+}
+
+//------------------------------------------------------------------------
+void Font::appendTextPath (cairo_t* context, UTF8StringPtr text) const
+{
+	auto it = impl->textPaths.find (text);
+	if (it == impl->textPaths.end ())
+	{
+		Impl::TextPath path (nullptr, cairo_path_destroy);
+		LinuxString string (text);
+		if (auto layout = createPangoLayout (impl->font, impl->style, &string, true))
 		{
-			PangoLayout* layout = pango_layout_new (context);
-			if (layout)
-			{
-				if (impl->font)
-				{
-					PangoFontDescription* desc = pango_font_describe (impl->font);
-					if (desc)
-					{
-						pango_layout_set_font_description (layout, desc);
-						pango_font_description_free (desc);
-					}
-				}
-				pango_layout_set_text (layout, linuxString->get ().c_str (), -1);
-				pango_layout_get_pixel_size (layout, &pangoWidth, nullptr);
-				g_object_unref (layout);
-			}
+			SurfaceHandle surface (cairo_image_surface_create (CAIRO_FORMAT_A8, 1, 1));
+			ContextHandle pathContext (cairo_create (surface));
+			auto baseline = pango_units_to_double (pango_layout_get_baseline (layout));
+			cairo_move_to (pathContext, 0., impl->capHeight - baseline);
+			pango_cairo_layout_path (pathContext, layout);
+			path.reset (cairo_copy_path (pathContext));
+			g_object_unref (layout);
 		}
-
-		return pangoWidth;
+		if (impl->textPaths.size () >= Impl::kMaxTextPaths)
+			impl->textPaths.clear ();
+		it = impl->textPaths.emplace (text, std::move (path)).first;
+	}
+	if (it->second)
+	{
+		CPoint current;
+		if (cairo_has_current_point (context))
+			cairo_get_current_point (context, &current.x, &current.y);
+		cairo_save (context);
+		cairo_translate (context, current.x, current.y);
+		cairo_append_path (context, it->second.get ());
+		cairo_restore (context);
 	}
-	return 0;
 }
 
 //------------------------------------------------------------------------
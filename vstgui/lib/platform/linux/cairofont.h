@@ -6,6 +6,7 @@
 
 #include "../iplatformfont.h"
 #include "../platformfactory.h"
+#include "cairoutils.h"
 #include <memory>
 
 //------------------------------------------------------------------------
@@ -33,6 +34,16 @@ public:
 					 const CPoint& p, const CColor& color, bool antialias = true) const override;
 	CCoord getStringWidth (const PlatformGraphicsDeviceContextPtr& context, IPlatformString* string,
 						   bool antialias = true) const override;
+	PlatformTextLayoutPtr createTextLayout (const PlatformGraphicsDeviceContextPtr& context,
+											IPlatformString* string,
+											bool antialias = true) const override;
+
+	/** append the outlines of the text to the current path of the context
+	 *
+	 *	The text starts at the current point of the context, the top of the capitals is at its y
+	 *	coordinate. The outlines are created once per text and font and then reused.
+	 */
+	void appendTextPath (cairo_t* context, UTF8StringPtr text) const;
 
 	static bool getAllFamilies (const FontFamilyCallback& callback);
 
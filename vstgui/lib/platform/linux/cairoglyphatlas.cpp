@@ -0,0 +1,527 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cairoglyphatlas.h"
+#include <pango/pangocairo.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Cairo {
+namespace {
+
+std::atomic<bool> gGlyphAtlasEnabled {false};
+
+//------------------------------------------------------------------------
+/** only latin text without combining marks is drawn via the atlas, everything above U+02FF may
+ *	need the full Pango renderer (combining marks, bidi, vertical glyph offsets, ...)
+ */
+bool isSimpleText (const char* utf8)
+{
+	if (!utf8)
+		return false;
+	for (auto ptr = reinterpret_cast<const uint8_t*> (utf8); *ptr; ++ptr)
+	{
+		if (*ptr < 0x80)
+			continue;
+		if (*ptr < 0xC2 || *ptr > 0xCB || (ptr[1] & 0xC0) != 0x80)
+			return false;
+		++ptr;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+struct GlyphAtlas::Impl
+{
+	static constexpr int kAtlasSize = 1024;
+	static constexpr int kMaxScratchSize = 4096;
+	static constexpr uint32_t kNumSubpixelPositions = 4;
+
+	using FontRef = Handle<PangoFont*, decltype (&g_object_ref), g_object_ref,
+						   decltype (&g_object_unref), g_object_unref>;
+
+	struct FontKey
+	{
+		PangoFont* font;
+		double scale;
+
+		bool operator== (const FontKey& o) const { return font == o.font && scale == o.scale; }
+	};
+
+	struct GlyphKey
+	{
+		PangoFont* font;
+		double scale;
+		uint32_t glyph;
+		uint32_t subpixel;
+
+		bool operator== (const GlyphKey& o) const
+		{
+			return font == o.font && scale == o.scale && glyph == o.glyph &&
+				   subpixel == o.subpixel;
+		}
+	};
+
+	struct KeyHash
+	{
+		size_t operator() (const FontKey& k) const
+		{
+			return std::hash<const void*> () (k.font) ^ (std::hash<double> () (k.scale) << 1);
+		}
+		size_t operator() (const GlyphKey& k) const
+		{
+			auto h = operator() (FontKey {k.font, k.scale});
+			return h ^ (std::hash<uint32_t> () ((k.glyph << 2) | k.subpixel) + 0x9e3779b9 +
+						(h << 6) + (h >> 2));
+		}
+	};
+
+	/** location of the glyph in the atlas and the offset of its top left corner to the origin */
+	struct Glyph
+	{
+		int x {0};
+		int y {0};
+		int width {0};
+		int height {0};
+		int left {0};
+		int top {0};
+	};
+
+	struct ScaledFont
+	{
+		FontRef font;
+		ScaledFontHandle scaledFont;
+	};
+
+	struct Shelf
+	{
+		int y;
+		int height;
+		int x;
+	};
+
+	struct Quad
+	{
+		Glyph glyph;
+		int x;
+		int y;
+	};
+
+	enum class Result
+	{
+		Success,
+		AtlasFull,
+		Failed
+	};
+
+	mutable std::mutex mutex;
+	SurfaceHandle atlas;
+	ContextHandle atlasContext;
+	SurfaceHandle scratch;
+	int scratchWidth {0};
+	int scratchHeight {0};
+	std::unordered_map<FontKey, ScaledFont, KeyHash> fonts;
+	std::unordered_map<GlyphKey, Glyph, KeyHash> glyphs;
+	std::vector<Shelf> shelves;
+	int shelfBottom {0};
+	std::vector<Quad> quads;
+	Statistics stats;
+
+	//------------------------------------------------------------------------
+	bool init ()
+	{
+		if (atlas)
+			return true;
+		atlas.assign (cairo_image_surface_create (CAIRO_FORMAT_A8, kAtlasSize, kAtlasSize));
+		if (cairo_surface_status (atlas) != CAIRO_STATUS_SUCCESS)
+		{
+			atlas.reset ();
+			return false;
+		}
+		atlasContext.assign (cairo_create (atlas));
+		cairo_set_antialias (atlasContext, CAIRO_ANTIALIAS_GRAY);
+		cairo_set_source_rgba (atlasContext, 0., 0., 0., 1.);
+		return true;
+	}
+
+	//------------------------------------------------------------------------
+	void reset ()
+	{
+		glyphs.clear ();
+		fonts.clear ();
+		shelves.clear ();
+		shelfBottom = 0;
+		if (!atlas)
+			return;
+		cairo_surface_flush (atlas);
+		memset (cairo_image_surface_get_data (atlas), 0,
+				cairo_image_surface_get_stride (atlas) * kAtlasSize);
+		cairo_surface_mark_dirty (atlas);
+	}
+
+	//------------------------------------------------------------------------
+	bool allocate (Glyph& glyph)
+	{
+		Shelf* bestShelf = nullptr;
+		for (auto& shelf : shelves)
+		{
+			if (glyph.height > shelf.height || shelf.x + glyph.width > kAtlasSize)
+				continue;
+			if (!bestShelf || shelf.height < bestShelf->height)
+				bestShelf = &shelf;
+		}
+		if (!bestShelf)
+		{
+			if (shelfBottom + glyph.height > kAtlasSize || glyph.width > kAtlasSize)
+				return false;
+			shelves.push_back ({shelfBottom, glyph.height, 0});
+			shelfBottom += glyph.height;
+			bestShelf = &shelves.back ();
+		}
+		glyph.x = bestShelf->x;
+		glyph.y = bestShelf->y;
+		bestShelf->x += glyph.width;
+		return true;
+	}
+
+	//------------------------------------------------------------------------
+	cairo_scaled_font_t* getScaledFont (PangoFont* font, double scale)
+	{
+		auto it = fonts.find ({font, scale});
+		if (it != fonts.end ())
+			return it->second.scaledFont;
+		if (!PANGO_IS_CAIRO_FONT (font))
+			return nullptr;
+		auto pangoScaledFont = pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (font));
+		if (!pangoScaledFont)
+			return nullptr;
+		cairo_matrix_t fontMatrix;
+		cairo_matrix_t ctm;
+		cairo_scaled_font_get_font_matrix (pangoScaledFont, &fontMatrix);
+		cairo_matrix_init_scale (&ctm, scale, scale);
+		auto options = cairo_font_options_create ();
+		cairo_scaled_font_get_font_options (pangoScaledFont, options);
+		// the atlas only holds coverage, subpixel antialiased fonts are left to Pango. Fonts
+		// without antialiasing are rasterized without, all others in gray.
+		auto antialias = cairo_font_options_get_antialias (options);
+		if (antialias == CAIRO_ANTIALIAS_SUBPIXEL)
+		{
+			cairo_font_options_destroy (options);
+			return nullptr;
+		}
+		if (antialias != CAIRO_ANTIALIAS_NONE)
+			cairo_font_options_set_antialias (options, CAIRO_ANTIALIAS_GRAY);
+		ScaledFontHandle scaledFont (cairo_scaled_font_create (
+			cairo_scaled_font_get_font_face (pangoScaledFont), &fontMatrix, &ctm, options));
+		cairo_font_options_destroy (options);
+		if (cairo_scaled_font_status (scaledFont) != CAIRO_STATUS_SUCCESS)
+			return nullptr;
+		FontRef fontRef;
+		fontRef.assign (PANGO_FONT (g_object_ref (font)));
+		auto result = fonts.emplace (FontKey {font, scale},
+									 ScaledFont {std::move (fontRef), std::move (scaledFont)});
+		return result.first->second.scaledFont;
+	}
+
+	//------------------------------------------------------------------------
+	Result rasterize (const GlyphKey& key, cairo_scaled_font_t* scaledFont, Glyph& result)
+	{
+		cairo_glyph_t glyph {key.glyph, 0., 0.};
+		cairo_text_extents_t extents;
+		cairo_scaled_font_glyph_extents (scaledFont, &glyph, 1, &extents);
+		result = {};
+		if (extents.width <= 0. || extents.height <= 0.)
+			return Result::Success;
+
+		auto scale = key.scale;
+		auto offset = static_cast<double> (key.subpixel) / kNumSubpixelPositions;
+		result.left = static_cast<int> (std::floor (extents.x_bearing * scale + offset)) - 1;
+		result.top = static_cast<int> (std::floor (extents.y_bearing * scale)) - 1;
+		result.width = static_cast<int> (std::ceil (
+						   (extents.x_bearing + extents.width) * scale + offset)) + 1 - result.left;
+		result.height = static_cast<int> (std::ceil (
+							(extents.y_bearing + extents.height) * scale)) + 1 - result.top;
+		if (result.width > kAtlasSize || result.height > kAtlasSize)
+			return Result::Failed;
+		if (!allocate (result))
+			return Result::AtlasFull;
+
+		cairo_t* context = atlasContext;
+		cairo_save (context);
+		cairo_rectangle (context, result.x, result.y, result.width, result.height);
+		cairo_clip (context);
+		cairo_translate (context, result.x - result.left + offset, result.y - result.top);
+		cairo_scale (context, scale, scale);
+		cairo_set_scaled_font (context, scaledFont);
+		cairo_show_glyphs (context, &glyph, 1);
+		cairo_restore (context);
+		cairo_surface_flush (atlas);
+		return Result::Success;
+	}
+
+	//------------------------------------------------------------------------
+	Result lookup (const GlyphKey& key, cairo_scaled_font_t* scaledFont, Glyph& glyph)
+	{
+		auto it = glyphs.find (key);
+		if (it != glyphs.end ())
+		{
+			++stats.hits;
+			glyph = it->second;
+			return Result::Success;
+		}
+		auto result = rasterize (key, scaledFont, glyph);
+		if (result == Result::Success)
+		{
+			++stats.misses;
+			glyphs.emplace (key, glyph);
+		}
+		return result;
+	}
+
+	//------------------------------------------------------------------------
+	Result collectQuads (PangoLayoutLine* line, double x, double y, double scale)
+	{
+		quads.clear ();
+		int penX = 0;
+		for (auto run = line->runs; run; run = run->next)
+		{
+			auto glyphItem = static_cast<PangoGlyphItem*> (run->data);
+			auto font = glyphItem->item->analysis.font;
+			if (!font || (glyphItem->item->analysis.level & 1))
+				return Result::Failed;
+			auto scaledFont = getScaledFont (font, scale);
+			if (!scaledFont)
+				return Result::Failed;
+			auto glyphString = glyphItem->glyphs;
+			for (auto i = 0; i < glyphString->num_glyphs; ++i)
+			{
+				const auto& info = glyphString->glyphs[i];
+				if (info.glyph & PANGO_GLYPH_UNKNOWN_FLAG)
+					return Result::Failed;
+				if (info.glyph != PANGO_GLYPH_EMPTY)
+				{
+					auto gx = x + pango_units_to_double (penX + info.geometry.x_offset) * scale;
+					auto gy = y + pango_units_to_double (info.geometry.y_offset) * scale;
+					auto ix = static_cast<int> (std::floor (gx));
+					auto subpixel =
+						static_cast<uint32_t> (std::lround ((gx - ix) * kNumSubpixelPositions));
+					if (subpixel == kNumSubpixelPositions)
+					{
+						++ix;
+						subpixel = 0;
+					}
+					Glyph glyph;
+					auto result = lookup ({font, scale, info.glyph, subpixel}, scaledFont, glyph);
+					if (result != Result::Success)
+						return result;
+					if (glyph.width)
+						quads.push_back ({glyph, ix + glyph.left,
+										  static_cast<int> (std::lround (gy)) + glyph.top});
+				}
+				penX += info.geometry.width;
+			}
+		}
+		return Result::Success;
+	}
+
+	//------------------------------------------------------------------------
+	bool prepareScratch (int width, int height)
+	{
+		if (scratch && width <= scratchWidth && height <= scratchHeight)
+			return true;
+		if (width > kMaxScratchSize || height > kMaxScratchSize)
+			return false;
+		scratchWidth = std::max ({width, scratchWidth, 256});
+		scratchHeight = std::max ({height, scratchHeight, 64});
+		scratch.assign (cairo_image_surface_create (CAIRO_FORMAT_A8, scratchWidth, scratchHeight));
+		if (cairo_surface_status (scratch) != CAIRO_STATUS_SUCCESS)
+		{
+			scratch.reset ();
+			scratchWidth = scratchHeight = 0;
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------------------------------------------------
+	/** add the coverage of all glyphs into the scratch surface and mask the current source with
+	 *	it, the scratch surface is cleared again afterwards
+	 */
+	bool composite (cairo_t* context, double deviceScale)
+	{
+		if (quads.empty ())
+			return true;
+		int left = INT_MAX;
+		int top = INT_MAX;
+		int right = INT_MIN;
+		int bottom = INT_MIN;
+		for (const auto& quad : quads)
+		{
+			left = std::min (left, quad.x);
+			top = std::min (top, quad.y);
+			right = std::max (right, quad.x + quad.glyph.width);
+			bottom = std::max (bottom, quad.y + quad.glyph.height);
+		}
+		auto width = right - left;
+		auto height = bottom - top;
+		if (!prepareScratch (width, height))
+			return false;
+
+		cairo_surface_flush (scratch);
+		auto dst = cairo_image_surface_get_data (scratch);
+		auto dstStride = cairo_image_surface_get_stride (scratch);
+		auto src = cairo_image_surface_get_data (atlas);
+		auto srcStride = cairo_image_surface_get_stride (atlas);
+		for (const auto& quad : quads)
+		{
+			for (auto row = 0; row < quad.glyph.height; ++row)
+			{
+				auto s = src + (quad.glyph.y + row) * srcStride + quad.glyph.x;
+				auto d = dst + (quad.y - top + row) * dstStride + (quad.x - left);
+				for (auto col = 0; col < quad.glyph.width; ++col)
+					d[col] = static_cast<uint8_t> (std::min (255, d[col] + s[col]));
+			}
+		}
+		cairo_surface_mark_dirty (scratch);
+
+		cairo_save (context);
+		cairo_identity_matrix (context);
+		cairo_scale (context, 1. / deviceScale, 1. / deviceScale);
+		double maskX = left;
+		double maskY = top;
+		cairo_device_to_user (context, &maskX, &maskY);
+		cairo_mask_surface (context, scratch, maskX, maskY);
+		cairo_restore (context);
+
+		cairo_surface_flush (scratch);
+		for (auto row = 0; row < height; ++row)
+			memset (dst + row * dstStride, 0, width);
+		cairo_surface_mark_dirty (scratch);
+		return true;
+	}
+
+	//------------------------------------------------------------------------
+	/** fonts with the default antialias mode get it from the target surface, which may want
+	 *	subpixel antialiasing
+	 */
+	static bool hasCoverageFontOptions (cairo_t* context)
+	{
+		auto options = cairo_font_options_create ();
+		cairo_surface_get_font_options (cairo_get_target (context), options);
+		auto antialias = cairo_font_options_get_antialias (options);
+		cairo_font_options_destroy (options);
+		return antialias != CAIRO_ANTIALIAS_SUBPIXEL;
+	}
+
+	//------------------------------------------------------------------------
+	bool draw (cairo_t* context, PangoLayout* layout, CPoint pos)
+	{
+		if (pango_layout_get_attributes (layout) || pango_layout_get_line_count (layout) != 1 ||
+			!isSimpleText (pango_layout_get_text (layout)))
+			return false;
+		auto line = pango_layout_get_line_readonly (layout, 0);
+		if (!line)
+			return false;
+
+		// only translations and uniform scaling keep the glyphs on the pixel grid
+		cairo_matrix_t matrix;
+		cairo_get_matrix (context, &matrix);
+		if (matrix.xy != 0. || matrix.yx != 0. || matrix.xx != matrix.yy || matrix.xx <= 0.)
+			return false;
+		double deviceScaleX = 1.;
+		double deviceScaleY = 1.;
+		cairo_surface_get_device_scale (cairo_get_group_target (context), &deviceScaleX,
+										&deviceScaleY);
+		if (deviceScaleX != deviceScaleY)
+			return false;
+		if (!hasCoverageFontOptions (context))
+			return false;
+		auto scale = matrix.xx * deviceScaleX;
+
+		double x = pos.x;
+		double y = pos.y + pango_units_to_double (pango_layout_get_baseline (layout));
+		cairo_user_to_device (context, &x, &y);
+
+		if (!init ())
+			return false;
+		auto result = collectQuads (line, x, y, scale);
+		if (result == Result::AtlasFull)
+		{
+			++stats.resets;
+			reset ();
+			result = collectQuads (line, x, y, scale);
+		}
+		if (result != Result::Success)
+			return false;
+		return composite (context, deviceScaleX);
+	}
+};
+
+//------------------------------------------------------------------------
+GlyphAtlas& GlyphAtlas::instance ()
+{
+	static GlyphAtlas gInstance;
+	return gInstance;
+}
+
+//------------------------------------------------------------------------
+void GlyphAtlas::setEnabled (bool state)
+{
+	gGlyphAtlasEnabled.store (state, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+bool GlyphAtlas::isEnabled ()
+{
+	return gGlyphAtlasEnabled.load (std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+GlyphAtlas::GlyphAtlas () { impl = std::make_unique<Impl> (); }
+
+//------------------------------------------------------------------------
+GlyphAtlas::~GlyphAtlas () noexcept = default;
+
+//------------------------------------------------------------------------
+bool GlyphAtlas::drawLayout (cairo_t* context, void* pangoLayout, CPoint pos)
+{
+	std::lock_guard<std::mutex> guard (impl->mutex);
+	if (impl->draw (context, reinterpret_cast<PangoLayout*> (pangoLayout), pos))
+		return true;
+	++impl->stats.fallbacks;
+	return false;
+}
+
+//------------------------------------------------------------------------
+auto GlyphAtlas::getStatistics () const -> Statistics
+{
+	std::lock_guard<std::mutex> guard (impl->mutex);
+	auto result = impl->stats;
+	result.numGlyphs = impl->glyphs.size ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+void GlyphAtlas::clear ()
+{
+	std::lock_guard<std::mutex> guard (impl->mutex);
+	impl->reset ();
+	impl->scratch.reset ();
+	impl->scratchWidth = impl->scratchHeight = 0;
+}
+
+//------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
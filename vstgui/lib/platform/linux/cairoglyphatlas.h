@@ -0,0 +1,72 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cairoutils.h"
+#include "../../cpoint.h"
+#include <cstdint>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Cairo {
+
+//-----------------------------------------------------------------------------
+/** Cache of pre-rasterized glyphs
+ *
+ *	Glyphs are rasterized once per font, glyph, scale factor and subpixel offset into an alpha
+ *	only image surface. Single line text layouts of simple scripts are then drawn by compositing
+ *	the cached glyphs, all other layouts are left to Pango. Glyphs are rasterized with gray or
+ *	without antialiasing like the font options of the layout, fonts and targets which use
+ *	subpixel antialiasing are left to Pango too.
+ *
+ *	The atlas is disabled by default, see LinuxFactory::setGlyphAtlasEnabled.
+ */
+class GlyphAtlas
+{
+public:
+	struct Statistics
+	{
+		/** number of glyphs drawn from the atlas */
+		uint64_t hits {0};
+		/** number of glyphs rasterized into the atlas */
+		uint64_t misses {0};
+		/** number of layouts which had to be drawn by Pango */
+		uint64_t fallbacks {0};
+		/** number of times the atlas was full and had to be cleared */
+		uint64_t resets {0};
+		/** number of glyphs currently in the atlas */
+		size_t numGlyphs {0};
+	};
+
+	static GlyphAtlas& instance ();
+
+	static void setEnabled (bool state);
+	static bool isEnabled ();
+
+	/** draw the pango layout at pos with the current source of the context
+	 *
+	 *	@param context cairo context with the clip and transform matrix already applied
+	 *	@param pangoLayout the pango layout
+	 *	@param pos position of the top left corner of the layout in user space
+	 *	@return false if the layout cannot be drawn via the atlas
+	 */
+	bool drawLayout (cairo_t* context, void* pangoLayout, CPoint pos);
+
+	Statistics getStatistics () const;
+	void clear ();
+
+	~GlyphAtlas () noexcept;
+
+private:
+	GlyphAtlas ();
+
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+};
+
+//-----------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
@@ -19,27 +19,46 @@ void Gradient::changed ()
 {
 	linearGradient.reset ();
 	radialGradient.reset ();
+	degeneratedGradient.reset ();
+}
+
+//------------------------------------------------------------------------
+PatternHandle Gradient::createPattern (cairo_pattern_t* pattern) const
+{
+	for (auto& it : getColorStops ())
+	{
+		cairo_pattern_add_color_stop_rgba (pattern, it.first, it.second.normRed<double> (),
+										   it.second.normGreen<double> (),
+										   it.second.normBlue<double> (),
+										   it.second.normAlpha<double> ());
+	}
+	return PatternHandle (pattern);
 }
 
 //------------------------------------------------------------------------
 const PatternHandle& Gradient::getLinearGradient (CPoint start, CPoint end) const
 {
-	if (!linearGradient || start != linearGradientStart || end != linearGradientEnd)
+	auto delta = end - start;
+	auto lengthSquared = delta.x * delta.x + delta.y * delta.y;
+	if (lengthSquared == 0.)
 	{
-		linearGradient.reset ();
-		radialGradient.reset ();
-		linearGradientStart = start;
-		linearGradientEnd = end;
-		linearGradient =
-			PatternHandle (cairo_pattern_create_linear (start.x, start.y, end.x, end.y));
-		for (auto& it : getColorStops ())
-		{
-			cairo_pattern_add_color_stop_rgba (
-			    linearGradient, it.first, it.second.normRed<double> (),
-			    it.second.normGreen<double> (), it.second.normBlue<double> (),
-			    it.second.normAlpha<double> ());
-		}
+		// no invertible matrix for this one
+		degeneratedGradient =
+			createPattern (cairo_pattern_create_linear (start.x, start.y, end.x, end.y));
+		return degeneratedGradient;
 	}
+	if (!linearGradient)
+		linearGradient = createPattern (cairo_pattern_create_linear (0., 0., 1., 0.));
+
+	// maps start to (0, 0) and end to (1, 0)
+	cairo_matrix_t matrix;
+	matrix.xx = delta.x / lengthSquared;
+	matrix.xy = delta.y / lengthSquared;
+	matrix.x0 = -(start.x * delta.x + start.y * delta.y) / lengthSquared;
+	matrix.yx = -delta.y / lengthSquared;
+	matrix.yy = delta.x / lengthSquared;
+	matrix.y0 = (start.x * delta.y - start.y * delta.x) / lengthSquared;
+	cairo_pattern_set_matrix (linearGradient, &matrix);
 	return linearGradient;
 }
 
@@ -47,21 +66,32 @@ const PatternHandle& Gradient::getLinearGradient (CPoint start, CPoint end) cons
 const PatternHandle& Gradient::getRadialGradient (CPoint center, CCoord radius,
 												  CPoint originOffset) const
 {
-	if (!radialGradient)
+	if (radius <= 0.)
 	{
-		radialGradient = PatternHandle (
-			cairo_pattern_create_radial (center.x, center.y, 0., center.x, center.y, radius));
+		// no invertible matrix for this one
+		auto origin = center + originOffset;
+		degeneratedGradient = createPattern (cairo_pattern_create_radial (
+			origin.x, origin.y, 0., center.x, center.y, radius));
+		return degeneratedGradient;
+	}
 
-		for (auto& it : getColorStops ())
-		{
-			cairo_pattern_add_color_stop_rgba (
-				radialGradient, it.first, it.second.normRed<double> (),
-				it.second.normGreen<double> (), it.second.normBlue<double> (),
-				it.second.normAlpha<double> ());
-		}
+	// the origin is the only geometry which cannot be expressed by the matrix
+	CPoint origin (originOffset.x / radius, originOffset.y / radius);
+	if (!radialGradient || origin != radialGradientOrigin)
+	{
+		radialGradient =
+			createPattern (cairo_pattern_create_radial (origin.x, origin.y, 0., 0., 0., 1.));
+		radialGradientOrigin = origin;
 	}
+
+	// maps the circle to the unit circle
+	cairo_matrix_t matrix;
+	cairo_matrix_init_scale (&matrix, 1. / radius, 1. / radius);
+	cairo_matrix_translate (&matrix, -center.x, -center.y);
+	cairo_pattern_set_matrix (radialGradient, &matrix);
 	return radialGradient;
 }
+
 //------------------------------------------------------------------------
 } // Cairo
 } // VSTGUI
@@ -19,19 +19,23 @@ class Gradient : public PlatformGradientBase
 public:
 	~Gradient () noexcept override;
 
+	/** the returned pattern is shared by all calls, only its matrix is adjusted to the geometry.
+	 *	Use it before calling again.
+	 */
 	const PatternHandle& getLinearGradient (CPoint start, CPoint end) const;
 	const PatternHandle& getRadialGradient (CPoint center, CCoord radius,
 											CPoint originOffset) const;
 
 private:
 	void changed () override;
+	PatternHandle createPattern (cairo_pattern_t* pattern) const;
 
-	/* we want to calculate a normalized linear and radial gradiant */
+	/* the gradients are created in unit space and mapped to the geometry via the pattern matrix */
 	mutable PatternHandle linearGradient;
 	mutable PatternHandle radialGradient;
+	mutable PatternHandle degeneratedGradient;
 
-	mutable CPoint linearGradientStart;
-	mutable CPoint linearGradientEnd;
+	mutable CPoint radialGradientOrigin;
 };
 
 //------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 #include "cairobitmap.h"
 #include "cairopath.h"
 #include "cairogradient.h"
+#include "cairoglyphatlas.h"
+#include "../../cbitmap.h"
 #include "../../crect.h"
 #include "../../cgraphicstransform.h"
 #include "../../ccolor.h"
@@ -13,6 +15,7 @@
 #include "../../clinestyle.h"
 
 #include <pango/pangocairo.h>
+#include <array>
 #include <stack>
 
 //------------------------------------------------------------------------
@@ -39,6 +42,26 @@ inline cairo_matrix_t convert (const TransformMatrix& ct)
 	return {ct.m11, ct.m21, ct.m12, ct.m22, ct.dx, ct.dy};
 }
 
+//------------------------------------------------------------------------
+inline cairo_filter_t convert (BitmapInterpolationQuality quality)
+{
+	switch (quality)
+	{
+		case BitmapInterpolationQuality::kLow: return CAIRO_FILTER_NEAREST;
+		case BitmapInterpolationQuality::kMedium: return CAIRO_FILTER_BILINEAR;
+		case BitmapInterpolationQuality::kHigh: return CAIRO_FILTER_BEST;
+		case BitmapInterpolationQuality::kDefault: break;
+	}
+	return CAIRO_FILTER_GOOD;
+}
+
+//------------------------------------------------------------------------
+inline bool isEqual (const cairo_matrix_t& m1, const cairo_matrix_t& m2)
+{
+	return m1.xx == m2.xx && m1.yx == m2.yx && m1.xy == m2.xy && m1.yy == m2.yy &&
+		   m1.x0 == m2.x0 && m1.y0 == m2.y0;
+}
+
 //-----------------------------------------------------------------------------
 struct CairoGraphicsDeviceFactory::Impl
 {
@@ -124,7 +147,9 @@ PlatformGraphicsDeviceContextPtr
 	auto cairoBitmap = bitmap.cast<Cairo::Bitmap> ();
 	if (cairoBitmap)
 	{
-		return std::make_shared<CairoGraphicsDeviceContext> (*this, cairoBitmap->getSurface ());
+		cairoBitmap->setIsRenderTarget ();
+		return std::make_shared<CairoGraphicsDeviceContext> (*this, cairoBitmap->getSurface (),
+															 cairoBitmap->getScaleFactor ());
 	}
 	return nullptr;
 }
@@ -169,28 +194,128 @@ struct CairoGraphicsDeviceContext::Impl
 	template<typename Proc>
 	void doInContext (Proc p)
 	{
-		auto ct = state.tm;
-		CRect clip = state.clip;
-		if (clip.isEmpty ())
+		if (state.clip.isEmpty ())
 			return;
-		cairo_save (context);
+		// without diffing every primitive is wrapped in cairo_save/cairo_restore with the
+		// complete state set, like before the state was tracked
+		if (!stateDiffing)
+		{
+			cairo_save (context);
+			applied = {};
+		}
+		applyClip ();
+		applyMatrix (convert (state.tm));
+		applyAntialias (state.drawMode.modeIgnoringIntegralMode () == kAntiAliasing
+							? CAIRO_ANTIALIAS_BEST
+							: CAIRO_ANTIALIAS_NONE);
+		p ();
+		checkCairoStatus (context);
+		if (!stateDiffing)
+		{
+			cairo_restore (context);
+			applied = {};
+		}
+	}
+
+	void applyClip ()
+	{
+		if (applied.clipValid && applied.clip == state.clip)
+			return;
+		const auto& clip = state.clip;
+		cairo_reset_clip (context);
+		cairo_identity_matrix (context);
 		cairo_rectangle (context, clip.left, clip.top, clip.getWidth (), clip.getHeight ());
 		cairo_clip (context);
-		auto matrix = convert (ct);
+		applied.clip = clip;
+		applied.clipValid = true;
+		applied.matrixValid = false;
+	}
+
+	void applyMatrix (const cairo_matrix_t& matrix)
+	{
+		if (applied.matrixValid && isEqual (applied.matrix, matrix))
+			return;
 		cairo_set_matrix (context, &matrix);
-		auto antialiasMode = state.drawMode.modeIgnoringIntegralMode () == kAntiAliasing
-								 ? CAIRO_ANTIALIAS_BEST
-								 : CAIRO_ANTIALIAS_NONE;
-		cairo_set_antialias (context, antialiasMode);
-		p ();
-		checkCairoStatus (context);
+		applied.matrix = matrix;
+		applied.matrixValid = true;
+	}
+
+	void applyAntialias (cairo_antialias_t antialias)
+	{
+		if (applied.antialiasValid && applied.antialias == antialias)
+			return;
+		cairo_set_antialias (context, antialias);
+		applied.antialias = antialias;
+		applied.antialiasValid = true;
+	}
+
+	void setSource (cairo_pattern_t* pattern)
+	{
+		cairo_set_source (context, pattern);
+		applied.sourceValid = false;
+	}
+
+	void fill (bool evenOdd)
+	{
+		if (evenOdd)
+		{
+			cairo_set_fill_rule (context, CAIRO_FILL_RULE_EVEN_ODD);
+			cairo_fill (context);
+			cairo_set_fill_rule (context, CAIRO_FILL_RULE_WINDING);
+		}
+		else
+		{
+			cairo_fill (context);
+		}
+	}
+
+	void fillWithAlpha (double alpha)
+	{
+		if (alpha == 1.)
+		{
+			cairo_fill (context);
+			return;
+		}
+		cairo_save (context);
+		cairo_clip (context);
+		cairo_paint_with_alpha (context, alpha);
 		cairo_restore (context);
 	}
 
+	/** fill dst with tiles of the src part of the surface, src is in bitmap coordinates */
+	void fillWithTiledSurface (cairo_surface_t* surface, double bitmapScaleFactor, CRect src,
+							   CRect dst, double alpha, cairo_filter_t filter)
+	{
+		if (src.isEmpty () || dst.isEmpty ())
+			return;
+		Cairo::SurfaceHandle subSurface (cairo_surface_create_for_rectangle (
+			surface, src.left * bitmapScaleFactor, src.top * bitmapScaleFactor,
+			src.getWidth () * bitmapScaleFactor, src.getHeight () * bitmapScaleFactor));
+		Cairo::PatternHandle pattern (cairo_pattern_create_for_surface (subSurface));
+		cairo_pattern_set_extend (pattern, CAIRO_EXTEND_REPEAT);
+		cairo_pattern_set_filter (pattern, filter);
+		cairo_matrix_t matrix;
+		cairo_matrix_init_scale (&matrix, bitmapScaleFactor, bitmapScaleFactor);
+		cairo_matrix_translate (&matrix, -dst.left, -dst.top);
+		cairo_pattern_set_matrix (pattern, &matrix);
+		setSource (pattern);
+		cairo_rectangle (context, dst.left, dst.top, dst.getWidth (), dst.getHeight ());
+		fillWithAlpha (alpha);
+	}
+
+	/** true if the transform matrix only applies the backing scale factor and translates */
+	bool isBackingScaleTransform () const
+	{
+		const auto& tm = state.tm;
+		return tm.m12 == 0. && tm.m21 == 0. && tm.m11 == scaleFactor && tm.m22 == scaleFactor;
+	}
+
 	void applyLineWidthCTM ()
 	{
 		auto p = calcLineTranslate ();
-		cairo_translate (context, p.x, p.y);
+		auto matrix = convert (state.tm);
+		cairo_matrix_translate (&matrix, p.x, p.y);
+		applyMatrix (matrix);
 	}
 
 	CPoint calcLineTranslate () const
@@ -205,8 +330,13 @@ struct CairoGraphicsDeviceContext::Impl
 	void applyLineStyle ()
 	{
 		auto lineWidth = state.lineWidth;
-		cairo_set_line_width (context, lineWidth);
 		const auto& style = state.lineStyle;
+		if (applied.lineStyleValid && applied.lineWidth == lineWidth && applied.lineStyle == style)
+			return;
+		applied.lineWidth = lineWidth;
+		applied.lineStyle = style;
+		applied.lineStyleValid = true;
+		cairo_set_line_width (context, lineWidth);
 		if (!style.getDashLengths ().empty ())
 		{
 			auto lengths = style.getDashLengths ();
@@ -214,6 +344,10 @@ struct CairoGraphicsDeviceContext::Impl
 				l *= lineWidth;
 			cairo_set_dash (context, lengths.data (), lengths.size (), style.getDashPhase ());
 		}
+		else
+		{
+			cairo_set_dash (context, nullptr, 0, 0.);
+		}
 		cairo_line_cap_t lineCap;
 		switch (style.getLineCap ())
 		{
@@ -259,10 +393,14 @@ struct CairoGraphicsDeviceContext::Impl
 
 	void setupSourceColor (CColor color)
 	{
-		auto alpha = color.normAlpha<double> ();
-		alpha *= state.globalAlpha;
-		cairo_set_source_rgba (context, color.normRed<double> (), color.normGreen<double> (),
-							   color.normBlue<double> (), alpha);
+		std::array<double, 4> rgba {color.normRed<double> (), color.normGreen<double> (),
+									color.normBlue<double> (),
+									color.normAlpha<double> () * state.globalAlpha};
+		if (applied.sourceValid && applied.sourceColor == rgba)
+			return;
+		cairo_set_source_rgba (context, rgba[0], rgba[1], rgba[2], rgba[3]);
+		applied.sourceColor = rgba;
+		applied.sourceValid = true;
 		checkCairoStatus (context);
 	}
 	void applyFillColor () { setupSourceColor (state.fillColor); }
@@ -312,6 +450,31 @@ struct CairoGraphicsDeviceContext::Impl
 	};
 	State state;
 	std::stack<State> stateStack;
+
+	/** the part of the cairo state which was set by the last primitives
+	 *
+	 *	The primitives don't save and restore the cairo state, only the parts which differ from the
+	 *	requested state are set. Parts which are not valid are set unconditionally.
+	 */
+	struct AppliedState
+	{
+		CRect clip;
+		cairo_matrix_t matrix {};
+		cairo_antialias_t antialias {CAIRO_ANTIALIAS_DEFAULT};
+		CLineStyle lineStyle;
+		CCoord lineWidth {1.};
+		std::array<double, 4> sourceColor {};
+		bool clipValid {false};
+		bool matrixValid {false};
+		bool antialiasValid {false};
+		bool lineStyleValid {false};
+		bool sourceValid {false};
+	};
+	AppliedState applied;
+	std::stack<AppliedState> appliedStack;
+
+	bool drawsOnWorkerThread {false};
+	bool stateDiffing {true};
 	double scaleFactor {1.};
 
 	PlatformGraphicsPathFactoryPtr pathFactory;
@@ -319,9 +482,11 @@ struct CairoGraphicsDeviceContext::Impl
 
 //------------------------------------------------------------------------
 CairoGraphicsDeviceContext::CairoGraphicsDeviceContext (const CairoGraphicsDevice& device,
-														const Cairo::SurfaceHandle& handle)
+														const Cairo::SurfaceHandle& handle,
+														double scaleFactor)
 {
 	impl = std::make_unique<Impl> (device, handle);
+	impl->scaleFactor = scaleFactor;
 }
 
 //------------------------------------------------------------------------
@@ -346,6 +511,7 @@ bool CairoGraphicsDeviceContext::beginDraw () const
 {
 	if (impl->context)
 		cairo_save (impl->context);
+	impl->applied = {};
 	return true;
 }
 
@@ -354,6 +520,7 @@ bool CairoGraphicsDeviceContext::endDraw () const
 {
 	if (impl->context)
 		cairo_restore (impl->context);
+	impl->applied = {};
 	if (impl->surface)
 		cairo_surface_flush (impl->surface);
 	return true;
@@ -469,8 +636,10 @@ bool CairoGraphicsDeviceContext::drawArc (CRect rect, double startAngle1, double
 {
 	impl->doInContext ([&] () {
 		CPoint center = rect.getCenter ();
-		cairo_translate (impl->context, center.x, center.y);
-		cairo_scale (impl->context, 2.0 / rect.getWidth (), 2.0 / rect.getHeight ());
+		auto matrix = convert (impl->state.tm);
+		cairo_matrix_translate (&matrix, center.x, center.y);
+		cairo_matrix_scale (&matrix, 2.0 / rect.getWidth (), 2.0 / rect.getHeight ());
+		impl->applyMatrix (matrix);
 		cairo_arc (impl->context, 0, 0, 1, startAngle1, endAngle2);
 		impl->draw (drawStyle);
 	});
@@ -482,8 +651,10 @@ bool CairoGraphicsDeviceContext::drawEllipse (CRect rect, PlatformGraphicsDrawSt
 {
 	impl->doInContext ([&] () {
 		CPoint center = rect.getCenter ();
-		cairo_translate (impl->context, center.x, center.y);
-		cairo_scale (impl->context, 2.0 / rect.getWidth (), 2.0 / rect.getHeight ());
+		auto matrix = convert (impl->state.tm);
+		cairo_matrix_translate (&matrix, center.x, center.y);
+		cairo_matrix_scale (&matrix, 2.0 / rect.getWidth (), 2.0 / rect.getHeight ());
+		impl->applyMatrix (matrix);
 		cairo_arc (impl->context, 0, 0, 1, 0, 2 * M_PI);
 		impl->draw (drawStyle);
 	});
@@ -500,33 +671,33 @@ bool CairoGraphicsDeviceContext::drawBitmap (IPlatformBitmap& bitmap, CRect dest
 	auto cairoBitmap = dynamic_cast<Cairo::Bitmap*> (&bitmap);
 	if (!cairoBitmap)
 		return false;
+	auto filter = convert (quality);
 	impl->doInContext ([&] () {
-		cairo_translate (impl->context, dest.left, dest.top);
-		cairo_rectangle (impl->context, 0, 0, dest.getWidth (), dest.getHeight ());
-		cairo_clip (impl->context);
-
-		// Setup a pattern for scaling bitmaps and take it as source afterwards.
-		auto pattern = cairo_pattern_create_for_surface (cairoBitmap->getSurface ());
+		// Bitmaps which don't match the backing scale factor are resampled once and then drawn 1:1,
+		// if no other scaling is applied by the user transform. Otherwise setup a pattern for
+		// scaling bitmaps and take it as source afterwards, so that Cairo filters the transform.
+		cairo_surface_t* surface = cairoBitmap->getSurface ();
+		auto patternScaleFactor = cairoBitmap->getScaleFactor ();
+		if (impl->scaleFactor != patternScaleFactor && impl->isBackingScaleTransform () &&
+			!impl->drawsOnWorkerThread)
+		{
+			if (const auto& scaledSurface =
+					cairoBitmap->getScaledSurface (impl->scaleFactor, filter))
+			{
+				surface = scaledSurface;
+				patternScaleFactor = impl->scaleFactor;
+			}
+		}
+		Cairo::PatternHandle pattern (cairo_pattern_create_for_surface (surface));
+		cairo_pattern_set_filter (pattern, filter);
 		cairo_matrix_t matrix;
-		cairo_pattern_get_matrix (pattern, &matrix);
-		cairo_matrix_init_scale (&matrix, cairoBitmap->getScaleFactor (),
-								 cairoBitmap->getScaleFactor ());
-		cairo_matrix_translate (&matrix, offset.x, offset.y);
+		cairo_matrix_init_scale (&matrix, patternScaleFactor, patternScaleFactor);
+		cairo_matrix_translate (&matrix, offset.x - dest.left, offset.y - dest.top);
 		cairo_pattern_set_matrix (pattern, &matrix);
-		cairo_set_source (impl->context, pattern);
+		impl->setSource (pattern);
 
-		cairo_rectangle (impl->context, -offset.x, -offset.y, dest.getWidth () + offset.x,
-						 dest.getHeight () + offset.y);
-		alpha *= impl->state.globalAlpha;
-		if (alpha != 1.f)
-		{
-			cairo_paint_with_alpha (impl->context, alpha);
-		}
-		else
-		{
-			cairo_fill (impl->context);
-		}
-		cairo_pattern_destroy (pattern);
+		cairo_rectangle (impl->context, dest.left, dest.top, dest.getWidth (), dest.getHeight ());
+		impl->fillWithAlpha (alpha * impl->state.globalAlpha);
 	});
 	return true;
 }
@@ -538,6 +709,7 @@ bool CairoGraphicsDeviceContext::clearRect (CRect rect) const
 		cairo_set_operator (impl->context, CAIRO_OPERATOR_CLEAR);
 		cairo_rectangle (impl->context, rect.left, rect.top, rect.getWidth (), rect.getHeight ());
 		cairo_fill (impl->context);
+		cairo_set_operator (impl->context, CAIRO_OPERATOR_OVER);
 	});
 	return true;
 }
@@ -562,12 +734,11 @@ bool CairoGraphicsDeviceContext::drawGraphicsPath (IPlatformGraphicsPath& path,
 		auto p = alignedPath ? alignedPath->getCairoPath () : cairoPath->getCairoPath ();
 		if (transformation)
 		{
-			cairo_matrix_t currentMatrix;
 			cairo_matrix_t resultMatrix;
 			auto matrix = convert (*transformation);
-			cairo_get_matrix (impl->context, &currentMatrix);
+			auto currentMatrix = convert (impl->state.tm);
 			cairo_matrix_multiply (&resultMatrix, &matrix, &currentMatrix);
-			cairo_set_matrix (impl->context, &resultMatrix);
+			impl->applyMatrix (resultMatrix);
 		}
 		cairo_append_path (impl->context, p);
 		switch (mode)
@@ -581,8 +752,7 @@ bool CairoGraphicsDeviceContext::drawGraphicsPath (IPlatformGraphicsPath& path,
 			case PlatformGraphicsPathDrawMode::FilledEvenOdd:
 			{
 				impl->applyFillColor ();
-				cairo_set_fill_rule (impl->context, CAIRO_FILL_RULE_EVEN_ODD);
-				cairo_fill (impl->context);
+				impl->fill (true);
 				break;
 			}
 			case PlatformGraphicsPathDrawMode::Stroked:
@@ -621,10 +791,8 @@ bool CairoGraphicsDeviceContext::fillLinearGradient (IPlatformGraphicsPath& path
 		}
 		auto p = alignedPath ? alignedPath->getCairoPath () : cairoPath->getCairoPath ();
 		cairo_append_path (impl->context, p);
-		cairo_set_source (impl->context, cairoGradient->getLinearGradient (startPoint, endPoint));
-		if (evenOdd)
-			cairo_set_fill_rule (impl->context, CAIRO_FILL_RULE_EVEN_ODD);
-		cairo_fill (impl->context);
+		impl->setSource (cairoGradient->getLinearGradient (startPoint, endPoint));
+		impl->fill (evenOdd);
 	});
 	return true;
 }
@@ -657,12 +825,9 @@ bool CairoGraphicsDeviceContext::fillRadialGradient (IPlatformGraphicsPath& path
 
 		const auto& radialGradient =
 			cairoGradient->getRadialGradient (center, radius, originOffset);
-		cairo_set_source (impl->context, radialGradient);
-		if (evenOdd)
-			cairo_set_fill_rule (impl->context, CAIRO_FILL_RULE_EVEN_ODD);
-
+		impl->setSource (radialGradient);
 		cairo_arc (impl->context, 0, 0, 0, 0., M_PI * 2.);
-		cairo_fill (impl->context);
+		impl->fill (evenOdd);
 	});
 
 	return true;
@@ -673,6 +838,7 @@ void CairoGraphicsDeviceContext::saveGlobalState () const
 {
 	cairo_save (impl->context);
 	impl->stateStack.push (impl->state);
+	impl->appliedStack.push (impl->applied);
 }
 
 //------------------------------------------------------------------------
@@ -687,6 +853,8 @@ void CairoGraphicsDeviceContext::restoreGlobalState () const
 	cairo_restore (impl->context);
 	impl->state = impl->stateStack.top ();
 	impl->stateStack.pop ();
+	impl->applied = impl->appliedStack.top ();
+	impl->appliedStack.pop ();
 }
 
 //------------------------------------------------------------------------
@@ -735,7 +903,71 @@ void CairoGraphicsDeviceContext::setTransformMatrix (const TransformMatrix& tm)
 //------------------------------------------------------------------------
 const IPlatformGraphicsDeviceContextBitmapExt* CairoGraphicsDeviceContext::asBitmapExt () const
 {
-	return nullptr;
+	return this;
+}
+
+//------------------------------------------------------------------------
+bool CairoGraphicsDeviceContext::drawBitmapNinePartTiled (IPlatformBitmap& bitmap, CRect dest,
+														  const CNinePartTiledDescription& desc,
+														  double alpha,
+														  BitmapInterpolationQuality quality) const
+{
+	using NPTD = CNinePartTiledDescription;
+
+	auto cairoBitmap = dynamic_cast<Cairo::Bitmap*> (&bitmap);
+	if (!cairoBitmap)
+		return false;
+	alpha *= impl->state.globalAlpha;
+	if (alpha == 0.)
+		return true;
+
+	auto bitmapScaleFactor = cairoBitmap->getScaleFactor ();
+	CRect bitmapBounds (CPoint (), bitmap.getSize ());
+	bitmapBounds.setWidth (bitmapBounds.getWidth () / bitmapScaleFactor);
+	bitmapBounds.setHeight (bitmapBounds.getHeight () / bitmapScaleFactor);
+
+	std::array<CRect, NPTD::kPartCount> sourceRects;
+	std::array<CRect, NPTD::kPartCount> destRects;
+	auto filter = convert (quality);
+	desc.calcRects (bitmapBounds, sourceRects.data ());
+	desc.calcRects (dest, destRects.data ());
+
+	impl->doInContext ([&] () {
+		for (size_t i = 0; i < NPTD::kPartCount; ++i)
+			impl->fillWithTiledSurface (cairoBitmap->getSurface (), bitmapScaleFactor,
+										sourceRects[i], destRects[i], alpha, filter);
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool CairoGraphicsDeviceContext::fillRectWithBitmap (IPlatformBitmap& bitmap, CRect srcRect,
+													 CRect dstRect, double alpha,
+													 BitmapInterpolationQuality quality) const
+{
+	auto cairoBitmap = dynamic_cast<Cairo::Bitmap*> (&bitmap);
+	if (!cairoBitmap)
+		return false;
+	alpha *= impl->state.globalAlpha;
+	if (alpha == 0.)
+		return true;
+	impl->doInContext ([&] () {
+		impl->fillWithTiledSurface (cairoBitmap->getSurface (), cairoBitmap->getScaleFactor (),
+									srcRect, dstRect, alpha, convert (quality));
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------
+void CairoGraphicsDeviceContext::setDrawsOnWorkerThread (bool state) const
+{
+	impl->drawsOnWorkerThread = state;
+}
+
+//------------------------------------------------------------------------
+void CairoGraphicsDeviceContext::setStateDiffingEnabled (bool state) const
+{
+	impl->stateDiffing = state;
 }
 
 //------------------------------------------------------------------------
@@ -743,6 +975,9 @@ void CairoGraphicsDeviceContext::drawPangoLayout (void* layout, CPoint pos, CCol
 {
 	impl->doInContext ([&] () {
 		impl->applyFontColor (color);
+		if (Cairo::GlyphAtlas::isEnabled () &&
+			Cairo::GlyphAtlas::instance ().drawLayout (impl->context, layout, pos))
+			return;
 		cairo_move_to (impl->context, pos.x, pos.y);
 		pango_cairo_show_layout (impl->context, reinterpret_cast<PangoLayout*> (layout));
 	});
@@ -14,11 +14,13 @@ namespace VSTGUI {
 class CairoGraphicsDevice;
 
 //------------------------------------------------------------------------
-class CairoGraphicsDeviceContext : public IPlatformGraphicsDeviceContext
+class CairoGraphicsDeviceContext : public IPlatformGraphicsDeviceContext,
+								   public IPlatformGraphicsDeviceContextBitmapExt
 {
 public:
+	/** scaleFactor is the backing scale factor of the surface, the number of pixels per point */
 	CairoGraphicsDeviceContext (const CairoGraphicsDevice& device,
-								const Cairo::SurfaceHandle& handle);
+								const Cairo::SurfaceHandle& handle, double scaleFactor = 1.);
 	~CairoGraphicsDeviceContext () noexcept;
 
 	const IPlatformGraphicsDevice& getDevice () const override;
@@ -62,8 +64,21 @@ public:
 	// extension
 	const IPlatformGraphicsDeviceContextBitmapExt* asBitmapExt () const override;
 
+	// IPlatformGraphicsDeviceContextBitmapExt
+	bool drawBitmapNinePartTiled (IPlatformBitmap& bitmap, CRect dest,
+								  const CNinePartTiledDescription& desc, double alpha,
+								  BitmapInterpolationQuality quality) const override;
+	bool fillRectWithBitmap (IPlatformBitmap& bitmap, CRect srcRect, CRect dstRect, double alpha,
+							 BitmapInterpolationQuality quality) const override;
+
 	// private
 	void drawPangoLayout (void* layout, CPoint pos, CColor color) const;
+	/** the context draws on a worker thread, caches shared with other contexts are not used */
+	void setDrawsOnWorkerThread (bool state) const;
+	/** when disabled every primitive is drawn inside cairo_save/cairo_restore with the complete
+	 *	state set, used to verify the diffing
+	 */
+	void setStateDiffingEnabled (bool state) const;
 
 private:
 	struct Impl;
@@ -5,6 +5,7 @@
 #include "../../cgradient.h"
 #include "../../cgraphicstransform.h"
 #include "cairopath.h"
+#include "cairofont.h"
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -24,13 +25,21 @@ PlatformGraphicsPathPtr
 PlatformGraphicsPathPtr GraphicsPathFactory::createTextPath (const PlatformFontPtr& font,
 															 UTF8StringPtr text)
 {
-	return nullptr;
+	auto cairoFont = font.cast<Font> ();
+	if (!cairoFont || !text)
+		return nullptr;
+	auto path = std::make_unique<GraphicsPath> (context);
+	cairoFont->appendTextPath (context, text);
+	path->finishBuilding ();
+	return path;
 }
 
 //------------------------------------------------------------------------
 GraphicsPath::GraphicsPath (const ContextHandle& c) : context (c)
 {
 	cairo_save (context);
+	// the draw context leaves its transform matrix applied between primitives
+	cairo_identity_matrix (context);
 	cairo_new_path (context);
 }
 
@@ -165,6 +174,8 @@ bool GraphicsPath::hitTest (const CPoint& p, bool evenOddFilled,
 	if (transform)
 		transform->transform (tp);
 	cairo_save (context);
+	cairo_identity_matrix (context);
+	cairo_reset_clip (context);
 	cairo_new_path (context);
 	cairo_append_path (context, path);
 	cairo_set_fill_rule (context,
@@ -180,6 +191,7 @@ CRect GraphicsPath::getBoundingBox () const
 {
 	CRect r;
 	cairo_save (context);
+	cairo_identity_matrix (context);
 	cairo_new_path (context);
 	cairo_append_path (context, path);
 	CPoint p1, p2;
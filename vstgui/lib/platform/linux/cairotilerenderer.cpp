@@ -0,0 +1,216 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cairotilerenderer.h"
+#include "cairographicscontext.h"
+#include "../../cview.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Cairo {
+namespace {
+
+std::atomic<bool> gTileRendererEnabled {false};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+struct TileRenderer::Impl
+{
+	struct Tile
+	{
+		CRect rect;
+		SurfaceHandle surface;
+	};
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+	uint64_t generation {0};
+	size_t numFinishedThreads {0};
+	bool quit {false};
+
+	// the current job, only changed while the worker threads wait
+	std::vector<Tile> tiles;
+	std::atomic<size_t> nextTile {0};
+	const CairoGraphicsDevice* device {nullptr};
+	const DrawTileFunc* drawFunc {nullptr};
+
+	// the surfaces are kept for the next draw
+	std::vector<SurfaceHandle> surfaces;
+
+	~Impl () noexcept
+	{
+		{
+			std::lock_guard<std::mutex> guard (mutex);
+			quit = true;
+		}
+		workAvailable.notify_all ();
+		for (auto& thread : threads)
+			thread.join ();
+	}
+
+	void startThreads ()
+	{
+		auto numThreads = std::max (std::thread::hardware_concurrency (), 2u) - 1u;
+		for (auto i = 0u; i < numThreads; ++i)
+			threads.emplace_back ([this] () { workerLoop (); });
+	}
+
+	void workerLoop ()
+	{
+		uint64_t lastGeneration = 0;
+		std::unique_lock<std::mutex> lock (mutex);
+		while (true)
+		{
+			workAvailable.wait (lock, [&] () { return quit || generation != lastGeneration; });
+			if (quit)
+				return;
+			lastGeneration = generation;
+			lock.unlock ();
+			drawTiles ();
+			lock.lock ();
+			if (++numFinishedThreads == threads.size ())
+				workDone.notify_one ();
+		}
+	}
+
+	void run (const CairoGraphicsDevice& inDevice, const DrawTileFunc& inDrawFunc)
+	{
+		if (threads.empty ())
+			startThreads ();
+		device = &inDevice;
+		drawFunc = &inDrawFunc;
+		nextTile = 0;
+		{
+			std::lock_guard<std::mutex> guard (mutex);
+			numFinishedThreads = 0;
+			++generation;
+		}
+		workAvailable.notify_all ();
+		drawTiles ();
+		// all threads must be done before the job changes
+		std::unique_lock<std::mutex> lock (mutex);
+		workDone.wait (lock, [&] () { return numFinishedThreads == threads.size (); });
+	}
+
+	void drawTiles ()
+	{
+		while (true)
+		{
+			auto index = nextTile.fetch_add (1);
+			if (index >= tiles.size ())
+				break;
+			drawTile (tiles[index]);
+		}
+	}
+
+	void drawTile (const Tile& tile)
+	{
+		cairo_surface_set_device_offset (tile.surface, -tile.rect.left, -tile.rect.top);
+		{
+			ContextHandle clearContext (cairo_create (tile.surface));
+			cairo_set_operator (clearContext, CAIRO_OPERATOR_CLEAR);
+			cairo_paint (clearContext);
+		}
+		auto context = std::make_shared<CairoGraphicsDeviceContext> (*device, tile.surface);
+		context->setDrawsOnWorkerThread (true);
+		context->beginDraw ();
+		{
+			CView::ConcurrentDrawScope concurrentDrawScope;
+			(*drawFunc) (context, tile.rect);
+		}
+		context->endDraw ();
+		cairo_surface_flush (tile.surface);
+	}
+
+	const SurfaceHandle& getSurface (size_t index)
+	{
+		while (surfaces.size () <= index)
+		{
+			auto size = static_cast<int> (kTileSize);
+			surfaces.emplace_back (cairo_image_surface_create (CAIRO_FORMAT_ARGB32, size, size));
+		}
+		return surfaces[index];
+	}
+};
+
+//------------------------------------------------------------------------
+void TileRenderer::setEnabled (bool state)
+{
+	gTileRendererEnabled = state;
+}
+
+//------------------------------------------------------------------------
+bool TileRenderer::isEnabled ()
+{
+	return gTileRendererEnabled;
+}
+
+//------------------------------------------------------------------------
+bool TileRenderer::wantsTiles (const CRect& rect)
+{
+	// below four tiles the threads don't pay off
+	return rect.getWidth () * rect.getHeight () >= 4. * kTileSize * kTileSize;
+}
+
+//------------------------------------------------------------------------
+TileRenderer::TileRenderer ()
+{
+	impl = std::make_unique<Impl> ();
+}
+
+//------------------------------------------------------------------------
+TileRenderer::~TileRenderer () noexcept = default;
+
+//------------------------------------------------------------------------
+uint32_t TileRenderer::getNumThreads () const
+{
+	return static_cast<uint32_t> (impl->threads.size ()) + 1;
+}
+
+//------------------------------------------------------------------------
+void TileRenderer::draw (cairo_surface_t* target, const CairoGraphicsDevice& device,
+						 const CRect& rect, const DrawTileFunc& drawFunc)
+{
+	// tiles start on whole pixels so that they are composited without resampling
+	CRect area (std::floor (rect.left), std::floor (rect.top), std::ceil (rect.right),
+				std::ceil (rect.bottom));
+	impl->tiles.clear ();
+	for (auto top = area.top; top < area.bottom; top += kTileSize)
+	{
+		for (auto left = area.left; left < area.right; left += kTileSize)
+		{
+			CRect tileRect (left, top, std::min (left + kTileSize, area.right),
+							std::min (top + kTileSize, area.bottom));
+			impl->tiles.push_back ({tileRect, impl->getSurface (impl->tiles.size ())});
+		}
+	}
+	if (impl->tiles.empty ())
+		return;
+
+	impl->run (device, drawFunc);
+
+	ContextHandle context (cairo_create (target));
+	for (const auto& tile : impl->tiles)
+	{
+		cairo_set_source_surface (context, tile.surface, 0, 0);
+		cairo_rectangle (context, tile.rect.left, tile.rect.top, tile.rect.getWidth (),
+						 tile.rect.getHeight ());
+		cairo_fill (context);
+	}
+}
+
+//------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
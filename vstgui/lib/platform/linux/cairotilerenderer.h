@@ -0,0 +1,63 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cairoutils.h"
+#include "../../crect.h"
+#include "../iplatformgraphicsdevice.h"
+#include <functional>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+class CairoGraphicsDevice;
+
+namespace Cairo {
+
+//-----------------------------------------------------------------------------
+/** Draws large areas in tiles on worker threads
+ *
+ *	The area is split into tiles, every tile is drawn into its own image surface with its own
+ *	device context and the tiles are composited into the target surface afterwards.
+ *
+ *	Tiled drawing is disabled by default, see LinuxFactory::setTileParallelDrawingEnabled.
+ */
+class TileRenderer
+{
+public:
+	using DrawTileFunc =
+		std::function<void (const PlatformGraphicsDeviceContextPtr& context, const CRect& rect)>;
+
+	static constexpr CCoord kTileSize = 256.;
+
+	static void setEnabled (bool state);
+	static bool isEnabled ();
+
+	/** whether the rect is large enough to be drawn in tiles */
+	static bool wantsTiles (const CRect& rect);
+
+	TileRenderer ();
+	~TileRenderer () noexcept;
+
+	/** draw the rect in tiles and composite them into the target
+	 *
+	 *	@param target the surface to composite the tiles into
+	 *	@param device the graphics device for the tile contexts
+	 *	@param rect the area to draw in the coordinates of the target
+	 *	@param drawFunc called on worker threads and the calling thread for each tile
+	 */
+	void draw (cairo_surface_t* target, const CairoGraphicsDevice& device, const CRect& rect,
+			   const DrawTileFunc& drawFunc);
+
+	uint32_t getNumThreads () const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+};
+
+//-----------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
@@ -0,0 +1,424 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "headlessframe.h"
+#include "cairobitmap.h"
+#include "cairographicscontext.h"
+#include "cairotilerenderer.h"
+#include "x11platform.h"
+#include "../../cbitmap.h"
+#include "../../cframe.h"
+#include "../../cinvalidrectlist.h"
+#include "../../drawprofiler.h"
+#include "../../events.h"
+#include "../common/genericoptionmenu.h"
+#include "../common/generictextedit.h"
+#include "../iplatformopenglview.h"
+#include "../iplatformviewlayer.h"
+#include "../platformfactory.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+namespace {
+
+//------------------------------------------------------------------------
+/** runs the timers on a clock which only advances when asked to */
+class VirtualClockRunLoop
+: public IRunLoop
+, public AtomicReferenceCounted
+{
+public:
+	explicit VirtualClockRunLoop (uint64_t startTicks) : now (startTicks) {}
+
+	// there are no file descriptors without a server connection
+	bool registerEventHandler (int fd, IEventHandler* handler) final { return false; }
+	bool unregisterEventHandler (IEventHandler* handler) final { return false; }
+
+	bool registerTimer (uint64_t interval, ITimerHandler* handler) final
+	{
+		interval = std::max<uint64_t> (interval, 1u);
+		timers.push_back ({handler, interval, now + interval});
+		return true;
+	}
+
+	bool unregisterTimer (ITimerHandler* handler) final
+	{
+		auto it = std::find_if (timers.begin (), timers.end (),
+								[handler] (const auto& timer) { return timer.handler == handler; });
+		if (it == timers.end ())
+			return false;
+		timers.erase (it);
+		return true;
+	}
+
+	uint64_t getTicks () const { return now; }
+
+	void advance (uint64_t milliseconds)
+	{
+		auto end = now + milliseconds;
+		while (true)
+		{
+			// fire the timers in the order they are due, a timer which is due several times fires
+			// several times
+			auto it = std::min_element (
+				timers.begin (), timers.end (),
+				[] (const auto& lhs, const auto& rhs) { return lhs.due < rhs.due; });
+			if (it == timers.end () || it->due > end)
+				break;
+			now = it->due;
+			it->due += it->interval;
+			// the handler may register or unregister timers
+			auto handler = it->handler;
+			handler->onTimer ();
+		}
+		now = end;
+	}
+
+private:
+	struct TimerEntry
+	{
+		ITimerHandler* handler;
+		uint64_t interval;
+		uint64_t due;
+	};
+	std::vector<TimerEntry> timers;
+	uint64_t now;
+};
+
+SharedPointer<VirtualClockRunLoop> gVirtualClock;
+uint32_t gNumHeadlessFrames {0};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+struct HeadlessFrame::Impl
+{
+	IPlatformFrameCallback* frame;
+	CRect size;
+	Cairo::SurfaceHandle surface;
+	PlatformGraphicsDevicePtr device;
+	std::shared_ptr<CairoGraphicsDeviceContext> drawContext;
+	std::unique_ptr<Cairo::TileRenderer> tileRenderer;
+	CInvalidRectList dirtyRects;
+	CPoint mousePosition;
+	CButtonState mouseButtons {0};
+	Modifiers modifiers;
+	std::unique_ptr<GenericOptionMenuTheme> genericOptionMenuTheme;
+
+	Impl (IPlatformFrameCallback* frame, const CRect& size) : frame (frame), size (size)
+	{
+		device = getPlatformFactory ().getGraphicsDeviceFactory ().getDeviceForScreen (
+			DefaultScreenIdentifier);
+		createSurface ();
+	}
+
+	void createSurface ()
+	{
+		drawContext.reset ();
+		surface.assign (cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+													static_cast<int> (size.getWidth ()),
+													static_cast<int> (size.getHeight ())));
+		auto cairoDevice = std::static_pointer_cast<CairoGraphicsDevice> (device);
+		drawContext = std::make_shared<CairoGraphicsDeviceContext> (*cairoDevice, surface);
+		dirtyRects.clear ();
+		dirtyRects.add (CRect (0., 0., size.getWidth (), size.getHeight ()));
+	}
+
+	uint32_t draw ()
+	{
+		if (!frame || dirtyRects.empty ())
+			return 0;
+		// views may invalidate while drawing, these rects are drawn the next time
+		CInvalidRectList rectList;
+		std::swap (rectList, dirtyRects);
+#if VSTGUI_ENABLE_DRAW_PROFILER
+		DrawProfiler::FrameScope profilerScope;
+#endif
+
+		auto cairoDevice = std::static_pointer_cast<CairoGraphicsDevice> (device);
+		std::vector<CRect> rects;
+		for (const auto& rect : rectList)
+		{
+			if (Cairo::TileRenderer::isEnabled () && Cairo::TileRenderer::wantsTiles (rect) &&
+				frame->platformPrepareConcurrentDraw (rect))
+			{
+				if (!tileRenderer)
+					tileRenderer = std::make_unique<Cairo::TileRenderer> ();
+				tileRenderer->draw (surface, *cairoDevice, rect,
+									[this] (const PlatformGraphicsDeviceContextPtr& context,
+											const CRect& tileRect) {
+										frame->platformDrawRects (context, 1., {tileRect});
+									});
+			}
+			else
+			{
+				rects.emplace_back (rect);
+			}
+		}
+		if (!rects.empty ())
+		{
+			drawContext->beginDraw ();
+			frame->platformDrawRects (drawContext, 1., rects);
+			drawContext->endDraw ();
+		}
+		cairo_surface_flush (surface);
+		return static_cast<uint32_t> (rectList.data ().size ());
+	}
+};
+
+//------------------------------------------------------------------------
+HeadlessFrame::HeadlessFrame (IPlatformFrameCallback* frame, const CRect& size)
+: IPlatformFrame (frame)
+{
+	if (gNumHeadlessFrames++ == 0)
+	{
+		// start where the steady clock is, so that the ticks do not jump back
+		using namespace std::chrono;
+		auto now = steady_clock::now ().time_since_epoch ();
+		gVirtualClock = makeOwned<VirtualClockRunLoop> (
+			static_cast<uint64_t> (duration_cast<milliseconds> (now).count ()));
+	}
+	// the X11 timers use the run loop
+	RunLoop::init (gVirtualClock, false);
+
+	impl = std::unique_ptr<Impl> (new Impl (frame, size));
+
+	frame->platformOnActivate (true);
+}
+
+//------------------------------------------------------------------------
+HeadlessFrame::~HeadlessFrame () noexcept
+{
+	impl.reset ();
+	RunLoop::exit ();
+	if (--gNumHeadlessFrames == 0)
+		gVirtualClock = nullptr;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getClockTicks (uint64_t& ticks)
+{
+	if (!gVirtualClock)
+		return false;
+	ticks = gVirtualClock->getTicks ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::canOpen ()
+{
+	auto runLoop = RunLoop::get ();
+	return !runLoop || runLoop.get () == gVirtualClock.get ();
+}
+
+//------------------------------------------------------------------------
+uint32_t HeadlessFrame::drawDirtyRects ()
+{
+	return impl->draw ();
+}
+
+//------------------------------------------------------------------------
+void HeadlessFrame::advanceTime (uint64_t milliseconds)
+{
+	// keep this frame and the clock alive in case a timer closes the frame
+	SharedPointer<HeadlessFrame> self (this);
+	auto clock = gVirtualClock;
+	clock->advance (milliseconds);
+	drawDirtyRects ();
+}
+
+//------------------------------------------------------------------------
+void HeadlessFrame::dispatchEvent (Event& event)
+{
+	if (auto mouseEvent = asMouseEvent (event))
+	{
+		impl->mousePosition = mouseEvent->mousePosition;
+		impl->modifiers = mouseEvent->modifiers;
+		impl->mouseButtons = event.type == EventType::MouseUp
+								 ? 0
+								 : buttonStateFromMouseEvent (*mouseEvent);
+	}
+	else if (auto modifierEvent = asModifierEvent (event))
+	{
+		impl->modifiers = modifierEvent->modifiers;
+	}
+	if (frame)
+		frame->platformOnEvent (event);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> HeadlessFrame::createSnapshot () const
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (impl->size.getSize ());
+	Cairo::ContextHandle context (cairo_create (bitmap->getSurface ()));
+	cairo_set_operator (context, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (context, impl->surface, 0, 0);
+	cairo_paint (context);
+	cairo_surface_flush (bitmap->getSurface ());
+	return makeOwned<CBitmap> (bitmap);
+}
+
+//------------------------------------------------------------------------
+void HeadlessFrame::onFrameClosed ()
+{
+	frame = nullptr;
+	impl->frame = nullptr;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getGlobalPosition (CPoint& pos) const
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::setSize (const CRect& newSize)
+{
+	impl->size = newSize;
+	impl->createSurface ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getSize (CRect& size) const
+{
+	size = impl->size;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getCurrentMousePosition (CPoint& mousePosition) const
+{
+	mousePosition = impl->mousePosition;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getCurrentMouseButtons (CButtonState& buttons) const
+{
+	buttons = impl->mouseButtons;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::getCurrentModifiers (Modifiers& modifiers) const
+{
+	modifiers = impl->modifiers;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::setMouseCursor (CCursorType type)
+{
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::invalidRect (const CRect& rect)
+{
+	impl->dirtyRects.add (rect);
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::scrollRect (const CRect& src, const CPoint& distance)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::showTooltip (const CRect& rect, const char* utf8Text)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::hideTooltip ()
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+void* HeadlessFrame::getPlatformRepresentation () const
+{
+	return static_cast<cairo_surface_t*> (impl->surface);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformTextEdit>
+	HeadlessFrame::createPlatformTextEdit (IPlatformTextEditCallback* textEdit)
+{
+	return makeOwned<GenericTextEdit> (textEdit);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformOptionMenu> HeadlessFrame::createPlatformOptionMenu ()
+{
+	auto cFrame = dynamic_cast<CFrame*> (frame);
+	GenericOptionMenuTheme theme;
+	if (impl->genericOptionMenuTheme)
+		theme = *impl->genericOptionMenuTheme.get ();
+	return makeOwned<GenericOptionMenu> (cFrame, MouseEventButtonState (MouseButton::Left), theme);
+}
+
+#if VSTGUI_OPENGL_SUPPORT
+//------------------------------------------------------------------------
+SharedPointer<IPlatformOpenGLView> HeadlessFrame::createPlatformOpenGLView ()
+{
+	return nullptr;
+}
+#endif
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformViewLayer> HeadlessFrame::createPlatformViewLayer (
+	IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer)
+{
+	return nullptr;
+}
+
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+//------------------------------------------------------------------------
+DragResult HeadlessFrame::doDrag (IDataPackage* source, const CPoint& offset, CBitmap* dragBitmap)
+{
+	return kDragError;
+}
+#endif
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::doDrag (const DragDescription& dragDescription,
+							const SharedPointer<IDragCallback>& callback)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+PlatformType HeadlessFrame::getPlatformType () const
+{
+	return PlatformType::kHeadless;
+}
+
+//------------------------------------------------------------------------
+Optional<UTF8String> HeadlessFrame::convertCurrentKeyEventToText ()
+{
+	return {};
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFrame::setupGenericOptionMenu (bool use, GenericOptionMenuTheme* theme)
+{
+	if (theme)
+		impl->genericOptionMenuTheme = std::make_unique<GenericOptionMenuTheme> (*theme);
+	else
+		impl->genericOptionMenuTheme = nullptr;
+	return true;
+}
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
@@ -0,0 +1,76 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../crect.h"
+#include "../iplatformframe.h"
+#include "../platform_x11.h"
+#include <memory>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+
+//------------------------------------------------------------------------
+/** Frame without a window which draws into a Cairo image surface, see IHeadlessFrame */
+class HeadlessFrame
+: public IPlatformFrame
+, public IHeadlessFrame
+{
+public:
+	HeadlessFrame (IPlatformFrameCallback* frame, const CRect& size);
+	~HeadlessFrame () noexcept;
+
+	/** get the ticks of the virtual clock, returns false if there is no headless frame */
+	static bool getClockTicks (uint64_t& ticks);
+	/** the virtual clock replaces the run loop of the process, headless frames can only be
+	 *	opened when no other run loop is active
+	 */
+	static bool canOpen ();
+
+	uint32_t drawDirtyRects () override;
+	void advanceTime (uint64_t milliseconds) override;
+	void dispatchEvent (Event& event) override;
+	SharedPointer<CBitmap> createSnapshot () const override;
+
+private:
+	bool getGlobalPosition (CPoint& pos) const override;
+	bool setSize (const CRect& newSize) override;
+	bool getSize (CRect& size) const override;
+	bool getCurrentMousePosition (CPoint& mousePosition) const override;
+	bool getCurrentMouseButtons (CButtonState& buttons) const override;
+	bool getCurrentModifiers (Modifiers& modifiers) const override;
+	bool setMouseCursor (CCursorType type) override;
+	bool invalidRect (const CRect& rect) override;
+	bool scrollRect (const CRect& src, const CPoint& distance) override;
+	bool showTooltip (const CRect& rect, const char* utf8Text) override;
+	bool hideTooltip () override;
+	void* getPlatformRepresentation () const override;
+	SharedPointer<IPlatformTextEdit>
+	createPlatformTextEdit (IPlatformTextEditCallback* textEdit) override;
+	SharedPointer<IPlatformOptionMenu> createPlatformOptionMenu () override;
+#if VSTGUI_OPENGL_SUPPORT
+	SharedPointer<IPlatformOpenGLView> createPlatformOpenGLView () override;
+#endif
+	SharedPointer<IPlatformViewLayer> createPlatformViewLayer (
+		IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer) override;
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+	DragResult doDrag (IDataPackage* source, const CPoint& offset, CBitmap* dragBitmap) override;
+#endif
+	bool doDrag (const DragDescription& dragDescription,
+				 const SharedPointer<IDragCallback>& callback) override;
+
+	PlatformType getPlatformType () const override;
+	void onFrameClosed () override;
+	Optional<UTF8String> convertCurrentKeyEventToText () override;
+	bool setupGenericOptionMenu (bool use, GenericOptionMenuTheme* theme = nullptr) override;
+
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+};
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
@@ -4,9 +4,13 @@
 
 #include "cairobitmap.h"
 #include "cairofont.h"
+#include "cairoglyphatlas.h"
 #include "cairogradient.h"
 #include "cairographicscontext.h"
+#include "cairotilerenderer.h"
+#include "headlessframe.h"
 #include "x11frame.h"
+#include "x11shmbackbuffer.h"
 #include "../iplatformframecallback.h"
 #include "../common/fileresourceinputstream.h"
 #include "../iplatformresourceinputstream.h"
@@ -78,9 +82,48 @@ std::string LinuxFactory::getResourcePath () const noexcept
 	return impl->resPath;
 }
 
+//-----------------------------------------------------------------------------
+void LinuxFactory::setGlyphAtlasEnabled (bool state) const noexcept
+{
+	Cairo::GlyphAtlas::setEnabled (state);
+}
+
+//-----------------------------------------------------------------------------
+bool LinuxFactory::isGlyphAtlasEnabled () const noexcept
+{
+	return Cairo::GlyphAtlas::isEnabled ();
+}
+
+//-----------------------------------------------------------------------------
+void LinuxFactory::setTileParallelDrawingEnabled (bool state) const noexcept
+{
+	Cairo::TileRenderer::setEnabled (state);
+}
+
+//-----------------------------------------------------------------------------
+bool LinuxFactory::isTileParallelDrawingEnabled () const noexcept
+{
+	return Cairo::TileRenderer::isEnabled ();
+}
+
+//-----------------------------------------------------------------------------
+void LinuxFactory::setSharedMemoryPresentationEnabled (bool state) const noexcept
+{
+	X11::ShmBackBuffer::setEnabled (state);
+}
+
+//-----------------------------------------------------------------------------
+bool LinuxFactory::isSharedMemoryPresentationEnabled () const noexcept
+{
+	return X11::ShmBackBuffer::isEnabled ();
+}
+
 //-----------------------------------------------------------------------------
 uint64_t LinuxFactory::getTicks () const noexcept
 {
+	uint64_t ticks;
+	if (X11::HeadlessFrame::getClockTicks (ticks))
+		return ticks;
 	using namespace std::chrono;
 	return duration_cast<milliseconds> (steady_clock::now ().time_since_epoch ()).count ();
 }
@@ -90,11 +133,28 @@ PlatformFramePtr LinuxFactory::createFrame (IPlatformFrameCallback* frame, const
 											void* parent, PlatformType parentType,
 											IPlatformFrameConfig* config) const noexcept
 {
+	// the timers run on the one run loop of the process, which is the virtual clock while headless
+	// frames are open, so X11 frames and headless frames can't be mixed
 	if (parentType == PlatformType::kDefaultNative || parentType == PlatformType::kX11EmbedWindowID)
 	{
+		uint64_t ticks;
+		if (X11::HeadlessFrame::getClockTicks (ticks))
+		{
+			vstgui_assert (false, "X11 frames can't be opened while a headless frame is open");
+			return nullptr;
+		}
 		auto x11Parent = reinterpret_cast<XID> (parent);
 		return makeOwned<X11::Frame> (frame, size, x11Parent, config);
 	}
+	if (parentType == PlatformType::kHeadless)
+	{
+		if (!X11::HeadlessFrame::canOpen ())
+		{
+			vstgui_assert (false, "headless frames can't be opened while an X11 frame is open");
+			return nullptr;
+		}
+		return makeOwned<X11::HeadlessFrame> (frame, size);
+	}
 	return nullptr;
 }
 
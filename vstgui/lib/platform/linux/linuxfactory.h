@@ -19,6 +19,32 @@ public:
 	void setResourcePath (const std::string& path) const noexcept;
 	std::string getResourcePath () const noexcept;
 
+	/** Draw single line text of simple scripts from a cache of pre-rasterized glyphs instead of
+	 *	shaping and rasterizing it with Pango on every draw. Off by default.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setGlyphAtlasEnabled (bool state) const noexcept;
+	bool isGlyphAtlasEnabled () const noexcept;
+
+	/** Draw large dirty areas of a frame in tiles on several threads. Only areas where all views
+	 *	are declared thread-safe to draw are drawn in tiles, see CView::setThreadSafeToDraw. Off by
+	 *	default.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setTileParallelDrawingEnabled (bool state) const noexcept;
+	bool isTileParallelDrawingEnabled () const noexcept;
+
+	/** Keep the back buffer of a frame in MIT-SHM shared memory and present it with
+	 *	xcb_shm_put_image. When the X server does not support it, the frame falls back to a back
+	 *	buffer on the server. Off by default, takes effect when a frame is created or resized.
+	 *
+	 *	@ingroup new_in_4_14
+	 */
+	void setSharedMemoryPresentationEnabled (bool state) const noexcept;
+	bool isSharedMemoryPresentationEnabled () const noexcept;
+
 	/** Return platform ticks (millisecond resolution)
 	 *	@return ticks
 	 */
@@ -9,6 +9,7 @@
 #include "../../cframe.h"
 #include "../../crect.h"
 #include "../../dragging.h"
+#include "../../drawprofiler.h"
 #include "../../vstkeycode.h"
 #include "../../cinvalidrectlist.h"
 #include "../iplatformopenglview.h"
@@ -21,7 +22,9 @@
 #include "cairobitmap.h"
 #include "linuxfactory.h"
 #include "cairographicscontext.h"
+#include "cairotilerenderer.h"
 #include "x11platform.h"
+#include "x11shmbackbuffer.h"
 #include "x11utils.h"
 #include <cassert>
 #include <iostream>
@@ -167,11 +170,18 @@ struct RedrawTimerHandler
 struct DrawHandler
 {
 	DrawHandler (const ChildWindow& window)
+	: windowID (window.getID ()), visual (window.getVisual ())
 	{
-		auto s = cairo_xcb_surface_create (RunLoop::instance ().getXcbConnection (),
-										   window.getID (), window.getVisual (),
+		auto connection = RunLoop::instance ().getXcbConnection ();
+		auto s = cairo_xcb_surface_create (connection, window.getID (), window.getVisual (),
 										   window.getSize ().x, window.getSize ().y);
 		windowSurface.assign (s);
+		if (auto geometry = xcb_get_geometry_reply (
+				connection, xcb_get_geometry (connection, window.getID ()), nullptr))
+		{
+			depth = geometry->depth;
+			free (geometry);
+		}
 		device =
 			getPlatformFactory ().asLinuxFactory ()->getCairoGraphicsDeviceFactory ().addDevice (
 				cairo_surface_get_device (s));
@@ -187,8 +197,18 @@ struct DrawHandler
 	void onSizeChanged (const CPoint& size)
 	{
 		cairo_xcb_surface_set_size (windowSurface, size.x, size.y);
-		backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar (
-			windowSurface, CAIRO_CONTENT_COLOR_ALPHA, size.x, size.y));
+		drawContext.reset ();
+		backBuffer.reset ();
+		shmBackBuffer.reset ();
+		if (ShmBackBuffer::isEnabled ())
+			shmBackBuffer = ShmBackBuffer::create (RunLoop::instance ().getXcbConnection (),
+												   windowID, visual, depth, size.x, size.y);
+		if (shmBackBuffer)
+			backBuffer =
+				Cairo::SurfaceHandle (cairo_surface_reference (shmBackBuffer->getSurface ()));
+		else
+			backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar (
+				windowSurface, CAIRO_CONTENT_COLOR_ALPHA, size.x, size.y));
 		backBufferSize.setSize (size);
 		auto cairoDevice = std::static_pointer_cast<CairoGraphicsDevice> (device);
 		drawContext = std::make_shared<CairoGraphicsDeviceContext> (*cairoDevice, backBuffer);
@@ -196,20 +216,68 @@ struct DrawHandler
 
 	void draw (const CInvalidRectList& dirtyRects, IPlatformFrameCallback* frame)
 	{
-		drawContext->beginDraw ();
-		frame->platformDrawRects (drawContext, 1, dirtyRects.data ());
-		drawContext->endDraw ();
+		if (shmBackBuffer)
+			shmBackBuffer->waitForPresentDone ();
+#if VSTGUI_ENABLE_DRAW_PROFILER
+		// the tiles are recorded as one frame
+		DrawProfiler::FrameScope profilerScope;
+#endif
+		std::vector<CRect> rects;
+		for (const auto& rect : dirtyRects)
+		{
+			if (Cairo::TileRenderer::isEnabled () && Cairo::TileRenderer::wantsTiles (rect) &&
+				frame->platformPrepareConcurrentDraw (rect))
+			{
+				drawInTiles (rect, frame);
+			}
+			else
+			{
+				rects.emplace_back (rect);
+			}
+		}
+		if (!rects.empty ())
+		{
+			drawContext->beginDraw ();
+			frame->platformDrawRects (drawContext, 1, rects);
+			drawContext->endDraw ();
+		}
 
-		blitBackbufferToWindow (dirtyRects);
+		if (shmBackBuffer)
+		{
+			for (const auto& rect : dirtyRects)
+				shmBackBuffer->present (rect);
+		}
+		else
+		{
+			blitBackbufferToWindow (dirtyRects);
+		}
 		xcb_flush (RunLoop::instance ().getXcbConnection ());
 	}
 
 private:
+	xcb_window_t windowID;
+	xcb_visualtype_t* visual;
+	uint8_t depth {0};
 	Cairo::SurfaceHandle windowSurface;
+	// destroyed after the back buffer surface and the draw context which reference its memory
+	std::unique_ptr<ShmBackBuffer> shmBackBuffer;
 	Cairo::SurfaceHandle backBuffer;
 	CRect backBufferSize;
 	std::shared_ptr<CairoGraphicsDeviceContext> drawContext;
 	PlatformGraphicsDevicePtr device;
+	std::unique_ptr<Cairo::TileRenderer> tileRenderer;
+
+	void drawInTiles (const CRect& rect, IPlatformFrameCallback* frame)
+	{
+		if (!tileRenderer)
+			tileRenderer = std::make_unique<Cairo::TileRenderer> ();
+		auto cairoDevice = std::static_pointer_cast<CairoGraphicsDevice> (device);
+		tileRenderer->draw (backBuffer, *cairoDevice, rect,
+							[frame] (const PlatformGraphicsDeviceContextPtr& context,
+									 const CRect& tileRect) {
+								frame->platformDrawRects (context, 1, {tileRect});
+							});
+	}
 
 	void blitBackbufferToWindow (const CInvalidRectList& rects)
 	{
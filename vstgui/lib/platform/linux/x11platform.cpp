@@ -122,11 +122,16 @@ struct RunLoop::Impl : IEventHandler
 	KeyboardEvent lastUnprocessedKeyEvent;
 	uint32_t lastUtf32KeyEventChar {0};
 
-	void init (const SharedPointer<IRunLoop>& inRunLoop)
+	void init (const SharedPointer<IRunLoop>& inRunLoop, bool connectToServer)
+	{
+		if (++useCount == 1)
+			runLoop = inRunLoop;
+		if (connectToServer && !xcbConnection)
+			connect ();
+	}
+
+	void connect ()
 	{
-		if (++useCount != 1)
-			return;
-		runLoop = inRunLoop;
 		int screenNo;
 		xcbConnection = xcb_connect (nullptr, &screenNo);
 		runLoop->registerEventHandler (xcb_get_file_descriptor (xcbConnection), this);
@@ -184,11 +189,17 @@ struct RunLoop::Impl : IEventHandler
 						xcb_free_cursor (xcbConnection, c);
 				}
 				xcb_cursor_context_free (cursorContext);
+				cursors.fill (XCB_CURSOR_NONE);
 			}
+			xkbUnprocessedState = xkbState = nullptr;
+			xkbKeymap = nullptr;
+			xkbContext = nullptr;
+			cursorContext = nullptr;
 
 			xcb_disconnect (xcbConnection);
+			xcbConnection = nullptr;
+			runLoop->unregisterEventHandler (this);
 		}
-		runLoop->unregisterEventHandler (this);
 		runLoop = nullptr;
 	}
 
@@ -385,9 +396,9 @@ RunLoop& RunLoop::instance ()
 }
 
 //------------------------------------------------------------------------
-void RunLoop::init (const SharedPointer<IRunLoop>& runLoop)
+void RunLoop::init (const SharedPointer<IRunLoop>& runLoop, bool connectToServer)
 {
-	instance ().impl->init (runLoop);
+	instance ().impl->init (runLoop, connectToServer);
 }
 
 //------------------------------------------------------------------------
@@ -50,7 +50,10 @@ struct IFrameEventHandler
 //------------------------------------------------------------------------
 struct RunLoop
 {
-	static void init (const SharedPointer<IRunLoop>& runLoop);
+	/** headless frames only need the run loop for the timers and do not connect to the X server,
+	 *	the connection is made when the first X11 frame needs it
+	 */
+	static void init (const SharedPointer<IRunLoop>& runLoop, bool connectToServer = true);
 	static void exit ();
 	static const SharedPointer<IRunLoop> get ();
 
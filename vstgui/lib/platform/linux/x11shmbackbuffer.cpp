@@ -0,0 +1,202 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "x11shmbackbuffer.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <xcb/shm.h>
+#include <xcb/xcb_aux.h>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+namespace {
+
+std::atomic<bool> gShmBackBufferEnabled {false};
+
+//------------------------------------------------------------------------
+bool isLittleEndianHost ()
+{
+	const uint32_t value = 1;
+	return *reinterpret_cast<const uint8_t*> (&value) == 1;
+}
+
+//------------------------------------------------------------------------
+/** the pixels of a Cairo image surface are native endian 32 bit words with 8 bit per channel,
+ *	the server must read them in the same layout
+ */
+bool isCompatiblePixelFormat (xcb_connection_t* connection, const xcb_visualtype_t* visual,
+							  uint8_t depth)
+{
+	if (!visual || (depth != 24 && depth != 32))
+		return false;
+	if (visual->_class != XCB_VISUAL_CLASS_TRUE_COLOR ||
+		visual->red_mask != 0xff0000 || visual->green_mask != 0xff00 ||
+		visual->blue_mask != 0xff)
+		return false;
+	auto setup = xcb_get_setup (connection);
+	auto serverByteOrder = isLittleEndianHost () ? XCB_IMAGE_ORDER_LSB_FIRST
+												 : XCB_IMAGE_ORDER_MSB_FIRST;
+	if (setup->image_byte_order != serverByteOrder)
+		return false;
+	for (auto it = xcb_setup_pixmap_formats_iterator (setup); it.rem; xcb_format_next (&it))
+	{
+		if (it.data->depth == depth)
+			return it.data->bits_per_pixel == 32;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+struct ShmBackBuffer::Impl
+{
+	xcb_connection_t* connection {nullptr};
+	xcb_drawable_t drawable {0};
+	xcb_gcontext_t gc {0};
+	xcb_shm_seg_t segment {0};
+	void* data {nullptr};
+	Cairo::SurfaceHandle surface;
+	uint8_t depth {0};
+	int width {0};
+	int height {0};
+	bool presentPending {false};
+
+	~Impl () noexcept
+	{
+		if (surface)
+		{
+			// the surface may still be referenced, but its memory goes away
+			cairo_surface_finish (surface);
+			surface.reset ();
+		}
+		if (gc)
+			xcb_free_gc (connection, gc);
+		if (segment)
+			xcb_shm_detach (connection, segment);
+		if (data)
+			shmdt (data);
+	}
+};
+
+//------------------------------------------------------------------------
+void ShmBackBuffer::setEnabled (bool state)
+{
+	gShmBackBufferEnabled = state;
+}
+
+//------------------------------------------------------------------------
+bool ShmBackBuffer::isEnabled ()
+{
+	return gShmBackBufferEnabled;
+}
+
+//------------------------------------------------------------------------
+std::unique_ptr<ShmBackBuffer> ShmBackBuffer::create (xcb_connection_t* connection,
+													  xcb_drawable_t drawable,
+													  const xcb_visualtype_t* visual,
+													  uint8_t depth, int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return nullptr;
+	auto extension = xcb_get_extension_data (connection, &xcb_shm_id);
+	if (!extension || !extension->present)
+		return nullptr;
+	if (!isCompatiblePixelFormat (connection, visual, depth))
+		return nullptr;
+
+	auto format = depth == 32 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+	auto stride = cairo_format_stride_for_width (format, width);
+	auto shmID = shmget (IPC_PRIVATE, static_cast<size_t> (stride) * height, IPC_CREAT | 0600);
+	if (shmID == -1)
+		return nullptr;
+
+	auto impl = std::make_unique<Impl> ();
+	impl->connection = connection;
+	impl->drawable = drawable;
+	impl->depth = depth;
+	impl->width = width;
+	impl->height = height;
+	impl->data = shmat (shmID, nullptr, 0);
+	if (impl->data == reinterpret_cast<void*> (-1))
+	{
+		impl->data = nullptr;
+		shmctl (shmID, IPC_RMID, nullptr);
+		return nullptr;
+	}
+	auto segment = xcb_generate_id (connection);
+	auto error =
+		xcb_request_check (connection, xcb_shm_attach_checked (connection, segment, shmID, 0));
+	// the segment is destroyed after both sides have detached it
+	shmctl (shmID, IPC_RMID, nullptr);
+	if (error)
+	{
+		// i.e. a remote server which cannot access the segment
+		free (error);
+		return nullptr;
+	}
+	impl->segment = segment;
+
+	impl->gc = xcb_generate_id (connection);
+	xcb_create_gc (connection, impl->gc, drawable, 0, nullptr);
+
+	impl->surface.assign (cairo_image_surface_create_for_data (
+		static_cast<unsigned char*> (impl->data), format, width, height, stride));
+	if (cairo_surface_status (impl->surface) != CAIRO_STATUS_SUCCESS)
+		return nullptr;
+
+	return std::unique_ptr<ShmBackBuffer> (new ShmBackBuffer (std::move (impl)));
+}
+
+//------------------------------------------------------------------------
+ShmBackBuffer::ShmBackBuffer (std::unique_ptr<Impl>&& inImpl) : impl (std::move (inImpl)) {}
+
+//------------------------------------------------------------------------
+ShmBackBuffer::~ShmBackBuffer () noexcept = default;
+
+//------------------------------------------------------------------------
+cairo_surface_t* ShmBackBuffer::getSurface () const
+{
+	return impl->surface;
+}
+
+//------------------------------------------------------------------------
+void ShmBackBuffer::present (const CRect& rect)
+{
+	CRect r (std::floor (rect.left), std::floor (rect.top), std::ceil (rect.right),
+			 std::ceil (rect.bottom));
+	r.bound (CRect (0., 0., impl->width, impl->height));
+	if (r.isEmpty ())
+		return;
+
+	cairo_surface_flush (impl->surface);
+	auto x = static_cast<int16_t> (r.left);
+	auto y = static_cast<int16_t> (r.top);
+	xcb_shm_put_image (impl->connection, impl->drawable, impl->gc,
+					   static_cast<uint16_t> (impl->width), static_cast<uint16_t> (impl->height),
+					   x, y, static_cast<uint16_t> (r.getWidth ()),
+					   static_cast<uint16_t> (r.getHeight ()), x, y, impl->depth,
+					   XCB_IMAGE_FORMAT_Z_PIXMAP, 0, impl->segment, 0);
+	impl->presentPending = true;
+}
+
+//------------------------------------------------------------------------
+void ShmBackBuffer::waitForPresentDone ()
+{
+	// the server reads the pixels while it processes the request, a round trip makes sure that
+	// it is done with them
+	if (!impl->presentPending)
+		return;
+	xcb_aux_sync (impl->connection);
+	impl->presentPending = false;
+}
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
@@ -0,0 +1,61 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "cairoutils.h"
+#include "../../crect.h"
+#include <memory>
+#include <xcb/xcb.h>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+
+//------------------------------------------------------------------------
+/** A back buffer in MIT-SHM shared memory
+ *
+ *	The back buffer is a client side Cairo image surface whose pixels are shared with the X
+ *	server. Presenting a rect is a single xcb_shm_put_image request, the pixels are not sent
+ *	through the X protocol.
+ */
+class ShmBackBuffer
+{
+public:
+	static void setEnabled (bool state);
+	static bool isEnabled ();
+
+	/** create a back buffer for the drawable
+	 *
+	 *	@return nullptr if the server does not support MIT-SHM, the segment could not be attached
+	 *	or the pixel format of the drawable does not match the Cairo image format
+	 */
+	static std::unique_ptr<ShmBackBuffer> create (xcb_connection_t* connection,
+												  xcb_drawable_t drawable,
+												  const xcb_visualtype_t* visual, uint8_t depth,
+												  int width, int height);
+
+	~ShmBackBuffer () noexcept;
+
+	cairo_surface_t* getSurface () const;
+
+	/** copy the rect of the back buffer to the drawable, the request is not flushed */
+	void present (const CRect& rect);
+
+	/** wait until the server has processed the last present, call before drawing into the back
+	 *	buffer again
+	 */
+	void waitForPresentDone ();
+
+private:
+	struct Impl;
+
+	ShmBackBuffer (std::unique_ptr<Impl>&& impl);
+
+	std::unique_ptr<Impl> impl;
+};
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
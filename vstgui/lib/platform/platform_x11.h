@@ -49,6 +49,35 @@ public:
 	virtual uint32_t getX11WindowID () const = 0;
 };
 
+//------------------------------------------------------------------------
+/** Extension of a frame opened with PlatformType::kHeadless
+ *
+ *	A headless frame has no window and does not need an X server. It draws into a Cairo image
+ *	surface which is returned by IPlatformFrame::getPlatformRepresentation. Invalid rects are only
+ *	drawn when drawDirtyRects or advanceTime is called.
+ *
+ *	The timers and the platform ticks of all headless frames run on a virtual clock which only
+ *	advances with advanceTime. The clock is shared by all headless frames, advancing it via one
+ *	frame fires the timers of all of them. While a headless frame is open, CFrame::open fails for
+ *	X11 frames and while an X11 frame is open, it fails for headless frames.
+ *
+ *	@ingroup new_in_4_14
+ */
+class IHeadlessFrame
+{
+public:
+	/** draw the invalid rects, returns the number of drawn rects */
+	virtual uint32_t drawDirtyRects () = 0;
+	/** advance the virtual clock, fire the timers which became due and draw the invalid rects */
+	virtual void advanceTime (uint64_t milliseconds) = 0;
+	/** dispatch a synthetic event to the frame, mouse events update the current mouse position,
+	 *	buttons and modifiers of the frame
+	 */
+	virtual void dispatchEvent (Event& event) = 0;
+	/** create a bitmap with a copy of the current content */
+	virtual SharedPointer<CBitmap> createSnapshot () const = 0;
+};
+
 //------------------------------------------------------------------------
 } // X11
 } // VSTGUI
@@ -25,6 +25,7 @@
 #include "../../cdropsource.h"
 #include "../../cgradient.h"
 #include "../../cinvalidrectlist.h"
+#include "../../drawprofiler.h"
 #include "../../events.h"
 #include "../../finally.h"
 
@@ -635,6 +636,10 @@ void Win32Frame::paint (HWND hwnd)
 
 	inPaint = true;
 	bool needsInvalidation = false;
+#if VSTGUI_ENABLE_DRAW_PROFILER
+	// the rects of the update region are recorded as one frame
+	DrawProfiler::FrameScope profilerScope;
+#endif
 	CRect frameSize;
 
 	PAINTSTRUCT ps;
@@ -177,6 +177,10 @@
 	#define VSTGUI_ENABLE_XML_PARSER 1
 #endif
 
+#ifndef VSTGUI_ENABLE_DRAW_PROFILER
+	#define VSTGUI_ENABLE_DRAW_PROFILER 0
+#endif
+
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
 	#define VSTGUI_OVERRIDE_VMETHOD	override
 	#define VSTGUI_FINAL_VMETHOD final
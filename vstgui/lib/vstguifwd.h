@@ -325,6 +325,7 @@ class IPlatformBitmapPixelAccess;
 class IPlatformFont;
 class IPlatformFrame;
 class IFontPainter;
+class IPlatformTextLayout;
 class IPlatformResourceInputStream;
 
 class IPlatformFactory;
@@ -358,6 +359,7 @@ using PlatformFramePtr = SharedPointer<IPlatformFrame>;
 using PlatformBitmapPtr = SharedPointer<IPlatformBitmap>;
 using PlatformFontPtr = SharedPointer<IPlatformFont>;
 using PlatformStringPtr = SharedPointer<IPlatformString>;
+using PlatformTextLayoutPtr = SharedPointer<IPlatformTextLayout>;
 using PlatformTimerPtr = SharedPointer<IPlatformTimer>;
 using PlatformResourceInputStreamPtr = std::unique_ptr<IPlatformResourceInputStream>;
 using PlatformFactoryPtr = std::unique_ptr<IPlatformFactory>;
@@ -40,8 +40,9 @@ public:
 
 	IValue::Type stringAsValue (const UTF8String& string) const override
 	{
-		auto v = UTF8StringView (string).toDouble ();
-		return v / 100.;
+		const auto& str = string.getString ();
+		auto v = parseNumber (str.data (), str.data () + str.size ());
+		return v ? *v / 100. : IValue::InvalidValue;
 	}
 
 	IValue::Type plainToNormalized (IValue::Type plain) const override { return plain / 100.; }
@@ -64,6 +65,13 @@ public:
 		if (value < 0. || value > 1.)
 			return result;
 		value = normalizedToPlain (value);
+		char buffer[512];
+		if (auto length = formatNumber (buffer, buffer + sizeof (buffer), value, stringPrecision))
+		{
+			result = UTF8String::StringType (buffer, length);
+			return result;
+		}
+		// only huge values with a huge precision do not fit into the buffer
 		std::stringstream sstream;
 		sstream.imbue (std::locale::classic ());
 		sstream.precision (stringPrecision);
@@ -77,13 +85,12 @@ public:
 
 	IValue::Type stringAsValue (const UTF8String& string) const override
 	{
-		IValue::Type value;
-		std::istringstream sstream (string.getString ());
-		sstream.imbue (std::locale::classic ());
-		sstream.precision (stringPrecision);
-		sstream >> value;
-		value = plainToNormalized (value);
-		if (sstream.fail () || value < 0. || value > 1.)
+		const auto& str = string.getString ();
+		auto number = parseNumber (str.data (), str.data () + str.size ());
+		if (!number)
+			return IValue::InvalidValue;
+		auto value = plainToNormalized (*number);
+		if (value < 0. || value > 1.)
 			return IValue::InvalidValue;
 		return value;
 	}
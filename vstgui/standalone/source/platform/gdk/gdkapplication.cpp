@@ -10,6 +10,7 @@
 #include "../../../../lib/platform/linux/x11frame.h"
 #include "../../../../lib/platform/linux/linuxfactory.h"
 #include "../../../../lib/platform/common/fileresourceinputstream.h"
+#include "gdkasync.h"
 #include "gdkcommondirectories.h"
 #include "gdkpreference.h"
 #include "gdkwindow.h"
@@ -189,6 +190,7 @@ int main (int argc, char* argv[])
 	if (app.init (argc, argv))
 	{
 		auto result = app.run ();
+		VSTGUI::Standalone::Async::waitAllTasksDone ();
 		VSTGUI::exit ();
 		return result;
 	}
@@ -2,7 +2,18 @@
 // in the LICENSE file found in the top-level directory of this
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
-#include "../../../include/iasync.h"
+#include "gdkasync.h"
+#include <glib.h>
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -10,6 +21,200 @@ namespace Standalone {
 namespace Platform {
 namespace GDK {
 
+static std::atomic<uint32_t> gBackgroundTaskCount {};
+
+//------------------------------------------------------------------------
+/** Tasks scheduled on the main queue are collected here and performed in order by one idle
+ *	source attached to the default GLib main context.
+ */
+struct MainTaskList
+{
+	static MainTaskList& instance ()
+	{
+		static MainTaskList gInstance;
+		return gInstance;
+	}
+
+	void post (Async::Task&& task)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		tasks.emplace_back (std::move (task));
+		if (sourcePosted)
+			return;
+		sourcePosted = true;
+		auto source = g_idle_source_new ();
+		g_source_set_priority (source, G_PRIORITY_DEFAULT);
+		g_source_set_callback (source, dispatchProc, this, nullptr);
+		g_source_attach (source, g_main_context_default ());
+		g_source_unref (source);
+	}
+
+private:
+	static gboolean dispatchProc (gpointer userData)
+	{
+		static_cast<MainTaskList*> (userData)->dispatch ();
+		return G_SOURCE_REMOVE;
+	}
+
+	void dispatch ()
+	{
+		std::deque<Async::Task> current;
+		{
+			std::lock_guard<std::mutex> guard (mutex);
+			current.swap (tasks);
+			sourcePosted = false;
+		}
+		for (auto& task : current)
+			task ();
+	}
+
+	std::mutex mutex;
+	std::deque<Async::Task> tasks;
+	bool sourcePosted {false};
+};
+
+//------------------------------------------------------------------------
+/** A pool of worker threads, one per CPU core.
+ *
+ *	Every worker has its own task list. New tasks are distributed round robin, a worker without
+ *	work steals the most recently added task from another worker.
+ */
+struct WorkerPool
+{
+	WorkerPool ()
+	{
+		auto numWorkers = std::max (std::thread::hardware_concurrency (), 1u);
+		for (auto i = 0u; i < numWorkers; ++i)
+			workers.emplace_back (std::make_unique<Worker> ());
+		for (auto i = 0u; i < numWorkers; ++i)
+		{
+			workers[i]->thread = std::thread ([this, i] () { workerLoop (i); });
+			pthread_setname_np (workers[i]->thread.native_handle (), "VSTGUI Worker");
+		}
+	}
+
+	~WorkerPool () noexcept
+	{
+		{
+			std::lock_guard<std::mutex> guard (sleepMutex);
+			stop = true;
+		}
+		wakeUp.notify_all ();
+		for (auto& worker : workers)
+			worker->thread.join ();
+	}
+
+	void schedule (Async::Task&& task)
+	{
+		auto index = nextWorker.fetch_add (1, std::memory_order_relaxed) % workers.size ();
+		// count the task before it is published, otherwise a worker could take it and decrement
+		// the counter before it was incremented
+		pendingTasks.fetch_add (1);
+		{
+			std::lock_guard<std::mutex> guard (workers[index]->mutex);
+			workers[index]->tasks.emplace_back (std::move (task));
+		}
+		{
+			std::lock_guard<std::mutex> guard (sleepMutex);
+		}
+		wakeUp.notify_one ();
+	}
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Async::Task> tasks;
+		std::thread thread;
+	};
+
+	bool popTask (size_t index, Async::Task& task)
+	{
+		auto& worker = *workers[index];
+		std::lock_guard<std::mutex> guard (worker.mutex);
+		if (worker.tasks.empty ())
+			return false;
+		task = std::move (worker.tasks.front ());
+		worker.tasks.pop_front ();
+		return true;
+	}
+
+	bool stealTask (size_t index, Async::Task& task)
+	{
+		for (size_t i = 1; i < workers.size (); ++i)
+		{
+			auto& victim = *workers[(index + i) % workers.size ()];
+			std::unique_lock<std::mutex> lock (victim.mutex, std::try_to_lock);
+			if (!lock.owns_lock () || victim.tasks.empty ())
+				continue;
+			task = std::move (victim.tasks.back ());
+			victim.tasks.pop_back ();
+			return true;
+		}
+		return false;
+	}
+
+	void workerLoop (size_t index)
+	{
+		while (true)
+		{
+			Async::Task task;
+			if (popTask (index, task) || stealTask (index, task))
+			{
+				pendingTasks.fetch_sub (1);
+				task ();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock (sleepMutex);
+			if (pendingTasks.load () > 0)
+			{
+				lock.unlock ();
+				std::this_thread::yield ();
+				continue;
+			}
+			if (stop)
+				return;
+			wakeUp.wait (lock, [this] () { return stop || pendingTasks.load () > 0; });
+		}
+	}
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<size_t> nextWorker {0};
+	std::atomic<uint32_t> pendingTasks {0};
+	std::mutex sleepMutex;
+	std::condition_variable wakeUp;
+	bool stop {false};
+};
+
+//------------------------------------------------------------------------
+/** The state of a serial queue, shared between the queue and its thread so that the queue can
+ *	be released from one of its own tasks.
+ */
+struct SerialQueueState
+{
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::deque<Async::Task> tasks;
+	bool stop {false};
+
+	void run ()
+	{
+		while (true)
+		{
+			Async::Task task;
+			{
+				std::unique_lock<std::mutex> lock (mutex);
+				wakeUp.wait (lock, [this] () { return stop || !tasks.empty (); });
+				if (tasks.empty ())
+					return;
+				task = std::move (tasks.front ());
+				tasks.pop_front ();
+			}
+			task ();
+		}
+	}
+};
+
 //------------------------------------------------------------------------
 } // GDK
 } // Platform
@@ -17,34 +222,105 @@ namespace GDK {
 //------------------------------------------------------------------------
 namespace Async {
 
+using namespace Platform::GDK;
+
 //------------------------------------------------------------------------
 struct Queue
 {
-	void schedule (Task&& task)
-	{
-		// TODO: scheduling not implemented yet
+	virtual ~Queue () noexcept = default;
+	virtual void schedule (Task&& task) = 0;
+};
+
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+Task makeCountedTask (Task&& task)
+{
+	++gBackgroundTaskCount;
+	return [task = std::move (task)] () {
 		task ();
+		--gBackgroundTaskCount;
+	};
+}
+
+//------------------------------------------------------------------------
+struct MainQueue final : Queue
+{
+	void schedule (Task&& task) override { MainTaskList::instance ().post (std::move (task)); }
+};
+
+//------------------------------------------------------------------------
+struct BackgroundQueue final : Queue
+{
+	void schedule (Task&& task) override { pool.schedule (makeCountedTask (std::move (task))); }
+
+private:
+	WorkerPool pool;
+};
+
+//------------------------------------------------------------------------
+struct SerialQueue final : Queue
+{
+	SerialQueue (const char* name) : state (std::make_shared<SerialQueueState> ())
+	{
+		thread = std::thread ([state = state] () { state->run (); });
+		if (name)
+		{
+			// thread names are limited to 15 characters on Linux
+			std::string threadName (name, 0, 15);
+			pthread_setname_np (thread.native_handle (), threadName.data ());
+		}
 	}
+
+	~SerialQueue () noexcept override
+	{
+		{
+			std::lock_guard<std::mutex> guard (state->mutex);
+			state->stop = true;
+		}
+		state->wakeUp.notify_one ();
+		if (thread.get_id () == std::this_thread::get_id ())
+			thread.detach ();
+		else
+			thread.join ();
+	}
+
+	void schedule (Task&& task) override
+	{
+		{
+			std::lock_guard<std::mutex> guard (state->mutex);
+			state->tasks.emplace_back (makeCountedTask (std::move (task)));
+		}
+		state->wakeUp.notify_one ();
+	}
+
+private:
+	std::shared_ptr<SerialQueueState> state;
+	std::thread thread;
 };
 
+//------------------------------------------------------------------------
+} // anonymous
+
 //------------------------------------------------------------------------
 const QueuePtr& mainQueue ()
 {
-	static QueuePtr q = std::make_shared<Queue> ();
+	static QueuePtr q = std::make_shared<MainQueue> ();
 	return q;
 }
 
 //------------------------------------------------------------------------
 const QueuePtr& backgroundQueue ()
 {
-	static QueuePtr q = std::make_shared<Queue> ();
+	static QueuePtr q = std::make_shared<BackgroundQueue> ();
 	return q;
 }
 
 //------------------------------------------------------------------------
 QueuePtr makeSerialQueue (const char* name)
 {
-	return std::make_shared<Queue> ();
+	return std::make_shared<SerialQueue> (name);
 }
 
 //------------------------------------------------------------------------
@@ -53,6 +329,23 @@ void schedule (QueuePtr queue, Task&& task)
 	queue->schedule (std::move (task));
 }
 
+//------------------------------------------------------------------------
+void waitAllTasksDone ()
+{
+	auto context = g_main_context_default ();
+	while (true)
+	{
+		// read the counter first: a background task posts to the main queue before it is counted
+		// as done, so if it is zero and there is nothing to dispatch, all tasks are done
+		auto numBackgroundTasks = gBackgroundTaskCount.load ();
+		if (g_main_context_iteration (context, false))
+			continue;
+		if (numBackgroundTasks == 0)
+			break;
+		std::this_thread::sleep_for (std::chrono::microseconds (100));
+	}
+}
+
 //------------------------------------------------------------------------
 } // Async
 } // Standalone
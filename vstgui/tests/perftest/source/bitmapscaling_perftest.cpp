@@ -0,0 +1,90 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/coffscreencontext.h"
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumIcons = 10000;
+static constexpr uint32_t kNumColumns = 40;
+static constexpr CCoord kIconSize = 24.;
+static constexpr double kBitmapScaleFactor = 2.;
+
+//------------------------------------------------------------------------
+/** an icon with 2x pixels like a HiDPI skin element */
+SharedPointer<CBitmap> makeIcon ()
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (kIconSize, kIconSize), kBitmapScaleFactor);
+	if (auto access = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			auto x = access->getX ();
+			auto y = access->getY ();
+			access->setColor (CColor (static_cast<uint8_t> (x * 5), static_cast<uint8_t> (y * 5),
+									  128, (x + y) % 7 ? 255 : 0));
+		} while (++*access);
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+/** the same icon in a bitmap which was the target of a draw context and is not cached */
+SharedPointer<CBitmap> makeRenderTargetIcon (CBitmap* icon)
+{
+	auto offscreen = COffscreenContext::create ({kIconSize, kIconSize}, kBitmapScaleFactor);
+	offscreen->beginDraw ();
+	{
+		CDrawContext::Transform t (
+			*offscreen, CGraphicsTransform ().scale (kBitmapScaleFactor, kBitmapScaleFactor));
+		offscreen->drawBitmap (icon, {0., 0., kIconSize, kIconSize});
+	}
+	offscreen->endDraw ();
+	return offscreen->getBitmap ();
+}
+
+//------------------------------------------------------------------------
+void drawIcons (COffscreenContext* offscreen, CBitmap* icon)
+{
+	for (uint32_t i = 0; i < kNumIcons; ++i)
+	{
+		CRect r (0., 0., kIconSize, kIconSize);
+		r.offset ((i % kNumColumns) * kIconSize, ((i / kNumColumns) % kNumColumns) * kIconSize);
+		offscreen->drawBitmap (icon, r);
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (BitmapScaling, DrawHiDPIIcons10k)
+{
+	auto icon = makeIcon ();
+	auto renderTargetIcon = makeRenderTargetIcon (icon);
+	CPoint size (kNumColumns * kIconSize, kNumColumns * kIconSize);
+	auto offscreen = COffscreenContext::create (size);
+	offscreen->beginDraw ();
+
+	auto resampled = PerfTest::measure (4, [&] () { drawIcons (offscreen, renderTargetIcon); });
+	auto cached = PerfTest::measure (4, [&] () { drawIcons (offscreen, icon); });
+	offscreen->setBitmapInterpolationQuality (BitmapInterpolationQuality::kHigh);
+	auto cachedHigh = PerfTest::measure (4, [&] () { drawIcons (offscreen, icon); });
+	offscreen->setBitmapInterpolationQuality (BitmapInterpolationQuality::kLow);
+	auto nearest = PerfTest::measure (4, [&] () { drawIcons (offscreen, renderTargetIcon); });
+	offscreen->endDraw ();
+
+	context.report ("resample on every draw", resampled);
+	context.report ("pre-scaled surface", cached);
+	context.compare ("pre-scaled surface speedup", resampled, cached);
+	context.report ("pre-scaled surface, high quality", cachedHigh);
+	context.report ("resample on every draw, nearest neighbour", nearest);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,76 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr CCoord kTileSize = 16.;
+static constexpr CCoord kPanelWidth = 1920.;
+static constexpr CCoord kPanelHeight = 1080.;
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> makeTexture ()
+{
+	auto offscreen = COffscreenContext::create ({kTileSize, kTileSize});
+	offscreen->beginDraw ();
+	offscreen->setFillColor (kGreyCColor);
+	offscreen->drawRect ({0., 0., kTileSize, kTileSize}, kDrawFilled);
+	offscreen->setFillColor (kWhiteCColor);
+	offscreen->drawRect ({0., 0., kTileSize / 2., kTileSize / 2.}, kDrawFilled);
+	offscreen->endDraw ();
+	return offscreen->getBitmap ();
+}
+
+//------------------------------------------------------------------------
+/** what CDrawContext does when the platform context has no bitmap extension */
+void fillWithDrawBitmap (CDrawContext* context, CBitmap* bitmap, const CRect& dstRect)
+{
+	for (auto top = dstRect.top; top < dstRect.bottom; top += kTileSize)
+	{
+		for (auto left = dstRect.left; left < dstRect.right; left += kTileSize)
+		{
+			CRect r (left, top, std::min (left + kTileSize, dstRect.right),
+					 std::min (top + kTileSize, dstRect.bottom));
+			context->drawBitmap (bitmap, r, CPoint (), 1.f);
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (BitmapTiling, FillPanel)
+{
+	auto texture = makeTexture ();
+	CRect panel (0., 0., kPanelWidth, kPanelHeight);
+	CRect tile (0., 0., kTileSize, kTileSize);
+	auto offscreen = COffscreenContext::create (panel.getSize ());
+	offscreen->beginDraw ();
+
+	auto loop = PerfTest::measure (10, [&] () { fillWithDrawBitmap (offscreen, texture, panel); });
+	auto fill = PerfTest::measure (10, [&] () {
+		offscreen->fillRectWithBitmap (texture, tile, panel, 1.f);
+	});
+	CNinePartTiledDescription desc (kTileSize / 4., kTileSize / 4., kTileSize / 4.,
+									kTileSize / 4.);
+	auto ninePart = PerfTest::measure (10, [&] () {
+		offscreen->drawBitmapNinePartTiled (texture, panel, desc, 1.f);
+	});
+	offscreen->endDraw ();
+
+	context.report ("one drawBitmap per tile", loop);
+	context.report ("fillRectWithBitmap", fill);
+	context.compare ("fillRectWithBitmap speedup", loop, fill);
+	context.report ("drawBitmapNinePartTiled", ninePart);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
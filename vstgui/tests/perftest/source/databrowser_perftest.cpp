@@ -0,0 +1,87 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cdatabrowser.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/genericstringlistdatabrowsersource.h"
+#include <random>
+#include <string>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr size_t kNumRows = 100000;
+static constexpr uint32_t kScrollSteps = 1000;
+static constexpr uint32_t kHitTests = 100000;
+
+//------------------------------------------------------------------------
+struct Results
+{
+	PerfTest::Result scroll;
+	PerfTest::Result hitTest;
+};
+
+//------------------------------------------------------------------------
+Results runBrowser (const GenericStringListDataBrowserSource::StringVector& strings, int32_t style)
+{
+	CRect frameSize (0, 0, 300, 400);
+	auto frame = makeOwned<CFrame> (frameSize, nullptr);
+	auto source = makeOwned<GenericStringListDataBrowserSource> (&strings);
+	source->setupUI (kBlueCColor, kBlackCColor, kGreyCColor, kWhiteCColor, kWhiteCColor, nullptr,
+	                 18);
+	auto browser = new CDataBrowser (frameSize, source, style | CScrollView::kVerticalScrollbar |
+	                                                        CDataBrowser::kDrawRowLines);
+	frame->addView (browser);
+	frame->attached (frame);
+
+	Results results;
+	auto offscreen = COffscreenContext::create (frameSize.getSize ());
+	offscreen->beginDraw ();
+	int32_t row = 0;
+	results.scroll = PerfTest::measure (kScrollSteps, [&] () {
+		row = (row + 97) % static_cast<int32_t> (kNumRows);
+		browser->makeRowVisible (row);
+		browser->drawRect (offscreen, browser->getViewSize ());
+	});
+	offscreen->endDraw ();
+
+	std::minstd_rand engine {42};
+	std::uniform_real_distribution<CCoord> xDist (0., 280.);
+	std::uniform_real_distribution<CCoord> yDist (0., 400.);
+	int32_t validCells = 0;
+	results.hitTest = PerfTest::measure (kHitTests, [&] () {
+		if (browser->getCellAt ({xDist (engine), yDist (engine)}).isValid ())
+			++validCells;
+	});
+	frame->removeAll ();
+	return results;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (DataBrowser, Scroll100kRows)
+{
+	GenericStringListDataBrowserSource::StringVector strings;
+	strings.reserve (kNumRows);
+	for (size_t i = 0; i < kNumRows; ++i)
+		strings.emplace_back ("Preset " + std::to_string (i));
+
+	auto defaultResults = runBrowser (strings, 0);
+	auto virtualizedResults = runBrowser (strings, CDataBrowser::kVirtualizedLayout);
+
+	context.report ("scroll and draw", defaultResults.scroll);
+	context.report ("scroll and draw (virtualized)", virtualizedResults.scroll);
+	context.compare ("scroll speedup", defaultResults.scroll, virtualizedResults.scroll);
+	context.report ("getCellAt", defaultResults.hitTest);
+	context.report ("getCellAt (virtualized)", virtualizedResults.hitTest);
+	context.compare ("getCellAt speedup", defaultResults.hitTest, virtualizedResults.hitTest);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,193 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/drawprofiler.h"
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumContainers = 20;
+static constexpr uint32_t kNumViewsPerContainer = 20;
+static constexpr CCoord kViewSize = 10.;
+static constexpr uint64_t kNumFrames = 50;
+
+//------------------------------------------------------------------------
+struct FillView : CView
+{
+	using CView::CView;
+
+	void draw (CDrawContext* context) override
+	{
+		context->setFillColor (kGreyCColor);
+		context->drawRect (getViewSize (), kDrawFilled);
+		setDirty (false);
+	}
+};
+
+//------------------------------------------------------------------------
+/** draws many small rects, the most expensive view */
+struct ExpensiveView : CView
+{
+	using CView::CView;
+
+	void draw (CDrawContext* context) override
+	{
+		context->setFillColor (kRedCColor);
+		for (auto i = 0; i < 200; ++i)
+		{
+			CRect r (getViewSize ());
+			r.inset (i % 4, i % 4);
+			context->drawRect (r, kDrawFilled);
+		}
+		setDirty (false);
+	}
+};
+
+//------------------------------------------------------------------------
+struct ProfiledFrame
+{
+	ProfiledFrame ()
+	{
+		auto containerWidth = kViewSize * kNumViewsPerContainer;
+		CRect size (0, 0, containerWidth, kViewSize * kNumContainers);
+		frame = makeOwned<CFrame> (size, nullptr);
+		for (uint32_t c = 0; c < kNumContainers; ++c)
+		{
+			CRect r (0, 0, containerWidth, kViewSize);
+			r.offset (0, c * kViewSize);
+			auto container = new CViewContainer (r);
+			for (uint32_t i = 0; i < kNumViewsPerContainer; ++i)
+			{
+				CRect vr (0, 0, kViewSize, kViewSize);
+				vr.offset (i * kViewSize, 0);
+				CView* view = nullptr;
+				if (c == kNumContainers / 2 && i == kNumViewsPerContainer / 2)
+					view = expensiveView = new ExpensiveView (vr);
+				else
+					view = new FillView (vr);
+				container->addView (view);
+			}
+			frame->addView (container);
+		}
+		frame->attached (frame);
+	}
+
+	~ProfiledFrame () { frame->close (); }
+
+	PerfTest::Result drawFrames ()
+	{
+		auto size = frame->getViewSize ();
+		auto offscreen = COffscreenContext::create (size.getSize ());
+		offscreen->beginDraw ();
+		auto result = PerfTest::measure (kNumFrames, [&] () {
+			DrawProfiler::FrameScope frameScope;
+			frame->drawRect (offscreen, size);
+		});
+		offscreen->endDraw ();
+		return result;
+	}
+
+	SharedPointer<CFrame> frame;
+	CView* expensiveView {nullptr};
+};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (DrawProfiler, DrawOverhead)
+{
+	auto& profiler = DrawProfiler::instance ();
+	if (!DrawProfiler::isAvailable ())
+	{
+		context.report ("skipped, compiled without VSTGUI_ENABLE_DRAW_PROFILER", 0., "");
+		return;
+	}
+	ProfiledFrame editor;
+	auto disabled = editor.drawFrames ();
+	profiler.setEnabled (true);
+	profiler.clear ();
+	auto firstFrame = profiler.getFrameIndex ();
+	auto enabled = editor.drawFrames ();
+	profiler.setEnabled (false);
+
+	context.check ("all frames recorded",
+				   profiler.getFrameStatistics (firstFrame).size () == kNumFrames);
+	auto viewStats = profiler.getViewStatistics (firstFrame);
+	context.check ("most expensive view found",
+				   !viewStats.empty () && viewStats.front ().view == editor.expensiveView &&
+					   viewStats.front ().numDraws == kNumFrames);
+	auto trace = profiler.createChromeTrace ();
+	context.check ("chrome trace exported", trace.find ("\"traceEvents\"") != std::string::npos &&
+												trace.find ("ExpensiveView") != std::string::npos);
+	profiler.clear ();
+
+	context.report ("draw (profiler disabled)", disabled);
+	context.report ("draw (profiler enabled)", enabled);
+	context.compare ("profiler overhead", disabled, enabled);
+	context.report ("chrome trace size", trace.size () / 1024., "KiB");
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (DrawProfiler, ConcurrentRecording)
+{
+	auto& profiler = DrawProfiler::instance ();
+	if (!DrawProfiler::isAvailable ())
+	{
+		context.report ("skipped, compiled without VSTGUI_ENABLE_DRAW_PROFILER", 0., "");
+		return;
+	}
+	static constexpr uint32_t kNumThreads = 4;
+	static constexpr uint64_t kNumRecords = 200000;
+
+	std::vector<SharedPointer<CView>> views;
+	for (uint32_t i = 0; i < kNumThreads; ++i)
+		views.emplace_back (makeOwned<CView> (CRect (i, i, i + 1, i + 1)));
+
+	profiler.setEnabled (true);
+	profiler.clear ();
+	auto single = PerfTest::measure (kNumRecords, [&] () {
+		profiler.recordInvalidation (views[0], views[0]->getViewSize ());
+	});
+	profiler.clear ();
+
+	// every thread records the rect of its view, a torn record would mix them
+	std::vector<std::thread> threads;
+	auto concurrent = PerfTest::measure (1, [&] () {
+		for (uint32_t i = 0; i < kNumThreads; ++i)
+		{
+			threads.emplace_back ([&, i] () {
+				for (uint64_t r = 0; r < kNumRecords; ++r)
+					profiler.recordInvalidation (views[i], views[i]->getViewSize ());
+			});
+		}
+		for (auto& thread : threads)
+			thread.join ();
+	});
+	profiler.setEnabled (false);
+	auto records = profiler.getRecords ();
+	auto consistent = !records.empty ();
+	for (const auto& record : records)
+	{
+		if (record.view->getViewSize () != record.rect)
+			consistent = false;
+	}
+	profiler.clear ();
+	context.check ("records are consistent", consistent);
+
+	context.report ("record (one thread)", single);
+	context.report ("records per second (4 threads)",
+				   (kNumThreads * kNumRecords) / concurrent.totalSeconds,
+				   "records/s");
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
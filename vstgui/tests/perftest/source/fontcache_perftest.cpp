@@ -0,0 +1,74 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cfont.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/controls/ctextlabel.h"
+#include "vstgui/lib/cviewcontainer.h"
+#include "vstgui/lib/platform/iplatformfont.h"
+#include <iterator>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumLabels = 2000;
+static constexpr int32_t kStyles[] = {kNormalFace, kBoldFace, kItalicFace};
+
+//------------------------------------------------------------------------
+/** every label gets its own copy of the font description like labels created from a description */
+SharedPointer<CViewContainer> createLabels ()
+{
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 800, 1000));
+	for (uint32_t i = 0; i < kNumLabels; ++i)
+	{
+		CRect r (0, 0, 80, 20);
+		r.offset ((i % 10) * 80, ((i / 10) % 50) * 20);
+		auto label = new CTextLabel (r, "Label");
+		label->setFont (makeOwned<CFontDesc> ("Arial", 12, kStyles[i % 3]));
+		container->addView (label);
+	}
+	return container;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (PlatformFontCache, Labels2000)
+{
+	PlatformFontCache::clear ();
+	auto before = PlatformFontCache::getStatistics ();
+	auto container = createLabels ();
+	auto size = container->getViewSize ();
+	auto offscreen = COffscreenContext::create (size.getSize ());
+	offscreen->beginDraw ();
+	container->drawRect (offscreen, size);
+	auto stats = PlatformFontCache::getStatistics ();
+	context.report ("platform fonts created", static_cast<double> (stats.misses - before.misses),
+					"fonts");
+	context.check ("one platform font per style", stats.numFonts == std::size (kStyles));
+
+	auto draw = PerfTest::measure (10, [&] () { container->drawRect (offscreen, size); });
+	offscreen->endDraw ();
+	context.report ("draw 2000 labels", draw);
+
+	auto create = PerfTest::measure (10, [&] () {
+		auto labels = createLabels ();
+		labels->forEachChild ([] (CView* view) {
+			static_cast<CTextLabel*> (view)->getFont ()->getPlatformFont ();
+		});
+	});
+	context.report ("create 2000 labels and their fonts", create);
+
+	container = nullptr;
+	context.check ("all fonts unused after release",
+				   PlatformFontCache::getStatistics ().numUnusedFonts == std::size (kStyles));
+	PlatformFontCache::trim ();
+	context.check ("trimmed", PlatformFontCache::getStatistics ().numFonts == 0);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
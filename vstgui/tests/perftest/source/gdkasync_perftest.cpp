@@ -0,0 +1,102 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/standalone/source/platform/gdk/gdkasync.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+using namespace Standalone;
+
+static constexpr uint32_t kNumTasks = 200000;
+static constexpr uint32_t kNumHops = 10000;
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (GDKAsync, SerialQueueOrder)
+{
+	auto queue = Async::makeSerialQueue ("SerialOrder");
+	std::vector<uint32_t> order;
+	order.reserve (kNumTasks);
+	auto result = PerfTest::measure (1, [&] () {
+		for (uint32_t i = 0; i < kNumTasks; ++i)
+			Async::schedule (queue, [&order, i] () { order.push_back (i); });
+		Async::waitAllTasksDone ();
+	});
+	bool inOrder = order.size () == kNumTasks;
+	for (uint32_t i = 0; inOrder && i < kNumTasks; ++i)
+		inOrder = order[i] == i;
+	context.report ("serial tasks/s", kNumTasks / result.totalSeconds, "tasks/s");
+	context.check ("serial queue keeps order", inOrder);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (GDKAsync, BackgroundQueueThroughput)
+{
+	std::atomic<uint32_t> counter {0};
+	std::atomic<uint64_t> sum {0};
+	auto result = PerfTest::measure (1, [&] () {
+		for (uint32_t i = 0; i < kNumTasks; ++i)
+		{
+			Async::schedule (Async::backgroundQueue (), [&, i] () {
+				sum += i;
+				++counter;
+			});
+		}
+		Async::waitAllTasksDone ();
+	});
+	context.report ("background tasks/s", kNumTasks / result.totalSeconds, "tasks/s");
+	context.check ("background queue ran all tasks", counter == kNumTasks);
+	context.check ("background queue task results",
+	               sum == static_cast<uint64_t> (kNumTasks) * (kNumTasks - 1) / 2);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (GDKAsync, MainQueueHops)
+{
+	auto mainThread = std::this_thread::get_id ();
+	auto queue = Async::makeSerialQueue ("MainHops");
+	std::vector<uint32_t> order;
+	uint32_t onMainThread = 0;
+	std::atomic<uint32_t> backgroundHops {0};
+	auto result = PerfTest::measure (1, [&] () {
+		for (uint32_t i = 0; i < kNumHops; ++i)
+		{
+			// serial -> main must keep the order
+			Async::schedule (queue, [&, i] () {
+				Async::schedule (Async::mainQueue (), [&, i] () {
+					if (std::this_thread::get_id () == mainThread)
+						++onMainThread;
+					order.push_back (i);
+				});
+			});
+			// background -> main -> background
+			Async::schedule (Async::backgroundQueue (), [&] () {
+				Async::schedule (Async::mainQueue (), [&] () {
+					if (std::this_thread::get_id () == mainThread)
+						++onMainThread;
+					Async::schedule (Async::backgroundQueue (), [&] () { ++backgroundHops; });
+				});
+			});
+		}
+		Async::waitAllTasksDone ();
+	});
+	bool inOrder = order.size () == kNumHops;
+	for (uint32_t i = 0; inOrder && i < kNumHops; ++i)
+		inOrder = order[i] == i;
+	context.report ("main queue hops/s", (kNumHops * 2) / result.totalSeconds, "hops/s");
+	context.check ("main queue tasks run on the main thread", onMainThread == kNumHops * 2);
+	context.check ("main queue keeps order of a serial queue", inOrder);
+	context.check ("main queue hops back to background", backgroundHops == kNumHops);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,97 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cfont.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/platform/linux/cairoglyphatlas.h"
+#include "vstgui/lib/platform/linux/linuxfactory.h"
+#include "vstgui/lib/platform/platformfactory.h"
+#include <cstdio>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumStrings = 10000;
+static constexpr uint32_t kNumColumns = 20;
+static constexpr CCoord kCellWidth = 50.;
+static constexpr CCoord kCellHeight = 16.;
+
+//------------------------------------------------------------------------
+/** the kind of numeric readouts a meter or parameter display updates every frame */
+std::vector<UTF8String> makeStrings (uint32_t frame)
+{
+	std::vector<UTF8String> strings;
+	strings.reserve (kNumStrings);
+	char buffer[32];
+	for (uint32_t i = 0; i < kNumStrings; ++i)
+	{
+		snprintf (buffer, sizeof (buffer), "%.2f", ((i * 7 + frame * 13) % 20000) / 100. - 100.);
+		strings.emplace_back (buffer);
+	}
+	return strings;
+}
+
+//------------------------------------------------------------------------
+void drawFrame (COffscreenContext* offscreen, const std::vector<UTF8String>& strings)
+{
+	offscreen->clearRect (CRect (CPoint (), offscreen->getSurfaceRect ().getSize ()));
+	for (uint32_t i = 0; i < kNumStrings; ++i)
+	{
+		CRect r (0, 0, kCellWidth, kCellHeight);
+		r.offset ((i % kNumColumns) * kCellWidth, (i / kNumColumns) * kCellHeight);
+		offscreen->drawString (strings[i].getPlatformString (), r, kRightText);
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (GlyphAtlas, NumericReadouts10k)
+{
+	auto factory = getPlatformFactory ().asLinuxFactory ();
+	auto wasEnabled = factory->isGlyphAtlasEnabled ();
+
+	std::vector<std::vector<UTF8String>> frames;
+	for (uint32_t frame = 0; frame < 4; ++frame)
+		frames.emplace_back (makeStrings (frame));
+
+	CPoint size (kNumColumns * kCellWidth, (kNumStrings / kNumColumns) * kCellHeight);
+	auto offscreen = COffscreenContext::create (size);
+	offscreen->beginDraw ();
+	offscreen->setFont (kNormalFontSmall);
+	offscreen->setFontColor (kBlackCColor);
+
+	uint32_t frameIndex = 0;
+	auto drawNextFrame = [&] () {
+		drawFrame (offscreen, frames[frameIndex]);
+		frameIndex = (frameIndex + 1) % frames.size ();
+	};
+
+	factory->setGlyphAtlasEnabled (false);
+	auto pango = PerfTest::measure (8, drawNextFrame);
+
+	factory->setGlyphAtlasEnabled (true);
+	Cairo::GlyphAtlas::instance ().clear ();
+	auto before = Cairo::GlyphAtlas::instance ().getStatistics ();
+	auto atlas = PerfTest::measure (8, drawNextFrame);
+	auto stats = Cairo::GlyphAtlas::instance ().getStatistics ();
+	offscreen->endDraw ();
+	factory->setGlyphAtlasEnabled (wasEnabled);
+
+	context.report ("draw 10k strings via pango", pango);
+	context.report ("draw 10k strings via glyph atlas", atlas);
+	context.compare ("glyph atlas speedup", pango, atlas);
+	context.report ("glyphs in atlas", static_cast<double> (stats.numGlyphs), "glyphs");
+	context.report ("glyphs rasterized", static_cast<double> (stats.misses - before.misses),
+					"glyphs");
+	context.check ("all strings drawn via the atlas",
+				   stats.fallbacks == before.fallbacks && stats.hits > before.hits);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,83 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cgradient.h"
+#include "vstgui/lib/cgraphicspath.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumCells = 1000;
+static constexpr uint32_t kNumColumns = 40;
+static constexpr CCoord kCellWidth = 40.;
+static constexpr CCoord kCellHeight = 20.;
+
+//------------------------------------------------------------------------
+CRect cellRect (uint32_t index)
+{
+	CRect r (0., 0., kCellWidth - 2., kCellHeight - 2.);
+	r.offset ((index % kNumColumns) * kCellWidth, (index / kNumColumns) * kCellHeight);
+	return r;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CGradient> makeGradient ()
+{
+	return owned (CGradient::create (0., 1., kGreyCColor, kBlackCColor));
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (Gradient, SameGradient1000Places)
+{
+	CPoint size (kNumColumns * kCellWidth, (kNumCells / kNumColumns) * kCellHeight);
+	auto offscreen = COffscreenContext::create (size);
+	offscreen->beginDraw ();
+	offscreen->setDrawMode (kAntiAliasing);
+
+	std::vector<SharedPointer<CGraphicsPath>> paths;
+	for (uint32_t i = 0; i < kNumCells; ++i)
+		paths.emplace_back (owned (offscreen->createRoundRectGraphicsPath (cellRect (i), 4.)));
+
+	auto gradient = makeGradient ();
+	auto drawLinear = [&] (bool newGradientPerDraw) {
+		for (uint32_t i = 0; i < kNumCells; ++i)
+		{
+			auto r = cellRect (i);
+			auto g = newGradientPerDraw ? makeGradient () : gradient;
+			offscreen->fillLinearGradient (paths[i], *g, r.getTopLeft (), r.getBottomLeft ());
+		}
+	};
+	auto drawRadial = [&] (bool newGradientPerDraw) {
+		for (uint32_t i = 0; i < kNumCells; ++i)
+		{
+			auto r = cellRect (i);
+			auto g = newGradientPerDraw ? makeGradient () : gradient;
+			offscreen->fillRadialGradient (paths[i], *g, r.getCenter (), r.getWidth () / 2.,
+										   CPoint (-r.getWidth () / 4., -r.getHeight () / 4.));
+		}
+	};
+
+	auto linearRebuilt = PerfTest::measure (20, [&] () { drawLinear (true); });
+	auto linearCached = PerfTest::measure (20, [&] () { drawLinear (false); });
+	auto radialRebuilt = PerfTest::measure (20, [&] () { drawRadial (true); });
+	auto radialCached = PerfTest::measure (20, [&] () { drawRadial (false); });
+	offscreen->endDraw ();
+
+	context.report ("linear, new pattern per draw", linearRebuilt);
+	context.report ("linear, shared pattern", linearCached);
+	context.compare ("linear speedup", linearRebuilt, linearCached);
+	context.report ("radial, new pattern per draw", radialRebuilt);
+	context.report ("radial, shared pattern", radialCached);
+	context.compare ("radial speedup", radialRebuilt, radialCached);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,98 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/coffscreencontext.h"
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumPrimitives = 10000;
+static constexpr uint32_t kNumColumns = 100;
+static constexpr CCoord kCellSize = 8.;
+
+//------------------------------------------------------------------------
+CRect cellRect (uint32_t index)
+{
+	CRect r (0., 0., kCellSize - 1., kCellSize - 1.);
+	r.offset ((index % kNumColumns) * kCellSize, (index / kNumColumns) * kCellSize);
+	return r;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> makeIcon ()
+{
+	auto offscreen = COffscreenContext::create ({kCellSize, kCellSize});
+	offscreen->beginDraw ();
+	offscreen->setFillColor (kRedCColor);
+	offscreen->drawRect ({0., 0., kCellSize, kCellSize}, kDrawFilled);
+	offscreen->endDraw ();
+	return offscreen->getBitmap ();
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (GraphicsState, SmallPrimitives10k)
+{
+	CPoint size (kNumColumns * kCellSize, (kNumPrimitives / kNumColumns) * kCellSize);
+	auto offscreen = COffscreenContext::create (size);
+	auto icon = makeIcon ();
+	offscreen->beginDraw ();
+	offscreen->setDrawMode (kAntiAliasing);
+	offscreen->setLineWidth (1.);
+
+	auto sameState = PerfTest::measure (10, [&] () {
+		offscreen->setFillColor (kBlueCColor);
+		for (uint32_t i = 0; i < kNumPrimitives; ++i)
+			offscreen->drawRect (cellRect (i), kDrawFilled);
+	});
+	auto alternatingColors = PerfTest::measure (10, [&] () {
+		for (uint32_t i = 0; i < kNumPrimitives; ++i)
+		{
+			offscreen->setFillColor (i % 2 ? kBlueCColor : kGreenCColor);
+			offscreen->drawRect (cellRect (i), kDrawFilled);
+		}
+	});
+	auto lines = PerfTest::measure (10, [&] () {
+		offscreen->setFrameColor (kBlackCColor);
+		for (uint32_t i = 0; i < kNumPrimitives; ++i)
+		{
+			auto r = cellRect (i);
+			offscreen->drawLine (r.getTopLeft (), r.getBottomRight ());
+		}
+	});
+	auto bitmaps = PerfTest::measure (10, [&] () {
+		for (uint32_t i = 0; i < kNumPrimitives; ++i)
+			offscreen->drawBitmap (icon, cellRect (i));
+	});
+	auto clipped = PerfTest::measure (10, [&] () {
+		offscreen->setFillColor (kBlueCColor);
+		for (uint32_t i = 0; i < kNumPrimitives; ++i)
+		{
+			// like a view container drawing its children, one clip rect per row
+			auto r = cellRect (i);
+			if (i % kNumColumns == 0)
+				offscreen->setClipRect ({0., r.top, size.x, r.bottom});
+			offscreen->drawRect (r, kDrawFilled);
+		}
+		offscreen->resetClipRect ();
+	});
+	offscreen->endDraw ();
+
+	auto reportPrimitives = [&] (const char* name, const PerfTest::Result& result) {
+		context.report (name, result.iterationsPerSecond () * kNumPrimitives, "primitives/s");
+	};
+	reportPrimitives ("filled rects, same state", sameState);
+	reportPrimitives ("filled rects, alternating colors", alternatingColors);
+	reportPrimitives ("lines", lines);
+	reportPrimitives ("bitmaps", bitmaps);
+	reportPrimitives ("filled rects, clip change per row", clipped);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
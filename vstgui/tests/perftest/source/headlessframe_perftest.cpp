@@ -0,0 +1,253 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/contrib/paintflashingview.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/cvstguitimer.h"
+#include "vstgui/lib/drawprofiler.h"
+#include "vstgui/lib/events.h"
+#include "vstgui/lib/platform/platform_x11.h"
+#include <set>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr CCoord kWidth = 1920.;
+static constexpr CCoord kHeight = 1080.;
+static constexpr CCoord kCellSize = 24.;
+static constexpr uint32_t kFrameTime = 16;
+static constexpr uint32_t kNumFrames = 300;
+
+//------------------------------------------------------------------------
+/** a meter whose level follows the animation step */
+struct LevelView : CView
+{
+	explicit LevelView (const CRect& size, uint32_t index) : CView (size), index (index) {}
+
+	void setStep (uint32_t step)
+	{
+		auto newLevel = ((step + index) % 24) / 23.;
+		if (newLevel == level)
+			return;
+		level = newLevel;
+		invalid ();
+	}
+
+	void draw (CDrawContext* context) override
+	{
+		auto r = getViewSize ();
+		context->setFillColor (CColor (30, 30, 30));
+		context->drawRect (r, kDrawFilled);
+		r.top = r.bottom - r.getHeight () * level;
+		context->setFillColor (CColor (60, 200, 90));
+		context->drawRect (r, kDrawFilled);
+		setDirty (false);
+	}
+
+	void onMouseDownEvent (MouseDownEvent& event) override
+	{
+		++numMouseDowns;
+		event.consumed = true;
+	}
+
+	uint32_t index;
+	double level {0.};
+	uint32_t numMouseDowns {0};
+};
+
+//------------------------------------------------------------------------
+struct HeadlessEditor
+{
+	SharedPointer<CFrame> frame;
+	std::vector<LevelView*> views;
+	X11::IHeadlessFrame* headless {nullptr};
+
+	HeadlessEditor ()
+	{
+		frame = makeOwned<CFrame> (CRect (0., 0., kWidth, kHeight), nullptr);
+		frame->setBackgroundColor (kBlackCColor);
+		uint32_t index = 0;
+		for (CCoord top = 0.; top + kCellSize <= kHeight; top += kCellSize)
+		{
+			for (CCoord left = 0.; left + kCellSize <= kWidth; left += kCellSize)
+			{
+				CRect r (left, top, left + kCellSize, top + kCellSize);
+				auto view = new LevelView (r.inset (1., 1.), index++);
+				views.emplace_back (view);
+				frame->addView (view);
+			}
+		}
+		if (frame->open (nullptr, PlatformType::kHeadless))
+		{
+			// close () forgets the frame
+			frame->remember ();
+			headless = dynamic_cast<X11::IHeadlessFrame*> (frame->getPlatformFrame ());
+		}
+	}
+
+	~HeadlessEditor () noexcept
+	{
+		if (frame->isAttached ())
+			frame->close ();
+	}
+
+	void setStep (uint32_t step)
+	{
+		for (auto view : views)
+			view->setStep (step);
+	}
+};
+
+//------------------------------------------------------------------------
+bool equalPixels (CBitmap* bitmap1, CBitmap* bitmap2)
+{
+	auto access1 = owned (CBitmapPixelAccess::create (bitmap1));
+	auto access2 = owned (CBitmapPixelAccess::create (bitmap2));
+	if (!access1 || !access2 || access1->getBitmapWidth () != access2->getBitmapWidth () ||
+		access1->getBitmapHeight () != access2->getBitmapHeight ())
+		return false;
+	do
+	{
+		uint32_t value1, value2;
+		access1->getValue (value1);
+		access2->getValue (value2);
+		if (value1 != value2)
+			return false;
+	} while (++(*access1) && ++(*access2));
+	return true;
+}
+
+//------------------------------------------------------------------------
+uint32_t getPixel (CBitmap* bitmap, CPoint where)
+{
+	uint32_t value = 0;
+	auto access = owned (CBitmapPixelAccess::create (bitmap));
+	if (access && access->setPosition (static_cast<uint32_t> (where.x),
+									   static_cast<uint32_t> (where.y)))
+		access->getValue (value);
+	return value;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (HeadlessFrame, AnimatedMeters1080p)
+{
+	HeadlessEditor editor;
+	context.check ("headless frame opened", editor.headless != nullptr);
+	if (!editor.headless)
+		return;
+	auto headless = editor.headless;
+	auto initial = PerfTest::measure (1, [&] () { headless->drawDirtyRects (); });
+
+	// the animation is driven by a timer on the virtual clock
+	uint32_t step = 0;
+	auto timer = makeOwned<CVSTGUITimer> (
+		[&] (CVSTGUITimer*) { editor.setStep (++step); }, kFrameTime);
+	auto frames = PerfTest::measure (kNumFrames, [&] () { headless->advanceTime (kFrameTime); });
+	timer->stop ();
+	context.check ("timer fired once per frame", step == kNumFrames);
+
+	// the same state must result in the same pixels
+	auto snapshot1 = headless->createSnapshot ();
+	editor.setStep (0);
+	headless->drawDirtyRects ();
+	editor.setStep (step);
+	headless->drawDirtyRects ();
+	auto snapshot2 = headless->createSnapshot ();
+	context.check ("redraw matches the golden image", equalPixels (snapshot1, snapshot2));
+
+	auto view = editor.views[42];
+	MouseDownEvent mouseDown (view->getViewSize ().getCenter (),
+							  MouseEventButtonState (MouseButton::Left));
+	headless->dispatchEvent (mouseDown);
+	context.check ("synthetic mouse down reached the view", view->numMouseDowns == 1);
+
+	context.report ("views", static_cast<double> (editor.views.size ()), "views");
+	context.report ("initial full paint", initial);
+	context.report ("animated frame", frames);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (HeadlessFrame, InvalidationProvenance)
+{
+	if (!DrawProfiler::isAvailable ())
+	{
+		context.report ("skipped, compiled without VSTGUI_ENABLE_DRAW_PROFILER", 0., "");
+		return;
+	}
+	HeadlessEditor editor;
+	context.check ("headless frame opened", editor.headless != nullptr);
+	if (!editor.headless)
+		return;
+	auto headless = editor.headless;
+	auto& profiler = DrawProfiler::instance ();
+	headless->drawDirtyRects ();
+
+	uint32_t step = 0;
+	auto untraced = PerfTest::measure (kNumFrames, [&] () {
+		editor.setStep (++step);
+		headless->drawDirtyRects ();
+	});
+	profiler.setEnabled (true);
+	profiler.clear ();
+	auto traced = PerfTest::measure (kNumFrames, [&] () {
+		DrawProfiler::InvalidationTag tag ("setStep");
+		editor.setStep (++step);
+		headless->drawDirtyRects ();
+	});
+
+	// the ring buffer only holds the last frames, so only the last frame is checked
+	auto lastFrame = profiler.getFrameIndex () - 1;
+	auto stats = profiler.getInvalidationStatistics (lastFrame);
+	uint32_t numInvalidations = 0;
+	std::set<const void*> callSites;
+	bool attributed = !stats.empty ();
+	for (const auto& entry : stats)
+	{
+		numInvalidations += entry.count;
+		callSites.emplace (entry.callSite);
+		if (entry.frameIndex != lastFrame || !dynamic_cast<const LevelView*> (entry.view) ||
+			!entry.tag || std::string (entry.tag) != "setStep")
+			attributed = false;
+	}
+	context.check ("every invalidation attributed to its view and tag",
+				   attributed && numInvalidations == editor.views.size ());
+	context.check ("one call site", callSites.size () == 1 && *callSites.begin () != nullptr);
+	auto report = profiler.createInvalidationReport (lastFrame);
+	context.check ("invalidation report exported", report.find ("LevelView") != std::string::npos);
+
+	// paint flashing tints the repainted view until the flash time elapsed
+	auto flashing = new PaintFlashingView (editor.frame->getViewSize ());
+	editor.frame->addView (flashing);
+	headless->drawDirtyRects ();
+	auto changedView = editor.views[42];
+	auto unchangedView = editor.views[43];
+	auto changedPoint = changedView->getViewSize ().getTopLeft () + CPoint (1, 1);
+	auto unchangedPoint = unchangedView->getViewSize ().getTopLeft () + CPoint (1, 1);
+	changedView->setStep (++step);
+	headless->drawDirtyRects ();
+	auto tinted = headless->createSnapshot ();
+	headless->advanceTime (flashing->getFlashTime () + 100);
+	auto cleared = headless->createSnapshot ();
+	profiler.setEnabled (false);
+	profiler.clear ();
+	context.check ("repainted view was tinted",
+				   getPixel (tinted, changedPoint) != getPixel (cleared, changedPoint));
+	context.check ("other views were not tinted",
+				   getPixel (tinted, unchangedPoint) == getPixel (cleared, unchangedPoint));
+
+	context.report ("animated frame (untraced)", untraced);
+	context.report ("animated frame (traced)", traced);
+	context.compare ("tracing overhead", untraced, traced);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,96 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/contrib/keyboardview.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumTicks = 500;
+static constexpr uint32_t kEventsPerTick = 64;
+
+//------------------------------------------------------------------------
+class InvalidRectCollector : public CViewContainer
+{
+public:
+	using CViewContainer::CViewContainer;
+
+	void invalidRect (const CRect& rect) override { rects.emplace_back (rect); }
+
+	std::vector<CRect> rects;
+};
+
+//------------------------------------------------------------------------
+template <typename EventProc, typename TickProc>
+PerfTest::Result runKeyboard (EventProc&& eventProc, TickProc&& tickProc, uint64_t& numRects)
+{
+	CRect frameSize (0, 0, 52 * 24, 120);
+	auto frame = makeOwned<CFrame> (frameSize, nullptr);
+	auto root = new InvalidRectCollector (frameSize);
+	frame->addView (root);
+	auto keyboard = new KeyboardViewBase ();
+	keyboard->setWantsIdle (false);
+	keyboard->setViewSize (frameSize);
+	keyboard->setWhiteKeyWidth (24);
+	keyboard->setBlackKeyWidth (14);
+	keyboard->setBlackKeyHeight (70);
+	keyboard->setKeyRange (21, 88);
+	root->addView (keyboard);
+	frame->attached (frame);
+
+	auto offscreen = COffscreenContext::create (frameSize.getSize (), 2.);
+	offscreen->beginDraw ();
+	root->drawRect (offscreen, frameSize);
+
+	std::minstd_rand engine {42};
+	std::uniform_int_distribution<int> noteDist (21, 21 + 87);
+	std::bernoulli_distribution stateDist;
+	auto result = PerfTest::measure (kNumTicks, [&] () {
+		root->rects.clear ();
+		for (uint32_t i = 0; i < kEventsPerTick; ++i)
+			eventProc (keyboard, static_cast<KeyboardViewBase::NoteIndex> (noteDist (engine)),
+			           stateDist (engine));
+		tickProc (keyboard);
+		numRects += root->rects.size ();
+		for (const auto& r : root->rects)
+			root->drawRect (offscreen, r);
+	});
+	offscreen->endDraw ();
+	frame->removeAll ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (KeyboardView, DenseMidiInput)
+{
+	uint64_t directRects = 0;
+	auto directResult = runKeyboard (
+	    [] (auto keyboard, auto note, auto state) { keyboard->setKeyPressed (note, state); },
+	    [] (auto) {}, directRects);
+	uint64_t queuedRects = 0;
+	auto queuedResult = runKeyboard (
+	    [] (auto keyboard, auto note, auto state) { keyboard->queueKeyPressed (note, state); },
+	    [] (auto keyboard) { keyboard->processQueuedKeyStates (); }, queuedRects);
+
+	context.report ("setKeyPressed per event", directResult);
+	context.report ("setKeyPressed invalid rects/tick",
+	                static_cast<double> (directRects) / kNumTicks, "rects");
+	context.report ("queued per idle", queuedResult);
+	context.report ("queued invalid rects/tick", static_cast<double> (queuedRects) / kNumTicks,
+	                "rects");
+	context.compare ("queued speedup", directResult, queuedResult);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,194 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/contrib/meterbankview.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/controls/cvumeter.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumMeters = 256;
+static constexpr CCoord kMeterWidth = 6.;
+static constexpr CCoord kMeterGap = 1.;
+static constexpr CCoord kMeterHeight = 200.;
+static constexpr uint32_t kNumTicks = 500;
+
+//------------------------------------------------------------------------
+class InvalidRectCollector : public CViewContainer
+{
+public:
+	using CViewContainer::CViewContainer;
+
+	void invalidRect (const CRect& rect) override { rects.emplace_back (rect); }
+
+	std::vector<CRect> rects;
+};
+
+//------------------------------------------------------------------------
+struct MeterValues
+{
+	MeterValues () : values (kNumMeters, 0.f) {}
+
+	/** random walk, roughly like smoothed audio levels */
+	void next ()
+	{
+		for (auto& v : values)
+			v = std::clamp (v + dist (engine), 0.f, 1.f);
+	}
+
+	std::vector<float> values;
+	std::minstd_rand engine {42};
+	std::uniform_real_distribution<float> dist {-0.05f, 0.05f};
+};
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> makeBitmap (CColor color)
+{
+	auto offscreen = COffscreenContext::create ({kMeterWidth, kMeterHeight});
+	offscreen->beginDraw ();
+	offscreen->setFillColor (color);
+	offscreen->drawRect ({0., 0., kMeterWidth, kMeterHeight}, kDrawFilled);
+	offscreen->endDraw ();
+	return shared (offscreen->getBitmap ());
+}
+
+//------------------------------------------------------------------------
+struct Stats
+{
+	uint64_t numInvalidRects {0};
+	double invalidArea {0.};
+};
+
+//------------------------------------------------------------------------
+template <typename TickProc>
+PerfTest::Result runTicks (InvalidRectCollector* root, TickProc&& tickProc, Stats& stats)
+{
+	auto offscreen = COffscreenContext::create (root->getViewSize ().getSize ());
+	offscreen->beginDraw ();
+	root->drawRect (offscreen, root->getViewSize ());
+	auto result = PerfTest::measure (kNumTicks, [&] () {
+		root->rects.clear ();
+		tickProc ();
+		stats.numInvalidRects += root->rects.size ();
+		for (const auto& r : root->rects)
+		{
+			stats.invalidArea += r.getWidth () * r.getHeight ();
+			root->drawRect (offscreen, r);
+		}
+	});
+	offscreen->endDraw ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runVuMeters (Stats& stats, uint32_t numLed)
+{
+	CRect frameSize (0, 0, kNumMeters * (kMeterWidth + kMeterGap) - kMeterGap, kMeterHeight);
+	auto frame = makeOwned<CFrame> (frameSize, nullptr);
+	auto root = new InvalidRectCollector (frameSize);
+	frame->addView (root);
+
+	auto onBitmap = makeBitmap (kGreenCColor);
+	auto offBitmap = makeBitmap (kBlackCColor);
+	std::vector<CVuMeter*> meters;
+	for (uint32_t i = 0; i < kNumMeters; ++i)
+	{
+		CRect r (0, 0, kMeterWidth, kMeterHeight);
+		r.offset (i * (kMeterWidth + kMeterGap), 0);
+		// keep idle enabled, otherwise draw decays the value a second time after onIdle. The
+		// idle timer does not fire while the ticks are driven by hand.
+		auto meter = new CVuMeter (r, onBitmap, offBitmap, numLed);
+		meter->setDecreaseStepValue (0.f);
+		root->addView (meter);
+		meters.push_back (meter);
+	}
+	frame->attached (frame);
+
+	MeterValues values;
+	auto result = runTicks (root,
+	                        [&] () {
+		                        values.next ();
+		                        for (uint32_t i = 0; i < kNumMeters; ++i)
+		                        {
+			                        meters[i]->setValue (values.values[i]);
+			                        meters[i]->onIdle ();
+		                        }
+	                        },
+	                        stats);
+	frame->removeAll ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runMeterBank (Stats& stats, uint32_t numLed)
+{
+	CRect frameSize (0, 0, kNumMeters * (kMeterWidth + kMeterGap) - kMeterGap, kMeterHeight);
+	auto frame = makeOwned<CFrame> (frameSize, nullptr);
+	auto root = new InvalidRectCollector (frameSize);
+	frame->addView (root);
+
+	auto meterBank = new MeterBankView (frameSize, kNumMeters);
+	meterBank->setMeterGap (kMeterGap);
+	meterBank->setNumLed (static_cast<int32_t> (numLed));
+	meterBank->setDecreaseStepValue (0.f);
+	root->addView (meterBank);
+	frame->attached (frame);
+
+	MeterValues values;
+	auto result = runTicks (root,
+	                        [&] () {
+		                        values.next ();
+		                        meterBank->setMeterValues (values.values.data (), kNumMeters);
+		                        meterBank->onIdle ();
+	                        },
+	                        stats);
+	frame->removeAll ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+void runComparison (PerfTest::Context& context, uint32_t numLed)
+{
+	Stats vuMeterStats;
+	Stats meterBankStats;
+	auto vuMeterResult = runVuMeters (vuMeterStats, numLed);
+	auto meterBankResult = runMeterBank (meterBankStats, numLed);
+
+	context.report ("CVuMeter tick", vuMeterResult);
+	context.report ("CVuMeter invalid rects/tick",
+	                static_cast<double> (vuMeterStats.numInvalidRects) / kNumTicks, "rects");
+	context.report ("CVuMeter invalid area/tick", vuMeterStats.invalidArea / kNumTicks, "px");
+	context.report ("MeterBankView tick", meterBankResult);
+	context.report ("MeterBankView invalid rects/tick",
+	                static_cast<double> (meterBankStats.numInvalidRects) / kNumTicks, "rects");
+	context.report ("MeterBankView invalid area/tick", meterBankStats.invalidArea / kNumTicks,
+	                "px");
+	context.compare ("MeterBankView speedup", vuMeterResult, meterBankResult);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (MeterBank, Continuous256)
+{
+	runComparison (context, static_cast<uint32_t> (kMeterHeight));
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (MeterBank, Segmented256)
+{
+	runComparison (context, 20);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
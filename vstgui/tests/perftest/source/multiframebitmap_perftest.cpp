@@ -0,0 +1,76 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/controls/cknob.h"
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint16_t kNumFrames = 128;
+static constexpr CCoord kFrameSize = 64.;
+static constexpr double kScaleFactor = 2.;
+static constexpr uint32_t kIterations = 20000;
+
+//------------------------------------------------------------------------
+SharedPointer<CMultiFrameBitmap> makeKnobStrip ()
+{
+	CPoint size (kFrameSize, kFrameSize * kNumFrames);
+	auto offscreen = COffscreenContext::create (size, kScaleFactor);
+	offscreen->beginDraw ();
+	for (uint16_t i = 0; i < kNumFrames; ++i)
+	{
+		CRect r (0, i * kFrameSize, kFrameSize, (i + 1) * kFrameSize);
+		offscreen->setFillColor (CColor (static_cast<uint8_t> (i * 2), 100, 200, 255));
+		offscreen->drawEllipse (r.inset (4, 4), kDrawFilled);
+	}
+	offscreen->endDraw ();
+	auto strip = makeOwned<CMultiFrameBitmap> (offscreen->getBitmap ()->getPlatformBitmap ());
+	strip->setMultiFrameDesc ({{kFrameSize, kFrameSize}, kNumFrames, 1});
+	return strip;
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runKnob (CMultiFrameBitmap* strip)
+{
+	CRect r (0, 0, kFrameSize, kFrameSize);
+	auto knob = makeOwned<CAnimKnob> (r, nullptr, -1, strip);
+	auto offscreen = COffscreenContext::create (r.getSize (), kScaleFactor);
+	offscreen->beginDraw ();
+	uint32_t step = 0;
+	auto result = PerfTest::measure (kIterations, [&] () {
+		knob->setValueNormalized (static_cast<float> (step++ % kNumFrames) / (kNumFrames - 1));
+		knob->draw (offscreen);
+	});
+	offscreen->endDraw ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (MultiFrameBitmap, AnimKnob128Frames2x)
+{
+	auto strip = makeKnobStrip ();
+	MultiFrameBitmapCache::clear ();
+
+	auto stripResult = runKnob (strip);
+	strip->setFrameCacheEnabled (true);
+	auto cachedResult = runKnob (strip);
+	auto stats = MultiFrameBitmapCache::getStatistics ();
+	strip->setFrameCacheEnabled (false);
+
+	context.report ("draw from strip", stripResult);
+	context.report ("draw from frame cache", cachedResult);
+	context.report ("frame cache memory", static_cast<double> (stats.memoryUsage) / 1024., "KB");
+	context.report ("frame cache misses", static_cast<double> (stats.misses), "frames");
+	context.compare ("frame cache speedup", stripResult, cachedResult);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
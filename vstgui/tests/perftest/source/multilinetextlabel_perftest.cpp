@@ -0,0 +1,71 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/controls/ctextlabel.h"
+#include <string>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr CCoord kMaxWidth = 600.;
+static constexpr CCoord kMinWidth = 200.;
+
+//------------------------------------------------------------------------
+/** a help text with 20 paragraphs */
+UTF8String makeHelpText ()
+{
+	std::string text;
+	for (auto i = 0; i < 20; ++i)
+	{
+		text += "Paragraph " + std::to_string (i) +
+				": The filter cutoff frequency sets the point above which the harmonics of the "
+				"oscillators are attenuated. Use the envelope amount to modulate it over time, "
+				"and the key tracking to follow the played note.\n";
+	}
+	return UTF8String (std::move (text));
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CMultiLineTextLabel> makeLabel (const UTF8String& text, CCoord width)
+{
+	auto label = makeOwned<CMultiLineTextLabel> (CRect (0, 0, width, 1000));
+	label->setLineLayout (CMultiLineTextLabel::LineLayout::wrap);
+	label->setText (text);
+	return label;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (CMultiLineTextLabel, LiveResize)
+{
+	auto text = makeHelpText ();
+	auto label = makeLabel (text, kMaxWidth);
+	label->getMaxLineWidth ();
+
+	auto width = kMaxWidth;
+	auto nextWidth = [&] () {
+		width -= 1.;
+		if (width < kMinWidth)
+			width = kMaxWidth;
+		return width;
+	};
+	auto resize = PerfTest::measure (400, [&] () {
+		label->setViewSize (CRect (0, 0, nextWidth (), 1000));
+		label->getMaxLineWidth ();
+	});
+	width = kMaxWidth;
+	auto relayout = PerfTest::measure (400, [&] () {
+		makeLabel (text, nextWidth ())->getMaxLineWidth ();
+	});
+	context.report ("resize step, full relayout", relayout);
+	context.report ("resize step, cached paragraphs", resize);
+	context.compare ("paragraph cache speedup", relayout, resize);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
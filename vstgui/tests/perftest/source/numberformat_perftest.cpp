@@ -0,0 +1,166 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/controls/cparamdisplay.h"
+#include "vstgui/lib/cstring.h"
+#include <cstdio>
+#include <locale>
+#include <sstream>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumValues = 1000000;
+
+//------------------------------------------------------------------------
+std::vector<float> makeValues ()
+{
+	std::vector<float> values;
+	values.reserve (kNumValues);
+	for (uint32_t i = 0; i < kNumValues; ++i)
+		values.emplace_back (((i * 7919u) % 200000u) / 1000.f - 100.f);
+	return values;
+}
+
+//------------------------------------------------------------------------
+/** how CParamDisplay formatted values before */
+std::string formatPrintf (float value, uint8_t precision)
+{
+	char tmp[255];
+	char precisionStr[10];
+	snprintf (precisionStr, 10, "%%.%hhuf", precision);
+	snprintf (tmp, 255, precisionStr, value);
+	return tmp;
+}
+
+//------------------------------------------------------------------------
+/** how the standalone DefaultValueConverter formatted values before */
+std::string formatStream (double value, uint32_t precision)
+{
+	std::stringstream sstream;
+	sstream.imbue (std::locale::classic ());
+	sstream.precision (precision);
+	sstream << std::showpoint << std::fixed << value;
+	return sstream.str ();
+}
+
+//------------------------------------------------------------------------
+struct Display : CParamDisplay
+{
+	using CParamDisplay::CParamDisplay;
+	using CParamDisplay::getValueString;
+};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (NumberFormat, FormatValues)
+{
+	auto values = makeValues ();
+	char buffer[64];
+
+	bool sameAsPrintf = true;
+	bool sameAsStream = true;
+	for (uint32_t i = 0; i < kNumValues; i += 997)
+	{
+		auto length = formatNumber (buffer, buffer + sizeof (buffer), values[i], 2);
+		sameAsPrintf &= formatPrintf (values[i], 2) == std::string (buffer, length);
+		length = formatNumber (buffer, buffer + sizeof (buffer), values[i], 6);
+		sameAsStream &= formatStream (values[i], 6) == std::string (buffer, length);
+	}
+	context.check ("same output as snprintf", sameAsPrintf);
+	context.check ("same output as std::stringstream", sameAsStream);
+
+	size_t index = 0;
+	size_t numChars = 0;
+	auto printfResult = PerfTest::measure (kNumValues, [&] () {
+		numChars += formatPrintf (values[index], 2).size ();
+		index = (index + 1) % kNumValues;
+	});
+	auto stream = PerfTest::measure (kNumValues / 4, [&] () {
+		numChars += formatStream (values[index], 2).size ();
+		index = (index + 1) % kNumValues;
+	});
+	auto allocationsBefore = PerfTest::getNumAllocations ();
+	auto format = PerfTest::measure (kNumValues, [&] () {
+		numChars += formatNumber (buffer, buffer + sizeof (buffer), values[index], 2);
+		index = (index + 1) % kNumValues;
+	});
+	auto allocations = PerfTest::getNumAllocations () - allocationsBefore;
+	context.report ("snprintf", printfResult);
+	context.report ("std::stringstream", stream);
+	context.report ("formatNumber", format);
+	context.compare ("formatNumber speedup to snprintf", printfResult, format);
+	context.report ("allocations of formatNumber", static_cast<double> (allocations),
+					"allocations");
+	context.check ("one million values per second", format.iterationsPerSecond () > 1000000.);
+	context.check ("characters written", numChars > 0);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (NumberFormat, ParseValues)
+{
+	std::vector<std::string> strings;
+	for (auto value : makeValues ())
+		strings.emplace_back (formatPrintf (value, 3));
+
+	size_t index = 0;
+	double sum = 0.;
+	auto stream = PerfTest::measure (kNumValues / 4, [&] () {
+		std::istringstream sstream (strings[index]);
+		sstream.imbue (std::locale::classic ());
+		double value;
+		sstream >> value;
+		sum += value;
+		index = (index + 1) % kNumValues;
+	});
+	auto parse = PerfTest::measure (kNumValues, [&] () {
+		const auto& str = strings[index];
+		if (auto value = parseNumber (str.data (), str.data () + str.size ()))
+			sum += *value;
+		index = (index + 1) % kNumValues;
+	});
+	context.report ("std::istringstream", stream);
+	context.report ("parseNumber", parse);
+	context.compare ("parseNumber speedup", stream, parse);
+	context.check ("values parsed", sum != 0.);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (NumberFormat, ParamDisplayReadout)
+{
+	auto values = makeValues ();
+	auto display = makeOwned<Display> (CRect (0, 0, 60, 20));
+	display->setMin (-100.f);
+	display->setMax (100.f);
+	display->setPrecision (2);
+
+	size_t index = 0;
+	size_t numChars = 0;
+	auto changing = PerfTest::measure (kNumValues, [&] () {
+		display->setValue (values[index]);
+		numChars += display->getValueString ().length ();
+		index = (index + 1) % kNumValues;
+	});
+	display->setValue (values[0]);
+	display->getValueString ();
+	auto allocationsBefore = PerfTest::getNumAllocations ();
+	auto unchanged = PerfTest::measure (kNumValues, [&] () {
+		numChars += display->getValueString ().length ();
+	});
+	auto allocations = PerfTest::getNumAllocations () - allocationsBefore;
+	context.report ("format changing value", changing);
+	context.report ("format unchanged value", unchanged);
+	context.report ("allocations of unchanged value", static_cast<double> (allocations),
+					"allocations");
+	context.check ("no allocations for unchanged value", allocations == 0);
+	context.check ("characters written", numChars > 0);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,101 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/** @page How-to write performance tests
+
+Performance tests are small benchmark functions which are registered with the PERF_TEST macro and
+run by the perftest executable. Pass a part of the suite name on the command line to only run
+the matching tests.
+
+	#include "perftest.h"
+
+	PERF_TEST (CRect, Offset)
+	{
+		CRect r;
+		auto result = PerfTest::measure (1000000, [&] () { r.offset (1, 1); });
+		context.report ("offset", result);
+	}
+*/
+
+namespace VSTGUI {
+namespace PerfTest {
+
+//------------------------------------------------------------------------
+struct Result
+{
+	uint64_t iterations {0};
+	double totalSeconds {0.};
+
+	double nanoSecondsPerIteration () const
+	{
+		return iterations ? (totalSeconds * 1000000000.) / iterations : 0.;
+	}
+	double iterationsPerSecond () const { return totalSeconds > 0. ? iterations / totalSeconds : 0.; }
+};
+
+//------------------------------------------------------------------------
+/** call proc iterations times and return the time it took */
+template <typename Proc>
+inline Result measure (uint64_t iterations, Proc&& proc)
+{
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now ();
+	for (uint64_t i = 0; i < iterations; ++i)
+		proc ();
+	auto end = Clock::now ();
+	return {iterations, std::chrono::duration<double> (end - start).count ()};
+}
+
+//------------------------------------------------------------------------
+/** the number of heap allocations done via operator new since the start of the process */
+uint64_t getNumAllocations ();
+
+//------------------------------------------------------------------------
+class Context
+{
+public:
+	/** print a measured result */
+	void report (const char* name, const Result& result);
+	/** print a plain value, i.e. a counter */
+	void report (const char* name, double value, const char* unit);
+	/** print the speedup of result against baseline */
+	void compare (const char* name, const Result& baseline, const Result& result);
+	/** print if the condition is met, the perftest executable fails if one check failed */
+	void check (const char* name, bool condition);
+
+	bool hasFailedChecks () const { return failedChecks; }
+
+private:
+	bool failedChecks {false};
+};
+
+using TestFunction = std::function<void (Context&)>;
+
+//------------------------------------------------------------------------
+struct Registrar
+{
+	Registrar (std::string&& suite, std::string&& name, TestFunction&& func);
+};
+
+#define VSTGUI_PERFTEST_MAKE_STRING_PRIVATE_DONT_USE(x) #x
+#define VSTGUI_PERFTEST_MAKE_STRING(x) VSTGUI_PERFTEST_MAKE_STRING_PRIVATE_DONT_USE (x)
+
+//------------------------------------------------------------------------
+#define PERF_TEST(suite, name)                                                                     \
+	static void perfTest##suite##name (VSTGUI::PerfTest::Context& context);                       \
+	static VSTGUI::PerfTest::Registrar registerPerfTest##suite##name (                             \
+	    VSTGUI_PERFTEST_MAKE_STRING (suite), VSTGUI_PERFTEST_MAKE_STRING (name),                   \
+	    [] (VSTGUI::PerfTest::Context& context) { perfTest##suite##name (context); });            \
+	void perfTest##suite##name (VSTGUI::PerfTest::Context& context)
+
+//------------------------------------------------------------------------
+} // PerfTest
+} // VSTGUI
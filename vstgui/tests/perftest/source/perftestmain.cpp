@@ -0,0 +1,143 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/vstguiinit.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif WINDOWS
+struct IUnknown;
+#include <windows.h>
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace PerfTest {
+
+//------------------------------------------------------------------------
+struct Test
+{
+	std::string suite;
+	std::string name;
+	TestFunction func;
+};
+
+//------------------------------------------------------------------------
+static std::vector<Test>& getTests ()
+{
+	static std::vector<Test> tests;
+	return tests;
+}
+
+//------------------------------------------------------------------------
+static std::atomic<uint64_t> gNumAllocations {0};
+
+//------------------------------------------------------------------------
+uint64_t getNumAllocations ()
+{
+	return gNumAllocations.load (std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+Registrar::Registrar (std::string&& suite, std::string&& name, TestFunction&& func)
+{
+	getTests ().push_back ({std::move (suite), std::move (name), std::move (func)});
+}
+
+//------------------------------------------------------------------------
+void Context::report (const char* name, const Result& result)
+{
+	printf ("\t\t%-40s %12.1f ns/iteration %14.1f iterations/s\n", name,
+	        result.nanoSecondsPerIteration (), result.iterationsPerSecond ());
+}
+
+//------------------------------------------------------------------------
+void Context::report (const char* name, double value, const char* unit)
+{
+	printf ("\t\t%-40s %12.1f %s\n", name, value, unit);
+}
+
+//------------------------------------------------------------------------
+void Context::compare (const char* name, const Result& baseline, const Result& result)
+{
+	auto base = baseline.nanoSecondsPerIteration ();
+	auto current = result.nanoSecondsPerIteration ();
+	printf ("\t\t%-40s %12.2fx\n", name, current > 0. ? base / current : 0.);
+}
+
+//------------------------------------------------------------------------
+void Context::check (const char* name, bool condition)
+{
+	printf ("\t\t%-40s %12s\n", name, condition ? "ok" : "FAILED");
+	if (!condition)
+		failedChecks = true;
+}
+
+//------------------------------------------------------------------------
+static int run (const char* filter)
+{
+	Context context;
+	std::string lastSuite;
+	for (auto& test : getTests ())
+	{
+		if (filter && test.suite.find (filter) == std::string::npos)
+			continue;
+		if (test.suite != lastSuite)
+		{
+			printf ("%s\n", test.suite.data ());
+			lastSuite = test.suite;
+		}
+		printf ("\t%s\n", test.name.data ());
+		test.func (context);
+	}
+	return context.hasFailedChecks () ? 1 : 0;
+}
+
+//------------------------------------------------------------------------
+} // PerfTest
+} // VSTGUI
+
+//------------------------------------------------------------------------
+void* operator new (std::size_t size)
+{
+	VSTGUI::PerfTest::gNumAllocations.fetch_add (1, std::memory_order_relaxed);
+	if (auto ptr = std::malloc (size ? size : 1))
+		return ptr;
+	throw std::bad_alloc ();
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* ptr) noexcept
+{
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+void operator delete (void* ptr, std::size_t) noexcept
+{
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	CoInitialize (nullptr);
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	auto cleanup = VSTGUI::finally ([] () { VSTGUI::exit (); });
+
+	return VSTGUI::PerfTest::run (argc > 1 ? argv[1] : nullptr);
+}
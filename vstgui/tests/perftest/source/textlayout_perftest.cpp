@@ -0,0 +1,101 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cdrawmethods.h"
+#include "vstgui/lib/cfont.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/platform/iplatformfont.h"
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumStrings = 1000;
+
+//------------------------------------------------------------------------
+std::vector<UTF8String> makeStrings ()
+{
+	std::vector<UTF8String> strings;
+	for (uint32_t i = 0; i < kNumStrings; ++i)
+		strings.emplace_back ("Parameter " + std::to_string (i) + " = -" +
+							  std::to_string (i * 0.125) + " dB");
+	return strings;
+}
+
+//------------------------------------------------------------------------
+/** the tail truncation as it was done before text layouts, one measurement per removed character */
+UTF8String truncateLinear (const UTF8String& text, const IFontPainter* painter, CCoord maxWidth)
+{
+	auto width = painter->getStringWidth (nullptr, text.getPlatformString (), true);
+	UTF8String result (text);
+	auto right = text.end ();
+	while (width > maxWidth && right != text.begin ())
+	{
+		--right;
+		result = UTF8String (std::string (text.begin ().base (), right.base ()) + "..");
+		width = painter->getStringWidth (nullptr, result.getPlatformString (), true);
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (TextLayout, DrawAlignedStrings)
+{
+	auto strings = makeStrings ();
+	CRect size (0, 0, 200, 20);
+	auto offscreen = COffscreenContext::create (size.getSize ());
+	offscreen->beginDraw ();
+	offscreen->setFont (kNormalFont);
+	offscreen->setFontColor (kBlackCColor);
+	auto painter = kNormalFont->getFontPainter ();
+	auto device = offscreen->getPlatformDeviceContext ();
+
+	size_t index = 0;
+	auto measureAndDraw = PerfTest::measure (20 * kNumStrings, [&] () {
+		auto string = strings[index].getPlatformString ();
+		auto width = painter->getStringWidth (device, string, true);
+		painter->drawString (device, string, CPoint (size.right - width, 15.), kBlackCColor);
+		index = (index + 1) % kNumStrings;
+	});
+	auto layout = PerfTest::measure (20 * kNumStrings, [&] () {
+		offscreen->drawString (strings[index].getPlatformString (), size, kRightText);
+		index = (index + 1) % kNumStrings;
+	});
+	offscreen->endDraw ();
+	context.report ("getStringWidth + drawString", measureAndDraw);
+	context.report ("drawString via text layout", layout);
+	context.compare ("text layout speedup", measureAndDraw, layout);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (TextLayout, TruncateTail)
+{
+	UTF8String text ("A rather long parameter name which needs to be truncated in the display");
+	auto painter = kNormalFont->getFontPainter ();
+	auto width = painter->getStringWidth (nullptr, text.getPlatformString (), true);
+	auto maxWidth = width / 3.;
+
+	auto expected = truncateLinear (text, painter, maxWidth);
+	auto truncated = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text,
+														kNormalFont, maxWidth);
+	context.check ("same result as linear truncation", expected == truncated);
+
+	auto linear = PerfTest::measure (200, [&] () { truncateLinear (text, painter, maxWidth); });
+	auto binary = PerfTest::measure (200, [&] () {
+		CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text, kNormalFont,
+										   maxWidth);
+	});
+	context.report ("linear truncation", linear);
+	context.report ("binary search truncation", binary);
+	context.compare ("binary search speedup", linear, binary);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
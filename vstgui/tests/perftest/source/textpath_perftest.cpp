@@ -0,0 +1,63 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cfont.h"
+#include "vstgui/lib/cgradient.h"
+#include "vstgui/lib/cgraphicspath.h"
+#include "vstgui/lib/coffscreencontext.h"
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+PERF_TEST (TextPath, LargeStaticTitle)
+{
+	auto font = makeOwned<CFontDesc> (*kSystemFont);
+	font->setSize (48.);
+	font->setStyle (kBoldFace);
+	const auto title = "Spectral Delay";
+
+	CRect titleRect (0., 0., 480., 64.);
+	auto offscreen = COffscreenContext::create (titleRect.getSize ());
+	offscreen->beginDraw ();
+	offscreen->setDrawMode (kAntiAliasing);
+	offscreen->setFont (font);
+	offscreen->setFontColor (kWhiteCColor);
+
+	SharedPointer<CGraphicsPath> path;
+	auto create = PerfTest::measure (100, [&] () {
+		path = owned (offscreen->createTextPath (font, title));
+	});
+	context.check ("text path created", path != nullptr);
+	if (!path)
+	{
+		offscreen->endDraw ();
+		return;
+	}
+	auto bounds = path->getBoundingBox ();
+	context.check ("text path has outlines", !bounds.isEmpty ());
+
+	auto gradient = owned (CGradient::create (0., 1., kWhiteCColor, kGreyCColor));
+	auto drawString = PerfTest::measure (1000, [&] () {
+		offscreen->drawString (title, titleRect, kLeftText);
+	});
+	auto drawPath = PerfTest::measure (1000, [&] () {
+		offscreen->setFillColor (kWhiteCColor);
+		offscreen->drawGraphicsPath (path, CDrawContext::kPathFilled);
+	});
+	auto fillGradient = PerfTest::measure (1000, [&] () {
+		offscreen->fillLinearGradient (path, *gradient, bounds.getTopLeft (),
+									   bounds.getBottomLeft ());
+	});
+	offscreen->endDraw ();
+
+	context.report ("createTextPath", create);
+	context.report ("drawString", drawString);
+	context.report ("fill cached text path", drawPath);
+	context.report ("fill cached text path with gradient", fillGradient);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,114 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cdrawcontext.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/platform/iplatformframecallback.h"
+#include "vstgui/lib/platform/linux/cairographicscontext.h"
+#include "vstgui/lib/platform/linux/cairotilerenderer.h"
+#include "vstgui/lib/platform/platformfactory.h"
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr CCoord kWidth = 3840.;
+static constexpr CCoord kHeight = 2160.;
+static constexpr CCoord kPanelWidth = 96.;
+static constexpr CCoord kPanelHeight = 90.;
+
+//------------------------------------------------------------------------
+/** a channel strip like panel which only draws shapes */
+struct PanelView : CView
+{
+	explicit PanelView (const CRect& size) : CView (size) { setThreadSafeToDraw (true); }
+
+	void draw (CDrawContext* context) override
+	{
+		auto r = getViewSize ();
+		context->setDrawMode (kAntiAliasing);
+		context->setFillColor (CColor (40, 44, 52));
+		context->setFrameColor (CColor (90, 96, 110));
+		context->setLineWidth (1.);
+		context->drawRect (r, kDrawFilledAndStroked);
+
+		auto knob = CRect (0., 0., 28., 28.).offset (r.left + 8., r.top + 8.);
+		for (auto i = 0; i < 3; ++i)
+		{
+			context->setFillColor (CColor (70, 120, 200));
+			context->drawEllipse (knob, kDrawFilledAndStroked);
+			context->drawArc (knob, 135.f, 45.f, kDrawStroked);
+			knob.offset (28., 0.);
+		}
+		auto meter = CRect (0., 0., 6., 40.).offset (r.left + 8., r.top + 44.);
+		for (auto i = 0; i < 10; ++i)
+		{
+			context->setFillColor (i % 3 ? CColor (60, 200, 90) : CColor (220, 180, 40));
+			context->drawRect (meter, kDrawFilled);
+			meter.offset (8., 0.);
+		}
+		setDirty (false);
+	}
+};
+
+//------------------------------------------------------------------------
+SharedPointer<CFrame> makeFrame ()
+{
+	auto frame = makeOwned<CFrame> (CRect (0., 0., kWidth, kHeight), nullptr);
+	frame->setBackgroundColor (kBlackCColor);
+	frame->setThreadSafeToDraw (true);
+	for (CCoord top = 0.; top + kPanelHeight <= kHeight; top += kPanelHeight)
+	{
+		for (CCoord left = 0.; left + kPanelWidth <= kWidth; left += kPanelWidth)
+		{
+			CRect r (left, top, left + kPanelWidth, top + kPanelHeight);
+			frame->addView (new PanelView (r.inset (1., 1.)));
+		}
+	}
+	return frame;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (TileRenderer, FullPaint4K)
+{
+	auto frame = makeFrame ();
+	IPlatformFrameCallback* callback = frame;
+	auto device = std::static_pointer_cast<CairoGraphicsDevice> (
+		getPlatformFactory ().getGraphicsDeviceFactory ().getDeviceForScreen (
+			DefaultScreenIdentifier));
+	Cairo::SurfaceHandle target (cairo_image_surface_create (
+		CAIRO_FORMAT_ARGB32, static_cast<int> (kWidth), static_cast<int> (kHeight)));
+	CRect fullRect (0., 0., kWidth, kHeight);
+
+	auto drawContext = std::make_shared<CairoGraphicsDeviceContext> (*device, target);
+	auto singleThread = PerfTest::measure (5, [&] () {
+		drawContext->beginDraw ();
+		callback->platformDrawRects (drawContext, 1., {fullRect});
+		drawContext->endDraw ();
+	});
+
+	Cairo::TileRenderer tileRenderer;
+	bool prepared = true;
+	auto tiles = PerfTest::measure (5, [&] () {
+		prepared &= callback->platformPrepareConcurrentDraw (fullRect);
+		tileRenderer.draw (target, *device, fullRect,
+						   [&] (const PlatformGraphicsDeviceContextPtr& tileContext,
+								const CRect& tileRect) {
+							   callback->platformDrawRects (tileContext, 1., {tileRect});
+						   });
+	});
+
+	context.check ("all views are thread-safe to draw", prepared);
+	context.report ("full paint 3840x2160, one thread", singleThread);
+	context.report ("full paint 3840x2160, tiles", tiles);
+	context.report ("threads", static_cast<double> (tileRenderer.getNumThreads ()), "threads");
+	context.compare ("tiles speedup", singleThread, tiles);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
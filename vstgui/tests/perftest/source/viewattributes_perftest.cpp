@@ -0,0 +1,77 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/controls/ctextlabel.h"
+#include "vstgui/lib/cviewcontainer.h"
+#include "vstgui/uidescription/icontroller.h"
+#include <cstring>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kNumControls = 10000;
+static constexpr CViewAttributeID kViewNameAttribute = 'cvcr';
+static constexpr IdStringPtr kViewName = "CTextLabel";
+static constexpr const char* kTooltip = "Cutoff frequency of the filter";
+
+//------------------------------------------------------------------------
+struct Controller : IController, NonAtomicReferenceCounted
+{
+	void valueChanged (CControl* pControl) override {}
+};
+
+//------------------------------------------------------------------------
+/** creates the controls with the attributes the UIViewFactory and a sub controller would set */
+SharedPointer<CViewContainer> createTemplate (Controller* controller)
+{
+	auto container = makeOwned<CViewContainer> (CRect (0, 0, 1000, 1000));
+	for (uint32_t i = 0; i < kNumControls; ++i)
+	{
+		auto label = new CTextLabel (CRect (0, 0, 10, 10));
+		label->setAttribute (kViewNameAttribute, kViewName);
+		label->setTooltipText (kTooltip);
+		controller->remember ();
+		label->setAttribute (kCViewControllerAttribute, static_cast<IController*> (controller));
+		container->addView (label);
+	}
+	return container;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewAttributes, Template10k)
+{
+	auto controller = makeOwned<Controller> ();
+
+	auto allocationsBefore = PerfTest::getNumAllocations ();
+	auto container = createTemplate (controller);
+	auto numAllocations = PerfTest::getNumAllocations () - allocationsBefore;
+	context.report ("allocations per control",
+	                static_cast<double> (numAllocations) / kNumControls, "allocations");
+	container = nullptr;
+
+	auto create = PerfTest::measure (10, [&] () { createTemplate (controller); });
+	context.report ("create and destroy 10k controls", create);
+
+	container = createTemplate (controller);
+	uint32_t numFound = 0;
+	auto lookup = PerfTest::measure (100, [&] () {
+		container->forEachChild ([&] (CView* view) {
+			IController* c = nullptr;
+			IdStringPtr name = nullptr;
+			if (view->getAttribute (kCViewControllerAttribute, c) &&
+			    view->getAttribute (kViewNameAttribute, name))
+				++numFound;
+		});
+	});
+	context.report ("lookup controller and view name of 10k controls", lookup);
+	context.check ("all attributes found", numFound == 100 * kNumControls);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
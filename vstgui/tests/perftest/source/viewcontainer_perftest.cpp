@@ -0,0 +1,294 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/cframe.h"
+#include "vstgui/lib/coffscreencontext.h"
+#include "vstgui/lib/controls/ctextlabel.h"
+#include "vstgui/lib/events.h"
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr uint32_t kGridSize = 32; // 1024 child views
+static constexpr CCoord kCellSize = 12.;
+static constexpr CCoord kViewSize = 10.;
+static constexpr uint32_t kNumPasses = 20;
+
+//------------------------------------------------------------------------
+struct GridFrame
+{
+	GridFrame (bool useHitTestIndex)
+	{
+		CRect size (0, 0, kGridSize * kCellSize, kGridSize * kCellSize);
+		frame = makeOwned<CFrame> (size, nullptr);
+		grid = new CViewContainer (size);
+		grid->setHitTestIndexEnabled (useHitTestIndex);
+		for (uint32_t y = 0; y < kGridSize; ++y)
+		{
+			for (uint32_t x = 0; x < kGridSize; ++x)
+			{
+				CRect r (0, 0, kViewSize, kViewSize);
+				r.offset (x * kCellSize, y * kCellSize);
+				grid->addView (new CView (r));
+			}
+		}
+		frame->addView (grid);
+		frame->attached (frame);
+	}
+
+	~GridFrame () { frame->close (); }
+
+	SharedPointer<CFrame> frame;
+	CViewContainer* grid;
+};
+
+//------------------------------------------------------------------------
+/** mouse positions scanning the whole grid row by row, one point per pixel */
+std::vector<CPoint> makeMousePath ()
+{
+	std::vector<CPoint> path;
+	auto extent = kGridSize * kCellSize;
+	for (CCoord y = 0.5; y < extent; y += kCellSize / 2.)
+	{
+		for (CCoord x = 0.5; x < extent; x += 1.)
+			path.emplace_back (x, y);
+	}
+	return path;
+}
+
+//------------------------------------------------------------------------
+template <typename Proc>
+PerfTest::Result runPath (const std::vector<CPoint>& path, Proc&& proc)
+{
+	size_t index = 0;
+	return PerfTest::measure (kNumPasses * path.size (), [&] () {
+		proc (path[index]);
+		if (++index == path.size ())
+			index = 0;
+	});
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runMouseMove (bool useHitTestIndex, const std::vector<CPoint>& path)
+{
+	GridFrame grid (useHitTestIndex);
+	return runPath (path, [&] (const CPoint& p) {
+		MouseMoveEvent event;
+		event.mousePosition = p;
+		grid.frame->dispatchEvent (event);
+	});
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runGetViewAt (bool useHitTestIndex, const std::vector<CPoint>& path)
+{
+	GridFrame grid (useHitTestIndex);
+	auto options = GetViewOptions ().deep ().mouseEnabled ().includeViewContainer ();
+	return runPath (path, [&] (const CPoint& p) { grid.frame->getViewAt (p, options); });
+}
+
+//------------------------------------------------------------------------
+PerfTest::Result runHitTestSubViews (bool useHitTestIndex, const std::vector<CPoint>& path)
+{
+	GridFrame grid (useHitTestIndex);
+	MouseDownEvent event;
+	return runPath (path, [&] (const CPoint& p) { grid.frame->hitTestSubViews (p, event); });
+}
+
+//------------------------------------------------------------------------
+static constexpr uint32_t kNumTreeContainers = 100;
+static constexpr uint32_t kNumTreeViewsPerContainer = 100; // 10k views
+static constexpr CCoord kTreeViewSize = 8.;
+
+//------------------------------------------------------------------------
+/** 100 containers side by side with 100 views or controls each */
+struct ViewTree
+{
+	ViewTree (bool useControls = false)
+	{
+		auto containerWidth = kTreeViewSize * 10.;
+		CRect size (0, 0, containerWidth * 10., containerWidth * 10.);
+		frame = makeOwned<CFrame> (size, nullptr);
+		for (uint32_t c = 0; c < kNumTreeContainers; ++c)
+		{
+			CRect r (0, 0, containerWidth, containerWidth);
+			r.offset ((c % 10) * containerWidth, (c / 10) * containerWidth);
+			auto container = new CViewContainer (r);
+			container->setTransparency (true);
+			for (uint32_t i = 0; i < kNumTreeViewsPerContainer; ++i)
+			{
+				CRect vr (0, 0, kTreeViewSize, kTreeViewSize);
+				vr.offset ((i % 10) * kTreeViewSize, (i / 10) * kTreeViewSize);
+				CView* view = nullptr;
+				if (useControls)
+				{
+					auto control = new CTextLabel (vr);
+					controls.push_back (control);
+					view = control;
+				}
+				else
+					view = new CView (vr);
+				container->addView (view);
+				views.push_back (view);
+			}
+			frame->addView (container);
+		}
+		frame->attached (frame);
+	}
+
+	~ViewTree () { frame->close (); }
+
+	SharedPointer<CFrame> frame;
+	std::vector<CView*> views;
+	std::vector<CControl*> controls;
+};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, HitTestIndexMatchesLinearSearch)
+{
+	GridFrame linear (false);
+	GridFrame indexed (true);
+	auto options = GetViewOptions ().deep ().mouseEnabled ();
+	bool equal = true;
+	for (const auto& p : makeMousePath ())
+	{
+		auto view1 = linear.frame->getViewAt (p, options);
+		auto view2 = indexed.frame->getViewAt (p, options);
+		if ((view1 == nullptr) != (view2 == nullptr) ||
+		    (view1 && view1->getViewSize () != view2->getViewSize ()))
+		{
+			equal = false;
+			break;
+		}
+	}
+	context.check ("same views found", equal);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, MouseMoveDenseGrid)
+{
+	auto path = makeMousePath ();
+	auto linear = runMouseMove (false, path);
+	auto indexed = runMouseMove (true, path);
+	context.report ("mouse move (linear)", linear);
+	context.report ("mouse move (hit test index)", indexed);
+	context.compare ("hit test index speedup", linear, indexed);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, GetViewAtDenseGrid)
+{
+	auto path = makeMousePath ();
+	auto linear = runGetViewAt (false, path);
+	auto indexed = runGetViewAt (true, path);
+	context.report ("getViewAt (linear)", linear);
+	context.report ("getViewAt (hit test index)", indexed);
+	context.compare ("hit test index speedup", linear, indexed);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, HitTestSubViewsDenseGrid)
+{
+	auto path = makeMousePath ();
+	auto linear = runHitTestSubViews (false, path);
+	auto indexed = runHitTestSubViews (true, path);
+	context.report ("hitTestSubViews (linear)", linear);
+	context.report ("hitTestSubViews (hit test index)", indexed);
+	context.compare ("hit test index speedup", linear, indexed);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kDraw)
+{
+	ViewTree tree;
+	auto size = tree.frame->getViewSize ();
+	auto offscreen = COffscreenContext::create (size.getSize ());
+	offscreen->beginDraw ();
+	auto result = PerfTest::measure (100, [&] () { tree.frame->drawRect (offscreen, size); });
+	offscreen->endDraw ();
+	context.report ("draw 10k views", result);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kHitTest)
+{
+	ViewTree tree;
+	auto path = makeMousePath ();
+	auto options = GetViewOptions ().deep ().mouseEnabled ();
+	auto result = runPath (path, [&] (const CPoint& p) { tree.frame->getViewAt (p, options); });
+	context.report ("getViewAt in 10k views", result);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kDirtyScan)
+{
+	ViewTree tree;
+	auto clean = PerfTest::measure (1000, [&] () { tree.frame->isDirty (); });
+	context.report ("isDirty, nothing dirty", clean);
+	// the last view is found last
+	tree.views.back ()->setDirty (true);
+	auto dirty = PerfTest::measure (1000, [&] () { tree.frame->isDirty (); });
+	context.report ("isDirty, last view dirty", dirty);
+	tree.views.back ()->setDirty (false);
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kIdle)
+{
+	ViewTree tree;
+	tree.frame->invalidateDirtyViews ();
+	auto clean = PerfTest::measure (1000, [&] () { tree.frame->invalidateDirtyViews (); });
+	context.report ("invalidateDirtyViews, nothing dirty", clean);
+	size_t index = 0;
+	auto oneDirty = PerfTest::measure (1000, [&] () {
+		tree.views[index]->setDirty (true);
+		tree.frame->invalidateDirtyViews ();
+		index = (index + 7919) % tree.views.size ();
+	});
+	context.report ("invalidateDirtyViews, one view dirty", oneDirty);
+	context.check ("no dirty views left", !tree.frame->isDirty ());
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kControlsIdle)
+{
+	ViewTree tree (true);
+	tree.frame->invalidateDirtyViews ();
+	auto clean = PerfTest::measure (1000, [&] () { tree.frame->invalidateDirtyViews (); });
+	context.report ("invalidateDirtyViews, no control changed", clean);
+	context.check ("controls are tracked", !tree.frame->hasUntrackedDirtyViews ());
+	size_t index = 0;
+	auto oneChanged = PerfTest::measure (1000, [&] () {
+		auto control = tree.controls[index];
+		control->setValue (control->getValue () > 0.5f ? 0.f : 1.f);
+		tree.frame->invalidateDirtyViews ();
+		index = (index + 7919) % tree.controls.size ();
+	});
+	context.report ("invalidateDirtyViews, one control value changed", oneChanged);
+	context.check ("no dirty controls left", !tree.frame->isDirty ());
+}
+
+//------------------------------------------------------------------------
+PERF_TEST (ViewContainer, Tree10kAddRemove)
+{
+	ViewTree tree;
+	auto container = tree.frame->getView (0)->asViewContainer ();
+	auto view = container->getView (kNumTreeViewsPerContainer / 2);
+	auto result = PerfTest::measure (10000, [&] () {
+		view->remember ();
+		container->removeView (view);
+		container->addView (view);
+		container->changeViewZOrder (view, kNumTreeViewsPerContainer / 2);
+	});
+	context.report ("remove/add/reorder view", result);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,193 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "perftest.h"
+#include "vstgui/lib/finally.h"
+#include "vstgui/lib/platform/linux/x11shmbackbuffer.h"
+#include <cairo/cairo-xcb.h>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <xcb/xcb_aux.h>
+
+/* This test needs an X server, run it headless with
+
+	xvfb-run -s "-screen 0 1920x1080x24" ./perftest X11Present
+*/
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+static constexpr int kWidth = 1920;
+static constexpr int kHeight = 1080;
+static constexpr uint64_t kNumFrames = 200;
+
+//------------------------------------------------------------------------
+xcb_visualtype_t* findVisual (xcb_screen_t* screen)
+{
+	for (auto depths = xcb_screen_allowed_depths_iterator (screen); depths.rem;
+		 xcb_depth_next (&depths))
+	{
+		for (auto visuals = xcb_depth_visuals_iterator (depths.data); visuals.rem;
+			 xcb_visualtype_next (&visuals))
+		{
+			if (visuals.data->visual_id == screen->root_visual)
+				return visuals.data;
+		}
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+/** some meters of a mixer, the typical dirty rects of an animated editor */
+std::vector<CRect> makeDirtyRects ()
+{
+	std::vector<CRect> rects;
+	for (auto i = 0; i < 24; ++i)
+	{
+		CRect r (0., 0., 16., 320.);
+		r.offset (40. + i * 76., 600.);
+		rects.emplace_back (r);
+	}
+	return rects;
+}
+
+//------------------------------------------------------------------------
+void drawFrame (cairo_surface_t* surface, const std::vector<CRect>& rects, uint64_t frame)
+{
+	Cairo::ContextHandle cr (cairo_create (surface));
+	for (const auto& r : rects)
+	{
+		auto level = ((frame * 7 + static_cast<uint64_t> (r.left)) % 100) / 100.;
+		cairo_set_source_rgb (cr, 0.1, 0.1, 0.1);
+		cairo_rectangle (cr, r.left, r.top, r.getWidth (), r.getHeight ());
+		cairo_fill (cr);
+		cairo_set_source_rgb (cr, 0.2, 0.8, 0.3);
+		cairo_rectangle (cr, r.left, r.bottom - r.getHeight () * level, r.getWidth (),
+						 r.getHeight () * level);
+		cairo_fill (cr);
+	}
+	cairo_surface_flush (surface);
+}
+
+//------------------------------------------------------------------------
+struct FrameStats
+{
+	PerfTest::Result latency;
+	double cpuSecondsPerFrame {0.};
+};
+
+//------------------------------------------------------------------------
+template <typename Proc>
+FrameStats measureFrames (Proc&& proc)
+{
+	FrameStats stats;
+	auto cpuStart = std::clock ();
+	uint64_t frame = 0;
+	stats.latency = PerfTest::measure (kNumFrames, [&] () { proc (frame++); });
+	stats.cpuSecondsPerFrame =
+		(static_cast<double> (std::clock () - cpuStart) / CLOCKS_PER_SEC) / kNumFrames;
+	return stats;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+PERF_TEST (X11Present, DirtyRects1080p)
+{
+	auto connection = xcb_connect (nullptr, nullptr);
+	auto disconnect = finally ([&] () { xcb_disconnect (connection); });
+	if (xcb_connection_has_error (connection))
+	{
+		context.report ("skipped, no X server (use xvfb-run)", 0., "");
+		return;
+	}
+	auto screen = xcb_setup_roots_iterator (xcb_get_setup (connection)).data;
+	auto visual = findVisual (screen);
+	// a pixmap has the same pixel format as a window, but is not clipped by other windows
+	auto pixmap = xcb_generate_id (connection);
+	xcb_create_pixmap (connection, screen->root_depth, pixmap, screen->root, kWidth, kHeight);
+	auto freePixmap = finally ([&] () { xcb_free_pixmap (connection, pixmap); });
+
+	auto dirtyRects = makeDirtyRects ();
+	std::vector<CRect> fullFrame {CRect (0., 0., kWidth, kHeight)};
+
+	// the fallback path: a back buffer on the server which is blitted via cairo
+	Cairo::SurfaceHandle windowSurface (
+		cairo_xcb_surface_create (connection, pixmap, visual, kWidth, kHeight));
+	auto finishDevice = finally (
+		[&] () { cairo_device_finish (cairo_surface_get_device (windowSurface)); });
+	Cairo::SurfaceHandle serverBackBuffer (cairo_surface_create_similar (
+		windowSurface, CAIRO_CONTENT_COLOR_ALPHA, kWidth, kHeight));
+	auto cairoPath = [&] (const std::vector<CRect>& rects) {
+		return measureFrames ([&] (uint64_t frame) {
+			drawFrame (serverBackBuffer, rects, frame);
+			Cairo::ContextHandle windowContext (cairo_create (windowSurface));
+			cairo_set_source_surface (windowContext, serverBackBuffer, 0, 0);
+			for (const auto& r : rects)
+				cairo_rectangle (windowContext, r.left, r.top, r.getWidth (), r.getHeight ());
+			cairo_fill (windowContext);
+			cairo_surface_flush (windowSurface);
+			xcb_aux_sync (connection);
+		});
+	};
+	auto cairoDirty = cairoPath (dirtyRects);
+	auto cairoFull = cairoPath (fullFrame);
+
+	auto shmBackBuffer = X11::ShmBackBuffer::create (connection, pixmap, visual,
+													 screen->root_depth, kWidth, kHeight);
+	context.report ("MIT-SHM available", shmBackBuffer ? 1. : 0., "");
+	context.report ("cairo blit, dirty rects", cairoDirty.latency);
+	context.report ("cairo blit, dirty rects client cpu", cairoDirty.cpuSecondsPerFrame * 1000.,
+					"ms/frame");
+	context.report ("cairo blit, full frame", cairoFull.latency);
+	context.report ("cairo blit, full frame client cpu", cairoFull.cpuSecondsPerFrame * 1000.,
+					"ms/frame");
+	if (!shmBackBuffer)
+		return;
+
+	auto shmPath = [&] (const std::vector<CRect>& rects) {
+		return measureFrames ([&] (uint64_t frame) {
+			drawFrame (shmBackBuffer->getSurface (), rects, frame);
+			for (const auto& r : rects)
+				shmBackBuffer->present (r);
+			xcb_flush (connection);
+			shmBackBuffer->waitForPresentDone ();
+		});
+	};
+	auto shmDirty = shmPath (dirtyRects);
+	auto shmFull = shmPath (fullFrame);
+
+	// read back one pixel to make sure that the server got the shared memory content
+	{
+		Cairo::ContextHandle cr (cairo_create (shmBackBuffer->getSurface ()));
+		cairo_set_source_rgb (cr, 1., 0., 0.);
+		cairo_paint (cr);
+	}
+	shmBackBuffer->present (fullFrame.front ());
+	shmBackBuffer->waitForPresentDone ();
+	auto image = xcb_get_image_reply (
+		connection,
+		xcb_get_image (connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, 10, 10, 1, 1, ~0u),
+		nullptr);
+	uint32_t pixel = 0;
+	if (image && xcb_get_image_data_length (image) >= 4)
+		pixel = *reinterpret_cast<const uint32_t*> (xcb_get_image_data (image));
+	free (image);
+	context.check ("presented pixels arrived", (pixel & 0xffffff) == 0xff0000);
+
+	context.report ("MIT-SHM, dirty rects", shmDirty.latency);
+	context.report ("MIT-SHM, dirty rects client cpu", shmDirty.cpuSecondsPerFrame * 1000.,
+					"ms/frame");
+	context.report ("MIT-SHM, full frame", shmFull.latency);
+	context.report ("MIT-SHM, full frame client cpu", shmFull.cpuSecondsPerFrame * 1000.,
+					"ms/frame");
+	context.compare ("dirty rects speedup", cairoDirty.latency, shmDirty.latency);
+	context.compare ("full frame speedup", cairoFull.latency, shmFull.latency);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,60 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../contrib/keyboardview.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+TEST_CASE (KeyboardViewTest, QueuedKeyStatesAreAppliedOnProcess)
+{
+	auto keyboard = makeOwned<KeyboardView> ();
+	keyboard->queueKeyPressed (60, true);
+	keyboard->queueKeyPressed (64, true);
+	EXPECT_FALSE (keyboard->isKeyPressed (60));
+	keyboard->processQueuedKeyStates ();
+	EXPECT_TRUE (keyboard->isKeyPressed (60));
+	EXPECT_TRUE (keyboard->isKeyPressed (64));
+	keyboard->queueKeyPressed (60, false);
+	keyboard->processQueuedKeyStates ();
+	EXPECT_FALSE (keyboard->isKeyPressed (60));
+	EXPECT_TRUE (keyboard->isKeyPressed (64));
+}
+
+TEST_CASE (KeyboardViewTest, LastQueuedStateWins)
+{
+	auto keyboard = makeOwned<KeyboardView> ();
+	keyboard->queueKeyPressed (60, true);
+	keyboard->queueKeyPressed (60, false);
+	keyboard->queueKeyPressed (60, true);
+	keyboard->processQueuedKeyStates ();
+	EXPECT_TRUE (keyboard->isKeyPressed (60));
+}
+
+TEST_CASE (KeyboardViewTest, QueueOverflow)
+{
+	auto keyboard = makeOwned<KeyboardView> ();
+	// pressed on the UI thread, e.g. with the mouse
+	keyboard->setKeyPressed (40, true);
+	// more changes than the queue can hold
+	for (auto i = 0; i < 3000; ++i)
+		keyboard->queueKeyPressed (61, i % 2 == 0);
+	keyboard->queueKeyPressed (62, true);
+	keyboard->queueKeyPressed (63, true);
+	keyboard->queueKeyPressed (63, false);
+	keyboard->processQueuedKeyStates ();
+	EXPECT_TRUE (keyboard->isKeyPressed (40));
+	EXPECT_FALSE (keyboard->isKeyPressed (61));
+	EXPECT_TRUE (keyboard->isKeyPressed (62));
+	EXPECT_FALSE (keyboard->isKeyPressed (63));
+
+	// the queue works again after the overflow
+	keyboard->setKeyPressed (40, false);
+	keyboard->queueKeyPressed (61, true);
+	keyboard->processQueuedKeyStates ();
+	EXPECT_FALSE (keyboard->isKeyPressed (40));
+	EXPECT_TRUE (keyboard->isKeyPressed (61));
+}
+
+} // VSTGUI
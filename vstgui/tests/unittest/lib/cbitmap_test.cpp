@@ -197,5 +197,149 @@ TEST_CASE (MultiFrameBitmapViewTest, Inverse)
 	EXPECT_EQ (testView.getInverseIndex (bitmap, 3), 2);
 }
 
+//------------------------------------------------------------------------
+static void fillMultiFrameBitmapFrames (CMultiFrameBitmap& bitmap, const CColor colors[])
+{
+	auto accessor = owned (CBitmapPixelAccess::create (&bitmap));
+	auto frameHeight = static_cast<uint32_t> (bitmap.getFrameSize ().y);
+	do
+	{
+		accessor->setColor (colors[accessor->getY () / frameHeight]);
+	} while (++(*accessor));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (MultiFrameBitmapCacheTest, ExtractFrame)
+{
+	const CColor colors[] = {kRedCColor, kGreenCColor, kBlueCColor, kWhiteCColor};
+	CMultiFrameBitmap bitmap (10, 40);
+	EXPECT_TRUE (bitmap.setMultiFrameDesc ({{10, 10}, 4, 1}));
+	fillMultiFrameBitmapFrames (bitmap, colors);
+
+	MultiFrameBitmapCache::clear ();
+	for (uint16_t i = 0; i < 4; ++i)
+	{
+		auto frame = MultiFrameBitmapCache::getFrame (bitmap, i, 1.);
+		EXPECT (frame);
+		EXPECT_EQ (frame->getSize (), CPoint (10, 10));
+		auto accessor = owned (CBitmapPixelAccess::create (frame));
+		CColor color;
+		accessor->setPosition (5, 5);
+		accessor->getColor (color);
+		EXPECT_EQ (color, colors[i]);
+	}
+	auto stats = MultiFrameBitmapCache::getStatistics ();
+	EXPECT_EQ (stats.numFrames, 4u);
+	EXPECT_EQ (stats.misses, 4u);
+
+	auto frame = MultiFrameBitmapCache::getFrame (bitmap, 2, 1.);
+	EXPECT_EQ (frame, MultiFrameBitmapCache::getFrame (bitmap, 2, 1.));
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().hits, stats.hits + 2);
+
+	MultiFrameBitmapCache::clear (&bitmap);
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().numFrames, 0u);
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().memoryUsage, 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (MultiFrameBitmapCacheTest, ExtractFrameAtFractionalScaleFactor)
+{
+	// 7x7 frames at 1.5x have a size of 10.5 pixels, which is rounded differently by the frame
+	// rect and the offscreen the frame is drawn into
+	auto platformBitmap = getPlatformFactory ().createBitmap ({11, 42});
+	EXPECT (platformBitmap);
+	platformBitmap->setScaleFactor (1.5);
+	CMultiFrameBitmap bitmap (platformBitmap);
+	EXPECT_TRUE (bitmap.setMultiFrameDesc ({{7, 7}, 4, 1}));
+	if (auto accessor = owned (CBitmapPixelAccess::create (&bitmap)))
+	{
+		do
+		{
+			accessor->setColor (kRedCColor);
+		} while (++(*accessor));
+	}
+
+	MultiFrameBitmapCache::clear ();
+	for (uint16_t i = 0; i < 4; ++i)
+	{
+		auto frame = MultiFrameBitmapCache::getFrame (bitmap, i, 1.5);
+		EXPECT (frame);
+		auto framePlatformBitmap = frame->getPlatformBitmap ();
+		EXPECT (framePlatformBitmap);
+		EXPECT_EQ (framePlatformBitmap->getScaleFactor (), 1.5);
+		EXPECT (framePlatformBitmap->getSize ().x <= 11.);
+		EXPECT (framePlatformBitmap->getSize ().y <= 11.);
+		auto accessor = owned (CBitmapPixelAccess::create (frame));
+		EXPECT (accessor);
+		CColor color;
+		accessor->setPosition (5, 5);
+		accessor->getColor (color);
+		EXPECT_EQ (color, kRedCColor);
+	}
+	MultiFrameBitmapCache::clear (&bitmap);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (MultiFrameBitmapCacheTest, MemoryBudget)
+{
+	const CColor colors[] = {kRedCColor, kGreenCColor, kBlueCColor, kWhiteCColor};
+	CMultiFrameBitmap bitmap (10, 40);
+	EXPECT_TRUE (bitmap.setMultiFrameDesc ({{10, 10}, 4, 1}));
+	fillMultiFrameBitmapFrames (bitmap, colors);
+
+	MultiFrameBitmapCache::clear ();
+	auto oldBudget = MultiFrameBitmapCache::getMemoryBudget ();
+	auto frame0 = MultiFrameBitmapCache::getFrame (bitmap, 0, 1.);
+	auto frameBytes = MultiFrameBitmapCache::getStatistics ().memoryUsage;
+	EXPECT_NE (frameBytes, 0u);
+	MultiFrameBitmapCache::setMemoryBudget (frameBytes * 2);
+	MultiFrameBitmapCache::getFrame (bitmap, 1, 1.);
+	// touch frame 0 so that frame 1 is the least recently used one
+	MultiFrameBitmapCache::getFrame (bitmap, 0, 1.);
+	auto evictions = MultiFrameBitmapCache::getStatistics ().evictions;
+	MultiFrameBitmapCache::getFrame (bitmap, 2, 1.);
+	auto stats = MultiFrameBitmapCache::getStatistics ();
+	EXPECT_EQ (stats.numFrames, 2u);
+	EXPECT_EQ (stats.evictions, evictions + 1);
+	EXPECT_EQ (stats.memoryUsage, frameBytes * 2);
+	EXPECT_EQ (MultiFrameBitmapCache::getFrame (bitmap, 0, 1.), frame0);
+
+	MultiFrameBitmapCache::setMemoryBudget (0);
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().numFrames, 0u);
+	EXPECT_FALSE (MultiFrameBitmapCache::getFrame (bitmap, 3, 1.));
+	MultiFrameBitmapCache::setMemoryBudget (oldBudget);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (MultiFrameBitmapCacheTest, DisableFrameCacheRemovesFrames)
+{
+	CMultiFrameBitmap bitmap (10, 40);
+	EXPECT_TRUE (bitmap.setMultiFrameDesc ({{10, 10}, 4, 1}));
+	MultiFrameBitmapCache::clear ();
+	bitmap.setFrameCacheEnabled (true);
+	EXPECT_TRUE (bitmap.isFrameCacheEnabled ());
+	MultiFrameBitmapCache::getFrame (bitmap, 0, 1.);
+	MultiFrameBitmapCache::getFrame (bitmap, 1, 1.);
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().numFrames, 2u);
+	EXPECT_TRUE (bitmap.setMultiFrameDesc ({{10, 20}, 2, 1}));
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().numFrames, 0u);
+	MultiFrameBitmapCache::getFrame (bitmap, 0, 1.);
+	bitmap.setFrameCacheEnabled (false);
+	EXPECT_EQ (MultiFrameBitmapCache::getStatistics ().numFrames, 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (MultiFrameBitmapCacheTest, EnabledByDefault)
+{
+	EXPECT_FALSE (CMultiFrameBitmap::isFrameCacheEnabledByDefault ());
+	CMultiFrameBitmap::setFrameCacheEnabledByDefault (true);
+	CMultiFrameBitmap bitmap (10, 40);
+	EXPECT_TRUE (bitmap.isFrameCacheEnabled ());
+	CMultiFrameBitmap::setFrameCacheEnabledByDefault (false);
+	CMultiFrameBitmap bitmap2 (10, 40);
+	EXPECT_FALSE (bitmap2.isFrameCacheEnabled ());
+	EXPECT_TRUE (bitmap.isFrameCacheEnabled ());
+}
+
 //------------------------------------------------------------------------
 } // VSTGUI
@@ -0,0 +1,227 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cdatabrowser.h"
+#include "../../../lib/cframe.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/idatabrowserdelegate.h"
+#include "../unittests.h"
+#include "eventhelpers.h"
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+struct TestDelegate : DataBrowserDelegateAdapter
+{
+	int32_t numRows {1000};
+	CCoord rowHeight {12.};
+	CCoord lineWidth {1.};
+	std::vector<CCoord> columnWidths {10., 25., 40.};
+	std::vector<std::pair<int32_t, int32_t>> drawnCells;
+
+	int32_t dbGetNumRows (CDataBrowser* browser) override { return numRows; }
+	int32_t dbGetNumColumns (CDataBrowser* browser) override
+	{
+		return static_cast<int32_t> (columnWidths.size ());
+	}
+	CCoord dbGetRowHeight (CDataBrowser* browser) override { return rowHeight; }
+	CCoord dbGetHeaderHeight (CDataBrowser* browser) override { return 20.; }
+	CCoord dbGetCurrentColumnWidth (int32_t index, CDataBrowser* browser) override
+	{
+		return columnWidths[index];
+	}
+	void dbSetCurrentColumnWidth (int32_t index, const CCoord& width,
+								  CDataBrowser* browser) override
+	{
+		columnWidths[index] = width;
+	}
+	bool dbGetColumnDescription (int32_t index, CCoord& minWidth, CCoord& maxWidth,
+								 CDataBrowser* browser) override
+	{
+		minWidth = 5.;
+		maxWidth = 100.;
+		return true;
+	}
+	bool dbGetLineWidthAndColor (CCoord& width, CColor& color, CDataBrowser* browser) override
+	{
+		width = lineWidth;
+		color = kBlackCColor;
+		return true;
+	}
+	void dbDrawCell (CDrawContext* context, const CRect& size, int32_t row, int32_t column,
+					 int32_t flags, CDataBrowser* browser) override
+	{
+		drawnCells.emplace_back (row, column);
+	}
+};
+
+//------------------------------------------------------------------------
+struct BrowserFixture
+{
+	static constexpr int32_t kLineStyle =
+		CDataBrowser::kDrawRowLines | CDataBrowser::kDrawColumnLines | CScrollView::kDontDrawFrame;
+
+	BrowserFixture (int32_t style = 0)
+	{
+		frame = makeOwned<CFrame> (CRect (0, 0, 400, 400), nullptr);
+		browser = new CDataBrowser (CRect (0, 0, 200, 200), &delegate, style | kLineStyle, 0.);
+		frame->addView (browser);
+		frame->attached (frame);
+	}
+	~BrowserFixture () { frame->close (); }
+
+	/** the layout as documented, calculated from the delegate values */
+	CCoord rowPitch () const { return delegate.rowHeight + delegate.lineWidth; }
+	CCoord columnLeft (int32_t column) const
+	{
+		CCoord left = 0.;
+		for (auto i = 0; i < column; ++i)
+			left += delegate.columnWidths[i] + delegate.lineWidth;
+		return left;
+	}
+	CRect expectedCellBounds (int32_t row, int32_t column, CCoord top = 0.) const
+	{
+		CRect r (columnLeft (column), top + row * rowPitch (), 0., 0.);
+		r.setWidth (delegate.columnWidths[column]);
+		r.setHeight (rowPitch ());
+		return r;
+	}
+
+	TestDelegate delegate;
+	SharedPointer<CFrame> frame;
+	CDataBrowser* browser {nullptr};
+};
+
+//------------------------------------------------------------------------
+bool isCell (const CDataBrowser::Cell& cell, int32_t row, int32_t column)
+{
+	return cell.row == row && cell.column == column;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, CellBounds)
+{
+	BrowserFixture fixture;
+	for (auto row : {0, 1, 7, 999})
+	{
+		for (auto column = 0; column < 3; ++column)
+		{
+			EXPECT_EQ (fixture.browser->getCellBounds ({row, column}),
+					   fixture.expectedCellBounds (row, column));
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, CellAtEdges)
+{
+	BrowserFixture fixture;
+	fixture.delegate.numRows = 5;
+	fixture.browser->recalculateLayout (true);
+	auto pitch = fixture.rowPitch ();
+	for (auto row = 0; row < 5; ++row)
+	{
+		for (auto column = 0; column < 3; ++column)
+		{
+			// the top left corner and the last point before the next cell, which includes the
+			// row and column lines
+			CPoint topLeft (fixture.columnLeft (column), row * pitch);
+			CPoint bottomRight (fixture.columnLeft (column + 1) - 0.5, (row + 1) * pitch - 0.5);
+			EXPECT_TRUE (isCell (fixture.browser->getCellAt (topLeft), row, column));
+			EXPECT_TRUE (isCell (fixture.browser->getCellAt (bottomRight), row, column));
+		}
+	}
+	// right of the last column and below the last row
+	EXPECT_FALSE (fixture.browser->getCellAt ({fixture.columnLeft (3) + 1., 1.}).isValid ());
+	EXPECT_FALSE (fixture.browser->getCellAt ({1., 5 * pitch + 1.}).isValid ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, LayoutChangeWithoutVirtualizedLayout)
+{
+	BrowserFixture fixture;
+	fixture.delegate.rowHeight = 20.;
+	fixture.delegate.columnWidths[0] = 33.;
+	EXPECT_EQ (fixture.browser->getCellBounds ({2, 1}), fixture.expectedCellBounds (2, 1));
+	EXPECT_TRUE (isCell (fixture.browser->getCellAt ({fixture.columnLeft (1), 2 * fixture.rowPitch ()}),
+						 2, 1));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, VirtualizedLayoutUpdatesInRecalculateLayout)
+{
+	BrowserFixture fixture (CDataBrowser::kVirtualizedLayout);
+	auto oldBounds = fixture.expectedCellBounds (2, 1);
+	fixture.delegate.rowHeight = 20.;
+	fixture.delegate.columnWidths[0] = 33.;
+	EXPECT_EQ (fixture.browser->getCellBounds ({2, 1}), oldBounds);
+
+	fixture.browser->recalculateLayout (true);
+	EXPECT_EQ (fixture.browser->getCellBounds ({2, 1}), fixture.expectedCellBounds (2, 1));
+	auto pitch = fixture.rowPitch ();
+	EXPECT_TRUE (isCell (fixture.browser->getCellAt ({fixture.columnLeft (1), 2 * pitch}), 2, 1));
+	EXPECT_TRUE (isCell (fixture.browser->getCellAt ({fixture.columnLeft (1) - 0.5, 2 * pitch - 0.5}),
+						 1, 0));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, DrawOnlyCellsInUpdateRect)
+{
+	BrowserFixture fixture;
+	auto offscreen = COffscreenContext::create ({400., 400.});
+	for (auto updateRect : {CRect (30, 25, 60, 40), CRect (0, 0, 11, 13), CRect (36, 90, 37, 91),
+							CRect (0, 0, 200, 200)})
+	{
+		fixture.delegate.drawnCells.clear ();
+		offscreen->beginDraw ();
+		fixture.frame->drawRect (offscreen, updateRect);
+		offscreen->endDraw ();
+
+		std::vector<std::pair<int32_t, int32_t>> expected;
+		for (auto row = 0; row < fixture.delegate.numRows; ++row)
+		{
+			for (auto column = 0; column < 3; ++column)
+			{
+				auto r = fixture.expectedCellBounds (row, column);
+				r.setHeight (fixture.delegate.rowHeight);
+				r.bound (updateRect);
+				if (!r.isEmpty ())
+					expected.emplace_back (row, column);
+			}
+		}
+		EXPECT_FALSE (expected.empty ());
+		EXPECT_TRUE (fixture.delegate.drawnCells == expected);
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDataBrowserTest, HeaderColumnResizeAtColumnEdge)
+{
+	BrowserFixture fixture (CDataBrowser::kDrawHeader);
+	auto top = fixture.browser->getCellBounds ({0, 0}).top;
+	auto edge = fixture.columnLeft (1);
+	EXPECT_EQ (fixture.browser->getCellBounds ({3, 1}), fixture.expectedCellBounds (3, 1, top));
+
+	// more than 5 pixels left of the column edge does not resize
+	dispatchMouseEvent<MouseDownEvent> (fixture.frame, {edge - 6., 10.}, MouseButton::Left);
+	dispatchMouseEvent<MouseMoveEvent> (fixture.frame, {edge + 4., 10.}, MouseButton::Left);
+	dispatchMouseEvent<MouseUpEvent> (fixture.frame, {edge + 4., 10.}, MouseButton::Left);
+	EXPECT_EQ (fixture.delegate.columnWidths[0], 10.);
+
+	dispatchMouseEvent<MouseDownEvent> (fixture.frame, {edge - 2., 10.}, MouseButton::Left);
+	dispatchMouseEvent<MouseMoveEvent> (fixture.frame, {edge + 8., 10.}, MouseButton::Left);
+	dispatchMouseEvent<MouseUpEvent> (fixture.frame, {edge + 8., 10.}, MouseButton::Left);
+	EXPECT_EQ (fixture.delegate.columnWidths[0], 20.);
+
+	// the cells below the header follow the resized column
+	EXPECT_EQ (fixture.browser->getCellBounds ({3, 1}), fixture.expectedCellBounds (3, 1, top));
+	EXPECT_EQ (fixture.browser->getCellBounds ({3, 0}), fixture.expectedCellBounds (3, 0, top));
+}
+
+} // VSTGUI
@@ -0,0 +1,84 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cdrawmethods.h"
+#include "../../../lib/cfont.h"
+#include "../../../lib/platform/iplatformfont.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+CCoord getWidth (const UTF8String& text)
+{
+	auto painter = kSystemFont->getFontPainter ();
+	auto layout = painter->createTextLayout (nullptr, text.getPlatformString ());
+	return layout ? layout->getWidth () : 0.;
+}
+
+static const UTF8String kText = "The quick brown fox jumps over the lazy dog";
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CDrawMethods, NoTruncationIfTextFits)
+{
+	auto width = getWidth (kText);
+	EXPECT_EQ (CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, kText,
+												  kSystemFont, width),
+			   kText);
+	EXPECT_EQ (CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateNone, kText,
+												  kSystemFont, 1.),
+			   kText);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDrawMethods, TruncateTail)
+{
+	auto maxWidth = getWidth (kText) / 2.;
+	auto result = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, kText,
+													 kSystemFont, maxWidth);
+	const auto& str = result.getString ();
+	EXPECT_TRUE (str.size () > 2);
+	EXPECT_EQ (str.substr (str.size () - 2), "..");
+	auto kept = str.substr (0, str.size () - 2);
+	EXPECT_EQ (kText.getString ().substr (0, kept.size ()), kept);
+	EXPECT_TRUE (getWidth (result) <= maxWidth);
+	// one more character does not fit
+	UTF8String longer (kText.getString ().substr (0, kept.size () + 1) + "..");
+	EXPECT_TRUE (getWidth (longer) > maxWidth);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDrawMethods, TruncateHead)
+{
+	auto maxWidth = getWidth (kText) / 2.;
+	auto result = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateHead, kText,
+													 kSystemFont, maxWidth);
+	const auto& str = result.getString ();
+	EXPECT_TRUE (str.size () > 2);
+	EXPECT_EQ (str.substr (0, 2), "..");
+	auto kept = str.substr (2);
+	const auto& text = kText.getString ();
+	EXPECT_EQ (text.substr (text.size () - kept.size ()), kept);
+	EXPECT_TRUE (getWidth (result) <= maxWidth);
+	UTF8String longer (".." + text.substr (text.size () - kept.size () - 1));
+	EXPECT_TRUE (getWidth (longer) > maxWidth);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CDrawMethods, TruncateToPlaceholder)
+{
+	auto result = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, kText,
+													 kSystemFont, 1.);
+	EXPECT_EQ (result, "..");
+	result = CDrawMethods::createTruncatedText (
+		CDrawMethods::kTextTruncateHead, kText, kSystemFont, 1., {},
+		CDrawMethods::kReturnEmptyIfTruncationIsPlaceholderOnly);
+	EXPECT_TRUE (result.empty ());
+}
+
+} // VSTGUI
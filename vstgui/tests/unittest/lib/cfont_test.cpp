@@ -1,46 +1,102 @@
-// This file is part of VSTGUI. It is subject to the license terms 
+// This file is part of VSTGUI. It is subject to the license terms
 // in the LICENSE file found in the top-level directory of this
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
-#include "../unittests.h"
 #include "../../../lib/cfont.h"
+#include "../../../lib/platform/iplatformfont.h"
+#include "../unittests.h"
+#include <cstring>
 
 namespace VSTGUI {
 
-TESTCASE(CFontTests,
-
-	TEST(attributes,
-		CFontDesc f;
-		EXPECT(f.getName ().empty ());
-		EXPECT(f.getSize () == 0.);
-		EXPECT(f.getStyle () == kNormalFace);
-		f.setName ("Test");
-		EXPECT(strcmp (f.getName (), "Test") == 0);
-		f.setSize (20.2);
-		EXPECT(f.getSize () == 20.2);
-		f.setStyle (kBoldFace|kItalicFace);
-		EXPECT(f.getStyle () == (kBoldFace|kItalicFace));
-		CFontDesc::cleanup ();
-	);
-
-	TEST(copyConstructor,
-		CFontDesc f (*kSystemFont);
-		EXPECT(f == *kSystemFont);
-	);
-
-	TEST(notEqualOperator,
-		CFontDesc f (*kSystemFont);
-		EXPECT(f == *kSystemFont);
-		f.setSize (f.getSize ()+1);
-		EXPECT(f != *kSystemFont);
-		f = *kSystemFont;
-		f.setStyle (kBoldFace);
-		EXPECT(f != *kSystemFont);
-		f = *kSystemFont;
-		f.setName ("Bla");
-		EXPECT(f != *kSystemFont);
-	);
-
-);
+//------------------------------------------------------------------------
+TEST_CASE (CFontDesc, Attributes)
+{
+	auto f = makeOwned<CFontDesc> ();
+	EXPECT_TRUE (f->getName ().empty ());
+	EXPECT_EQ (f->getSize (), 0.);
+	EXPECT_EQ (f->getStyle (), kNormalFace);
+	f->setName ("Test");
+	EXPECT_EQ (strcmp (f->getName (), "Test"), 0);
+	f->setSize (20.2);
+	EXPECT_EQ (f->getSize (), 20.2);
+	f->setStyle (kBoldFace | kItalicFace);
+	EXPECT_EQ (f->getStyle (), (kBoldFace | kItalicFace));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFontDesc, CopyConstructor)
+{
+	auto f = makeOwned<CFontDesc> (*kSystemFont);
+	EXPECT_TRUE (*f == *kSystemFont);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CFontDesc, NotEqualOperator)
+{
+	auto f = makeOwned<CFontDesc> (*kSystemFont);
+	EXPECT_TRUE (*f == *kSystemFont);
+	f->setSize (f->getSize () + 1);
+	EXPECT_TRUE (*f != *kSystemFont);
+	*f = *kSystemFont;
+	f->setStyle (kBoldFace);
+	EXPECT_TRUE (*f != *kSystemFont);
+	*f = *kSystemFont;
+	f->setName ("Bla");
+	EXPECT_TRUE (*f != *kSystemFont);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (PlatformFontCache, SharedPlatformFont)
+{
+	PlatformFontCache::clear ();
+	auto f1 = makeOwned<CFontDesc> ("Arial", 13, kBoldFace);
+	auto f2 = makeOwned<CFontDesc> (*f1);
+	auto f3 = makeOwned<CFontDesc> ("Arial", 13, kItalicFace);
+	auto before = PlatformFontCache::getStatistics ();
+	auto pf1 = f1->getPlatformFont ();
+	EXPECT_TRUE (pf1);
+	EXPECT_EQ (f2->getPlatformFont (), pf1);
+	EXPECT_NE (f3->getPlatformFont (), pf1);
+	auto stats = PlatformFontCache::getStatistics ();
+	EXPECT_EQ (stats.misses - before.misses, 2u);
+	EXPECT_EQ (stats.hits - before.hits, 1u);
+	EXPECT_EQ (stats.numFonts, 2u);
+	f2->setStyle (kItalicFace);
+	EXPECT_EQ (f2->getPlatformFont (), f3->getPlatformFont ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (PlatformFontCache, TrimUnusedFonts)
+{
+	PlatformFontCache::clear ();
+	auto f1 = makeOwned<CFontDesc> ("Arial", 13, kBoldFace);
+	auto f2 = makeOwned<CFontDesc> ("Arial", 14, kBoldFace);
+	f1->getPlatformFont ();
+	f2->getPlatformFont ();
+	EXPECT_EQ (PlatformFontCache::getStatistics ().numUnusedFonts, 0u);
+	f2 = nullptr;
+	EXPECT_EQ (PlatformFontCache::getStatistics ().numUnusedFonts, 1u);
+	EXPECT_EQ (PlatformFontCache::trim (), 1u);
+	auto stats = PlatformFontCache::getStatistics ();
+	EXPECT_EQ (stats.numFonts, 1u);
+	EXPECT_EQ (stats.numUnusedFonts, 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (PlatformFontCache, MaxNumFonts)
+{
+	PlatformFontCache::clear ();
+	auto oldMax = PlatformFontCache::getMaxNumFonts ();
+	PlatformFontCache::setMaxNumFonts (2);
+	auto f1 = makeOwned<CFontDesc> ("Arial", 13);
+	auto pf1 = f1->getPlatformFont ();
+	for (auto size = 14; size < 20; ++size)
+		makeOwned<CFontDesc> ("Arial", size)->getPlatformFont ();
+	EXPECT_TRUE (PlatformFontCache::getStatistics ().numFonts <= 2u);
+	EXPECT_EQ (makeOwned<CFontDesc> (*f1)->getPlatformFont (), pf1);
+	PlatformFontCache::setMaxNumFonts (oldMax);
+	PlatformFontCache::clear ();
+}
 
 } // VSTGUI
@@ -0,0 +1,160 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/controls/ctextlabel.h"
+#include "../../../../lib/cframe.h"
+#include "../../../../lib/platform/iplatformfont.h"
+#include "../../unittests.h"
+#include <cmath>
+#include <sstream>
+
+namespace VSTGUI {
+
+namespace {
+
+static const UTF8String kMultiLineText =
+	"The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.\n"
+	"How vexingly quick daft zebras jump!\n"
+	"Sphinx of black quartz, judge my vow.";
+
+//------------------------------------------------------------------------
+struct LabelFrame
+{
+	LabelFrame (CCoord width)
+	{
+		frame = makeOwned<CFrame> (CRect (0, 0, 1000, 1000), nullptr);
+		label = new CMultiLineTextLabel (CRect (0, 0, width, 20));
+		label->setLineLayout (CMultiLineTextLabel::LineLayout::wrap);
+		frame->addView (label);
+		frame->attached (frame);
+		label->setAutoHeight (true);
+		label->setText (kMultiLineText);
+	}
+	~LabelFrame () { frame->close (); }
+
+	/** the number of lines of the label without text inset, from its height */
+	size_t updateNumLines ()
+	{
+		const auto& font = label->getFont ()->getPlatformFont ();
+		auto lineHeight = font->getAscent () + font->getDescent () + font->getLeading ();
+		return static_cast<size_t> (std::round (updateHeight () / lineHeight));
+	}
+
+	/** recalculate the lines and the height for the current width */
+	CCoord updateHeight ()
+	{
+		label->setAutoHeight (false);
+		label->setAutoHeight (true);
+		return label->getHeight ();
+	}
+
+	SharedPointer<CFrame> frame;
+	CMultiLineTextLabel* label;
+};
+
+//------------------------------------------------------------------------
+/** the number of lines of a greedy word wrap, with the words measured separately from the label */
+size_t measureNumWrappedLines (CMultiLineTextLabel* label, const std::string& text, CCoord maxWidth)
+{
+	auto fontPainter = label->getFont ()->getFontPainter ();
+	auto measure = [&] (const std::string& str) {
+		auto layout = fontPainter->createTextLayout (nullptr, UTF8String (str).getPlatformString (),
+													 label->getAntialias ());
+		return layout ? layout->getWidth () : 0.;
+	};
+	std::istringstream stream (text);
+	std::string word;
+	std::string line;
+	size_t numLines = 1;
+	while (stream >> word)
+	{
+		auto candidate = line.empty () ? word : line + " " + word;
+		if (line.empty () || measure (candidate) <= maxWidth)
+			line = candidate;
+		else
+		{
+			++numLines;
+			line = word;
+		}
+	}
+	return numLines;
+}
+
+static const std::string kWords =
+	"the quick brown fox jumps over the lazy dog pack my box with five dozen liquor jugs how "
+	"vexingly quick daft zebras jump sphinx of black quartz judge my vow";
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CMultiLineTextLabelTest, RewrapAfterWidthChange)
+{
+	LabelFrame wide (400.);
+	auto wideHeight = wide.label->getHeight ();
+	for (auto width = 390.; width >= 100.; width -= 10.)
+	{
+		auto r = wide.label->getViewSize ();
+		r.setWidth (width);
+		wide.label->setViewSize (r);
+		LabelFrame fresh (width);
+		EXPECT_EQ (wide.updateHeight (), fresh.label->getHeight ());
+	}
+	EXPECT_TRUE (wide.label->getHeight () > wideHeight);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CMultiLineTextLabelTest, TextChangeAfterWidthChange)
+{
+	LabelFrame label (100.);
+	auto height = label.label->getHeight ();
+	label.label->setText ("Short");
+	EXPECT_TRUE (label.label->getHeight () < height);
+	label.label->setText (kMultiLineText);
+	EXPECT_EQ (label.label->getHeight (), height);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CMultiLineTextLabelTest, ClipLinesKeepTheirWidth)
+{
+	auto label = owned (new CMultiLineTextLabel (CRect (0, 0, 100, 100)));
+	label->setText (kMultiLineText);
+	auto maxLineWidth = label->getMaxLineWidth ();
+	EXPECT_TRUE (maxLineWidth > 100.);
+	label->setViewSize (CRect (0, 0, 50, 100));
+	EXPECT_EQ (label->getMaxLineWidth (), maxLineWidth);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CMultiLineTextLabelTest, AntialiasChangeRecalculatesLines)
+{
+	LabelFrame label (150.);
+	label.label->setTextInset ({0., 0.});
+	label.label->setText (kWords.data ());
+	EXPECT_EQ (label.updateNumLines (), measureNumWrappedLines (label.label, kWords, 150.));
+
+	label.label->setAntialias (false);
+	auto numLines = measureNumWrappedLines (label.label, kWords, 150.);
+	EXPECT (numLines > 1);
+	EXPECT_EQ (label.updateNumLines (), numLines);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CMultiLineTextLabelTest, WrapRightToLeftText)
+{
+	// hebrew words, the character offsets of the layout are visual positions for these
+	static const std::string kRightToLeftWords =
+		"\xd7\xa9\xd7\x9c\xd7\x95\xd7\x9d \xd7\xa2\xd7\x95\xd7\x9c\xd7\x9d "
+		"\xd7\x96\xd7\x94 \xd7\x98\xd7\xa7\xd7\xa1\xd7\x98 \xd7\x90\xd7\xa8\xd7\x95\xd7\x9a "
+		"\xd7\x9e\xd7\x90\xd7\x95\xd7\x93 \xd7\xa9\xd7\x9e\xd7\xaa\xd7\xa4\xd7\xa8\xd7\xa7 "
+		"\xd7\x9c\xd7\xa9\xd7\x95\xd7\xa8\xd7\x95\xd7\xaa \xd7\xa8\xd7\x91\xd7\x95\xd7\xaa "
+		"\xd7\x91\xd7\x9e\xd7\xa1\xd7\x92\xd7\xa8\xd7\xaa \xd7\x94\xd7\xaa\xd7\x95\xd7\x95\xd7\x99\xd7\xaa";
+	LabelFrame label (100.);
+	label.label->setTextInset ({0., 0.});
+	label.label->setText (kRightToLeftWords.data ());
+	auto numLines = measureNumWrappedLines (label.label, kRightToLeftWords, 100.);
+	EXPECT (numLines > 1);
+	EXPECT_EQ (label.updateNumLines (), numLines);
+}
+
+} // VSTGUI
@@ -0,0 +1,187 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/controls/cvumeter.h"
+#include "../../../../lib/cbitmap.h"
+#include "../../../../lib/coffscreencontext.h"
+#include "../../../../lib/cviewcontainer.h"
+#include "../../unittests.h"
+#include <cmath>
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+struct InvalidRectRecorder : CViewContainer
+{
+	using CViewContainer::CViewContainer;
+
+	void invalidRect (const CRect& rect) override { rects.emplace_back (rect); }
+
+	std::vector<CRect> rects;
+};
+
+//------------------------------------------------------------------------
+/** drives the peak with explicit ticks instead of the frame ticks */
+struct PeakTestVuMeter : CVuMeter
+{
+	using CVuMeter::CVuMeter;
+
+	void idle (float newValue, uint64_t ticks)
+	{
+		updatePeak (newValue, ticks);
+		lastIdleTicks = ticks;
+	}
+};
+
+//------------------------------------------------------------------------
+struct MeterFixture
+{
+	static constexpr CCoord kWidth = 10.;
+	static constexpr CCoord kHeight = 100.;
+	static constexpr int32_t kNumLeds = 10;
+
+	MeterFixture ()
+	{
+		parent = makeOwned<CViewContainer> (CRect (0, 0, kWidth, kHeight));
+		recorder = makeOwned<InvalidRectRecorder> (CRect (0, 0, kWidth, kHeight));
+		auto onBitmap = makeOwned<CBitmap> (CPoint (kWidth, kHeight));
+		auto offBitmap = makeOwned<CBitmap> (CPoint (kWidth, kHeight));
+		meter = new CVuMeter (CRect (0, 0, kWidth, kHeight), onBitmap, offBitmap, kNumLeds);
+		meter->setDecreaseStepValue (0.1f);
+		recorder->addView (meter);
+		recorder->attached (parent);
+		context = COffscreenContext::create ({kWidth, kHeight});
+	}
+
+	~MeterFixture () { recorder->removed (parent); }
+
+	void draw ()
+	{
+		context->beginDraw ();
+		meter->draw (context);
+		context->endDraw ();
+		recorder->rects.clear ();
+	}
+
+	SharedPointer<CViewContainer> parent;
+	SharedPointer<InvalidRectRecorder> recorder;
+	SharedPointer<COffscreenContext> context;
+	CVuMeter* meter {nullptr};
+};
+
+//------------------------------------------------------------------------
+bool isNear (float a, float b)
+{
+	return std::abs (a - b) < 0.0001f;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, FirstIdleInvalidatesWholeMeter)
+{
+	MeterFixture fixture;
+	fixture.meter->setValue (0.5f);
+	fixture.meter->onIdle ();
+	EXPECT_EQ (fixture.recorder->rects.size (), 1u);
+	EXPECT_EQ (fixture.recorder->rects[0], fixture.meter->getViewSize ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, LevelChangeInvalidatesChangedLedsOnly)
+{
+	MeterFixture fixture;
+	fixture.meter->setValue (0.5f);
+	fixture.meter->onIdle ();
+	fixture.draw ();
+
+	// rising from 5 to 7 LEDs, vertical meters count the LEDs from the bottom
+	fixture.meter->setValue (0.7f);
+	fixture.meter->onIdle ();
+	EXPECT_EQ (fixture.recorder->rects.size (), 1u);
+	EXPECT_EQ (fixture.recorder->rects[0], CRect (0, 30, 10, 50));
+	fixture.draw ();
+
+	// falling with the decrease step from 7 to 6 LEDs
+	fixture.meter->setValue (0.f);
+	fixture.meter->onIdle ();
+	EXPECT_EQ (fixture.recorder->rects.size (), 1u);
+	EXPECT_EQ (fixture.recorder->rects[0], CRect (0, 30, 10, 40));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, UnchangedLevelInvalidatesNothing)
+{
+	MeterFixture fixture;
+	fixture.meter->setValue (0.5f);
+	fixture.meter->onIdle ();
+	fixture.draw ();
+	fixture.meter->onIdle ();
+	fixture.meter->onIdle ();
+	EXPECT_TRUE (fixture.recorder->rects.empty ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, HeldPeakLedIsNotInvalidated)
+{
+	MeterFixture fixture;
+	fixture.meter->setPeakHoldTime (1000);
+	fixture.meter->setValue (0.8f);
+	fixture.meter->onIdle ();
+	fixture.draw ();
+
+	// without a frame the ticks do not advance, so the peak is held
+	fixture.meter->setValue (0.f);
+	fixture.meter->onIdle ();
+	EXPECT_TRUE (isNear (fixture.meter->getPeakValue (), 0.8f));
+	EXPECT_EQ (fixture.recorder->rects.size (), 1u);
+	EXPECT_EQ (fixture.recorder->rects[0], CRect (0, 20, 10, 30));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, PeakHold)
+{
+	auto onBitmap = makeOwned<CBitmap> (CPoint (10, 100));
+	auto meter = makeOwned<PeakTestVuMeter> (CRect (0, 0, 10, 100), onBitmap, nullptr, 10);
+	meter->setPeakHoldTime (500);
+	meter->idle (0.8f, 1000);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.8f));
+	meter->idle (0.2f, 1200);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.8f));
+	meter->idle (0.2f, 1500);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.8f));
+	// a new maximum restarts the hold time
+	meter->idle (0.9f, 1500);
+	meter->idle (0.2f, 1900);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.9f));
+	meter->resetPeak ();
+	EXPECT_TRUE (isNear (meter->getPeakValue (), meter->getOldValue ()));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CVuMeterTest, PeakFalloffTiming)
+{
+	auto onBitmap = makeOwned<CBitmap> (CPoint (10, 100));
+	auto meter = makeOwned<PeakTestVuMeter> (CRect (0, 0, 10, 100), onBitmap, nullptr, 10);
+	meter->setPeakHoldTime (500);
+	meter->setPeakFalloff (1.f);
+	meter->idle (0.8f, 1000);
+	meter->idle (0.2f, 1400);
+	// the falloff only counts the time after the hold time elapsed
+	meter->idle (0.2f, 1600);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.7f));
+	// and only the time since the last idle
+	meter->idle (0.2f, 1800);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.5f));
+	// the peak does not fall below the current level
+	meter->idle (0.2f, 3000);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.2f));
+	meter->idle (0.9f, 3100);
+	EXPECT_TRUE (isNear (meter->getPeakValue (), 0.9f));
+}
+
+} // VSTGUI
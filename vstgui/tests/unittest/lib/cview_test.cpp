@@ -158,6 +158,52 @@ TEST_CASE (CViewTest, ResizeAttribute)
 	EXPECT (secondData == 32);
 }
 
+TEST_CASE (CViewTest, ResizeAttributeToHeap)
+{
+	auto v = owned (new View ());
+	uint32_t outSize;
+	CRect small (1, 2, 3, 4);
+	EXPECT (v->setAttribute (kCViewTooltipAttribute, 8, &small));
+	EXPECT (v->setAttribute ('big ', sizeof (small), &small));
+	CRect big (10, 20, 30, 40);
+	EXPECT (v->setAttribute (kCViewTooltipAttribute, sizeof (big), &big));
+	CRect result;
+	EXPECT (v->getAttribute (kCViewTooltipAttribute, sizeof (result), &result, outSize));
+	EXPECT (outSize == sizeof (big));
+	EXPECT (result == big);
+	EXPECT (v->getAttribute ('big ', sizeof (result), &result, outSize));
+	EXPECT (result == small);
+	EXPECT (v->setAttribute ('big ', 4, &big));
+	EXPECT (v->getAttributeSize ('big ', outSize));
+	EXPECT (outSize == 4);
+	EXPECT (v->removeAttribute (kCViewTooltipAttribute));
+	EXPECT (v->getAttributeSize (kCViewTooltipAttribute, outSize) == false);
+	EXPECT (v->removeAttribute (kCViewTooltipAttribute) == false);
+}
+
+TEST_CASE (CViewTest, ManyAttributes)
+{
+	auto v = owned (new View ());
+	for (CViewAttributeID id = 0; id < 10; ++id)
+		EXPECT (v->setAttribute (id, sizeof (id), &id));
+	EXPECT (v->removeAttribute (3));
+	EXPECT (v->removeAttribute (9));
+	for (CViewAttributeID id = 0; id < 10; ++id)
+	{
+		CViewAttributeID value = 0;
+		uint32_t outSize;
+		if (id == 3 || id == 9)
+		{
+			EXPECT (v->getAttribute (id, sizeof (value), &value, outSize) == false);
+		}
+		else
+		{
+			EXPECT (v->getAttribute (id, sizeof (value), &value, outSize));
+			EXPECT (value == id);
+		}
+	}
+}
+
 TEST_CASE (CViewTest, ViewListener)
 {
 	ViewListener listener;
@@ -519,6 +565,29 @@ TEST_CASE (CViewTest, IdleBeforeAttached)
 
 #endif
 
+TEST_CASE (CViewTest, ConcurrentDrawScope)
+{
+	auto container = owned (new CViewContainer (CRect (0, 0, 100, 100)));
+	auto v = new CView (CRect (0, 0, 10, 10));
+	container->addView (v);
+	v->setDirty (true);
+	EXPECT_FALSE (CView::isDrawingConcurrently ());
+	{
+		CView::ConcurrentDrawScope scope;
+		EXPECT_TRUE (CView::isDrawingConcurrently ());
+		{
+			CView::ConcurrentDrawScope nestedScope;
+		}
+		EXPECT_TRUE (CView::isDrawingConcurrently ());
+		// the dirty state is not written while drawing concurrently
+		v->setDirty (false);
+		EXPECT_TRUE (v->isDirty ());
+	}
+	EXPECT_FALSE (CView::isDrawingConcurrently ());
+	v->setDirty (false);
+	EXPECT_FALSE (v->isDirty ());
+}
+
 struct DataPackage : IDataPackage
 {
 	UTF8String str;
@@ -3,6 +3,8 @@
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
 #include "../../../lib/cframe.h"
+#include "../../../lib/controls/ctextlabel.h"
+#include "../../../lib/coffscreencontext.h"
 #include "../../../lib/iviewlistener.h"
 #include "../../../lib/ccolor.h"
 #include "../../../lib/dragging.h"
@@ -45,6 +47,30 @@ public:
 	TestView2 () : CView (CRect (10, 10, 20, 20)) {}
 };
 
+class DirectValueLabel : public CTextLabel
+{
+public:
+	DirectValueLabel (const CRect& size, bool untracked = true) : CTextLabel (size)
+	{
+		setHasUntrackedDirtyState (untracked);
+	}
+
+	void setValueDirectly (float newValue) { value = newValue; }
+	void setValueAndNotify (float newValue)
+	{
+		value = newValue;
+		valueChanged ();
+	}
+};
+
+class StaysDirtyView : public CView
+{
+public:
+	using CView::CView;
+
+	void draw (CDrawContext* context) override {}
+};
+
 class MouseEventCheckView : public CView, public DropTargetAdapter
 {
 public:
@@ -109,6 +135,31 @@ public:
 	
  };
 
+class WheelEventView : public CView
+{
+public:
+	WheelEventView () : CView (CRect (0, 0, 10, 10)) { setTransparency (true); }
+
+	void onMouseWheelEvent (MouseWheelEvent& event) override
+	{
+		++numWheelEvents;
+		if (removeOnWheel)
+		{
+			auto parent = getParentView ()->asViewContainer ();
+			for (auto view : removeOnWheel->views)
+				parent->removeView (view);
+		}
+	}
+
+	struct RemoveList
+	{
+		std::vector<CView*> views;
+	};
+
+	int32_t numWheelEvents {0};
+	RemoveList* removeOnWheel {nullptr};
+};
+
 } // anonymous
 
 TEST_SUITE_SETUP (CViewContainerTest)
@@ -323,6 +374,170 @@ TEST_CASE (CViewContainerTest, GetViewAtDeep)
 	        container2);
 }
 
+TEST_CASE (CViewContainerTest, GetViewAtWithHitTestIndex)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setHitTestIndexEnabled (true);
+	EXPECT_TRUE (container->getHitTestIndexEnabled ());
+
+	std::vector<CView*> views;
+	for (auto y = 0; y < 10; ++y)
+	{
+		for (auto x = 0; x < 10; ++x)
+		{
+			auto view = new CView (CRect (0, 0, 10, 10).offset (x * 20, y * 20));
+			container->addView (view);
+			views.push_back (view);
+		}
+	}
+	CFrame* frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	EXPECT (container->getViewAt (CPoint (5, 5)) == views[0]);
+	EXPECT (container->getViewAt (CPoint (15, 5)) == nullptr);
+	EXPECT (container->getViewAt (CPoint (185, 185)) == views[99]);
+
+	// overlapping views are found top->down
+	auto topView = new CView (CRect (0, 0, 50, 50));
+	container->addView (topView);
+	EXPECT (container->getViewAt (CPoint (5, 5)) == topView);
+	CViewContainer::ViewList result;
+	container->getViewsAt (CPoint (5, 5), result);
+	EXPECT (result.size () == 2);
+	EXPECT (result.front () == topView);
+	container->changeViewZOrder (topView, 0);
+	EXPECT (container->getViewAt (CPoint (5, 5)) == views[0]);
+
+	// the index follows size, mouseable area and visibility changes
+	views[0]->setViewSize (CRect (100, 100, 115, 115));
+	EXPECT (container->getViewAt (CPoint (5, 5)) == topView);
+	EXPECT (container->getViewAt (CPoint (110, 110)) == views[0]);
+	views[1]->setMouseableArea (CRect (0, 0, 1, 1));
+	EXPECT (container->getViewAt (CPoint (25, 5)) == nullptr);
+	views[99]->setVisible (false);
+	EXPECT (container->getViewAt (CPoint (185, 185)) == nullptr);
+
+	container->removeView (topView);
+	EXPECT (container->getViewAt (CPoint (5, 5)) == nullptr);
+	container->setHitTestIndexEnabled (false);
+	EXPECT_FALSE (container->getHitTestIndexEnabled ());
+	EXPECT (container->getViewAt (CPoint (185, 25)) == views[19]);
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, SubtreeDirty)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	auto container2 = new CViewContainer (CRect (0, 0, 100, 100));
+	auto view = new CView (CRect (0, 0, 10, 10));
+	auto control = new CTextLabel (CRect (10, 10, 20, 20));
+	container2->addView (view);
+	container2->addView (control);
+	container->addView (container2);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (frame->isSubtreeDirty ());
+	EXPECT_FALSE (frame->hasUntrackedDirtyViews ());
+	EXPECT_FALSE (container->isDirty ());
+
+	view->setDirty (true);
+	EXPECT_TRUE (container2->isSubtreeDirty ());
+	EXPECT_TRUE (container->isSubtreeDirty ());
+	EXPECT_TRUE (frame->isSubtreeDirty ());
+	EXPECT_TRUE (container->isDirty ());
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (view->isDirty ());
+	EXPECT_FALSE (container2->isSubtreeDirty ());
+	EXPECT_FALSE (container->isDirty ());
+
+	control->setValue (control->getValue () + 0.5f);
+	EXPECT_TRUE (container->isSubtreeDirty ());
+	EXPECT_TRUE (container->isDirty ());
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (control->isDirty ());
+	EXPECT_FALSE (container->isDirty ());
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, UntrackedDirtyState)
+{
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	auto container = new CViewContainer (CRect (0, 0, 100, 100));
+	auto container2 = new CViewContainer (CRect (100, 0, 200, 100));
+	auto label = new DirectValueLabel (CRect (0, 0, 10, 10));
+	container->addView (label);
+	container2->addView (new CView (CRect (0, 0, 10, 10)));
+	frame->addView (container);
+	frame->addView (container2);
+	frame->attached (frame);
+	frame->invalidateDirtyViews ();
+	EXPECT_TRUE (container->hasUntrackedDirtyViews ());
+	EXPECT_FALSE (container2->hasUntrackedDirtyViews ());
+	EXPECT_TRUE (frame->hasUntrackedDirtyViews ());
+
+	// the value changed without notifying the parents
+	label->setValueDirectly (label->getValue () + 0.5f);
+	EXPECT_FALSE (container->isSubtreeDirty ());
+	EXPECT_TRUE (container->isDirty ());
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (label->isDirty ());
+
+	container->removeView (label);
+	EXPECT_FALSE (container->hasUntrackedDirtyViews ());
+	EXPECT_FALSE (frame->hasUntrackedDirtyViews ());
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, ControlValueChangedMarksSubtreeDirty)
+{
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	auto container = new CViewContainer (CRect (0, 0, 100, 100));
+	auto label = new DirectValueLabel (CRect (0, 0, 10, 10), false);
+	container->addView (label);
+	frame->addView (container);
+	frame->attached (frame);
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (frame->hasUntrackedDirtyViews ());
+
+	label->setValueAndNotify (label->getValue () + 0.5f);
+	EXPECT_TRUE (container->isSubtreeDirty ());
+	EXPECT_TRUE (frame->isDirty ());
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (label->isDirty ());
+
+	label->setValueNormalized (1.f);
+	EXPECT_TRUE (container->isSubtreeDirty ());
+	frame->invalidateDirtyViews ();
+	EXPECT_FALSE (frame->isDirty ());
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, DrawKeepsSubtreeDirtyMark)
+{
+	auto frame = new CFrame (CRect (0, 0, 100, 100), nullptr);
+	auto container = new CViewContainer (CRect (0, 0, 100, 100));
+	auto view = new StaysDirtyView (CRect (0, 0, 10, 10));
+	container->addView (view);
+	frame->addView (container);
+	frame->attached (frame);
+	view->setDirty (true);
+	EXPECT_TRUE (container->isSubtreeDirty ());
+
+	auto offscreen = COffscreenContext::create ({100., 100.});
+	offscreen->beginDraw ();
+	container->drawRect (offscreen, container->getViewSize ());
+	offscreen->endDraw ();
+	// the view did not clear its dirty state while drawing
+	EXPECT_TRUE (view->isDirty ());
+	EXPECT_TRUE (container->isSubtreeDirty ());
+	frame->close ();
+}
+
 TEST_CASE (CViewContainerTest, Listener)
 {
 	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
@@ -430,6 +645,46 @@ TEST_CASE (CViewContainerTest, ReverseIterator)
 	EXPECT (*it == nullptr);
 }
 
+TEST_CASE (CViewContainerTest, ChangeChildViewsWhileIterating)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+
+	auto v1 = new TestView1 ();
+	auto v2 = new TestView2 ();
+	auto v3 = new TestView1 ();
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+
+	std::vector<CView*> visited;
+	container->forEachChild ([&] (CView* view) {
+		visited.push_back (view);
+		if (view == v1)
+		{
+			container->removeView (v1);
+			container->removeView (v2);
+			for (auto i = 0; i < 16; ++i)
+				container->addView (new TestView2 (), v3);
+		}
+	});
+	EXPECT_EQ (visited.size (), 3u);
+	EXPECT (visited[0] == v1);
+	EXPECT (visited[2] == v3);
+	EXPECT_EQ (container->getNbViews (), 17u);
+
+	ViewIterator it (container);
+	auto count = 0u;
+	while (auto view = *it)
+	{
+		container->removeView (view);
+		container->addView (new TestView1 ());
+		++count;
+		++it;
+	}
+	EXPECT_EQ (count, 17u);
+	EXPECT_EQ (container->getNbViews (), 17u);
+}
+
 TEST_CASE (CViewContainerTest, MouseEventsInEmptyContainer)
 {
 	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
@@ -475,6 +730,33 @@ TEST_CASE (CViewContainerTest, MouseEvents)
 	EXPECT_TRUE (v2->onWheelCalled);
 }
 
+TEST_CASE (CViewContainerTest, RemoveViewsWhileDispatchingEvent)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	auto bottom = new WheelEventView ();
+	auto middle = new WheelEventView ();
+	auto top = new WheelEventView ();
+	container->addView (bottom);
+	container->addView (middle);
+	container->addView (top);
+	bottom->remember ();
+
+	WheelEventView::RemoveList removeList {{top, middle}};
+	top->removeOnWheel = &removeList;
+	dispatchMouseWheelEvent (container, {5., 5.}, 0., 1.);
+	EXPECT_EQ (bottom->numWheelEvents, 1);
+	EXPECT_EQ (container->getNbViews (), 1u);
+	EXPECT (container->getView (0) == bottom);
+
+	bottom->forget ();
+	frame->close ();
+}
+
 TEST_CASE (CViewContainerTest, MouseCancel)
 {
 	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
@@ -0,0 +1,155 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../../lib/platform/linux/cairoglyphatlas.h"
+#include "../../../unittests.h"
+#include <pango/pangocairo.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace VSTGUI {
+
+namespace {
+
+static constexpr int kWidth = 200;
+static constexpr int kHeight = 40;
+// a fractional position, so that the subpixel positions of the atlas are used
+static const CPoint kTextPos (5.3, 10.);
+
+//------------------------------------------------------------------------
+struct TextSurface
+{
+	TextSurface (cairo_antialias_t antialias)
+	{
+		surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, kWidth, kHeight);
+		context = cairo_create (surface);
+		cairo_set_source_rgb (context, 1., 1., 1.);
+		cairo_paint (context);
+		cairo_set_source_rgb (context, 0., 0., 0.);
+
+		layout = pango_cairo_create_layout (context);
+		auto options = cairo_font_options_create ();
+		cairo_font_options_set_antialias (options, antialias);
+		pango_cairo_context_set_font_options (pango_layout_get_context (layout), options);
+		cairo_font_options_destroy (options);
+		pango_layout_context_changed (layout);
+		auto fontDesc = pango_font_description_from_string ("Sans 12");
+		pango_layout_set_font_description (layout, fontDesc);
+		pango_font_description_free (fontDesc);
+		pango_layout_set_text (layout, "Gain -12.5 dB / 440 Hz", -1);
+	}
+
+	~TextSurface () noexcept
+	{
+		g_object_unref (layout);
+		cairo_destroy (context);
+		cairo_surface_destroy (surface);
+	}
+
+	void drawWithPango ()
+	{
+		cairo_move_to (context, kTextPos.x, kTextPos.y);
+		pango_cairo_show_layout (context, layout);
+		cairo_surface_flush (surface);
+	}
+
+	bool drawWithAtlas ()
+	{
+		auto result = Cairo::GlyphAtlas::instance ().drawLayout (context, layout, kTextPos);
+		cairo_surface_flush (surface);
+		return result;
+	}
+
+	/** the gray value of the pixel, the text is drawn black on white */
+	int getPixel (int x, int y) const
+	{
+		auto data = cairo_image_surface_get_data (surface);
+		auto stride = cairo_image_surface_get_stride (surface);
+		return data[y * stride + x * 4];
+	}
+
+	cairo_surface_t* surface;
+	cairo_t* context;
+	PangoLayout* layout;
+};
+
+//------------------------------------------------------------------------
+struct PixelDifference
+{
+	int maxDifference {0};
+	uint32_t numDifferentPixels {0};
+	uint32_t numInkPixels {0};
+	uint32_t numGrayPixels {0};
+};
+
+//------------------------------------------------------------------------
+/** compare the rendering of the atlas with the one of Pango */
+PixelDifference compare (const TextSurface& pango, const TextSurface& atlas)
+{
+	PixelDifference result;
+	for (auto y = 0; y < kHeight; ++y)
+	{
+		for (auto x = 0; x < kWidth; ++x)
+		{
+			auto p1 = pango.getPixel (x, y);
+			auto p2 = atlas.getPixel (x, y);
+			if (p1 != 255)
+				++result.numInkPixels;
+			if (p2 != 0 && p2 != 255)
+				++result.numGrayPixels;
+			if (p1 != p2)
+				++result.numDifferentPixels;
+			result.maxDifference = std::max (result.maxDifference, std::abs (p1 - p2));
+		}
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------
+/** the glyphs are positioned in quarter pixels and the coverage of overlapping glyphs is summed,
+ *	so the pixels at the glyph edges may differ a bit from Pango's rendering
+ */
+static constexpr int kTolerance = 80;
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CairoGlyphAtlasTest, DrawsLikePango)
+{
+	TextSurface pango (CAIRO_ANTIALIAS_GRAY);
+	TextSurface atlas (CAIRO_ANTIALIAS_GRAY);
+	pango.drawWithPango ();
+	auto before = Cairo::GlyphAtlas::instance ().getStatistics ();
+	EXPECT_TRUE (atlas.drawWithAtlas ());
+	auto after = Cairo::GlyphAtlas::instance ().getStatistics ();
+	EXPECT (after.hits + after.misses > before.hits + before.misses);
+
+	auto difference = compare (pango, atlas);
+	EXPECT (difference.numInkPixels > 0u);
+	EXPECT (difference.maxDifference <= kTolerance);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CairoGlyphAtlasTest, DrawsWithoutAntialiasingLikePango)
+{
+	TextSurface pango (CAIRO_ANTIALIAS_NONE);
+	TextSurface atlas (CAIRO_ANTIALIAS_NONE);
+	pango.drawWithPango ();
+	EXPECT_TRUE (atlas.drawWithAtlas ());
+
+	auto difference = compare (pango, atlas);
+	EXPECT (difference.numInkPixels > 0u);
+	EXPECT_EQ (difference.numGrayPixels, 0u);
+	// whole pixels may flip at the glyph edges, as the glyphs are positioned in quarter pixels
+	EXPECT (difference.numDifferentPixels <= difference.numInkPixels / 10);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CairoGlyphAtlasTest, SubpixelAntialiasingIsLeftToPango)
+{
+	TextSurface atlas (CAIRO_ANTIALIAS_SUBPIXEL);
+	EXPECT_FALSE (atlas.drawWithAtlas ());
+}
+
+} // VSTGUI
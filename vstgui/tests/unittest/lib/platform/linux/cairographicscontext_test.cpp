@@ -0,0 +1,181 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../../lib/platform/linux/cairographicscontext.h"
+#include "../../../../../lib/cbitmap.h"
+#include "../../../../../lib/cgraphicspath.h"
+#include "../../../../../lib/cgraphicstransform.h"
+#include "../../../../../lib/clinestyle.h"
+#include "../../../../../lib/coffscreencontext.h"
+#include "../../../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> createPattern ()
+{
+	auto offscreen = COffscreenContext::create ({16., 16.});
+	offscreen->beginDraw ();
+	offscreen->setFillColor (kBlueCColor);
+	offscreen->drawRect (CRect (0, 0, 16, 16), kDrawFilled);
+	offscreen->setFillColor (kYellowCColor);
+	offscreen->drawRect (CRect (4, 4, 12, 12), kDrawFilled);
+	offscreen->endDraw ();
+	return offscreen->getBitmap ();
+}
+
+//------------------------------------------------------------------------
+/** a fixed sequence of primitives which changes the state between them and nests saved states */
+void drawSequence (CDrawContext& context, CBitmap* bitmap)
+{
+	context.setClipRect (CRect (0, 0, 100, 100));
+	context.setFillColor (kWhiteCColor);
+	context.drawRect (CRect (0, 0, 100, 100), kDrawFilled);
+
+	context.setDrawMode (kAliasing);
+	context.setFrameColor (kRedCColor);
+	context.setLineWidth (1.);
+	context.drawLine (CPoint (5, 5), CPoint (95, 5));
+	context.setLineWidth (3.);
+	context.drawLine (CPoint (5, 10), CPoint (95, 10));
+
+	context.saveGlobalState ();
+	context.setClipRect (CRect (10, 10, 60, 60));
+	context.setDrawMode (kAntiAliasing);
+	context.setLineStyle (CLineStyle (CLineStyle::kLineCapRound, CLineStyle::kLineJoinRound, 0.,
+									  {2., 1.}));
+	context.setFrameColor (kGreenCColor);
+	context.setFillColor (CColor (0, 0, 255, 128));
+	context.drawEllipse (CRect (0, 0, 80, 80), kDrawFilledAndStroked);
+	{
+		CDrawContext::Transform t (context, CGraphicsTransform ().translate (20., 20.));
+		context.setGlobalAlpha (0.5f);
+		context.drawArc (CRect (0, 0, 30, 30), 0.f, 270.f, kDrawStroked);
+		context.drawBitmap (bitmap, CRect (0, 0, 16, 16));
+	}
+	context.restoreGlobalState ();
+
+	// the state after the restore must be sent again
+	context.drawLine (CPoint (5, 70), CPoint (95, 70));
+	context.drawRect (CRect (60, 20, 90, 50), kDrawStroked);
+	context.drawBitmap (bitmap, CRect (70, 75, 86, 91), CPoint (4, 4), 0.5f);
+	context.clearRect (CRect (90, 90, 95, 95));
+
+	if (auto path = owned (context.createGraphicsPath ()))
+	{
+		path->addRoundRect (CRect (20, 75, 60, 95), 5.);
+		CGraphicsTransform tm;
+		tm.scale (0.5, 0.5);
+		context.setFillColor (kMagentaCColor);
+		context.drawGraphicsPath (path, CDrawContext::kPathFilled, &tm);
+		context.drawGraphicsPath (path, CDrawContext::kPathStroked);
+	}
+	context.setDrawMode (kAliasing);
+	context.setFillColor (kCyanCColor);
+	context.drawRect (CRect (2, 90, 12, 98), kDrawFilled);
+
+	// the clip and the transform change between single primitives
+	context.setDrawMode (kAntiAliasing);
+	context.setLineWidth (2.);
+	for (auto i = 0; i < 4; ++i)
+	{
+		context.setClipRect (CRect (i * 25., 30., i * 25. + 20., 60.));
+		context.setFillColor (i % 2 ? kRedCColor : kGreenCColor);
+		context.drawRect (CRect (i * 25. - 5., 28., i * 25. + 30., 40.), kDrawFilled);
+		{
+			CDrawContext::Transform t (
+				context, CGraphicsTransform ().scale (1. + i * 0.25, 1.).translate (i * 2., 0.));
+			context.drawLine (CPoint (i * 20., 42.), CPoint (i * 20. + 15., 58.));
+			context.drawEllipse (CRect (i * 20., 44., i * 20. + 10., 54.), kDrawStroked);
+		}
+		context.drawLine (CPoint (i * 25., 59.), CPoint (i * 25. + 20., 31.));
+	}
+	context.setClipRect (CRect (0, 0, 100, 100));
+	context.drawRect (CRect (45, 45, 55, 55), kDrawStroked);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> drawWithStateDiffing (bool state, CBitmap* pattern)
+{
+	auto offscreen = COffscreenContext::create ({100., 100.});
+	auto cairoContext = std::dynamic_pointer_cast<CairoGraphicsDeviceContext> (
+		offscreen->getPlatformDeviceContext ());
+	if (!cairoContext)
+		return nullptr;
+	cairoContext->setStateDiffingEnabled (state);
+	offscreen->beginDraw ();
+	drawSequence (*offscreen, pattern);
+	offscreen->endDraw ();
+	return offscreen->getBitmap ();
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CairoGraphicsDeviceContextTest, StateDiffingDrawsLikeSaveAndRestorePerPrimitive)
+{
+	auto pattern = createPattern ();
+	auto diffed = drawWithStateDiffing (true, pattern);
+	auto full = drawWithStateDiffing (false, pattern);
+	EXPECT (diffed);
+	EXPECT (full);
+	auto diffedAccess = owned (CBitmapPixelAccess::create (diffed));
+	auto fullAccess = owned (CBitmapPixelAccess::create (full));
+	EXPECT (diffedAccess);
+	EXPECT (fullAccess);
+	uint32_t numDifferentPixels = 0;
+	do
+	{
+		CColor c1, c2;
+		diffedAccess->getColor (c1);
+		fullAccess->getColor (c2);
+		if (c1 != c2)
+			++numDifferentPixels;
+	} while (++(*diffedAccess) && ++(*fullAccess));
+	EXPECT_EQ (numDifferentPixels, 0u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CairoGraphicsDeviceContextTest, UserTransformDoesNotResampleHiDPIBitmap)
+{
+	// a checkerboard with 2x pixels, drawn scaled by 2 into a 1x context shows every pixel
+	auto bitmap = makeOwned<CBitmap> (CPoint (8., 8.), 2.);
+	if (auto access = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			auto odd = (access->getX () + access->getY ()) % 2;
+			access->setColor (odd ? kBlackCColor : kWhiteCColor);
+		} while (++(*access));
+	}
+	auto offscreen = COffscreenContext::create ({16., 16.});
+	offscreen->beginDraw ();
+	offscreen->setBitmapInterpolationQuality (BitmapInterpolationQuality::kLow);
+	// the second draw would use a resampled copy, if it was cached for the transform
+	for (auto i = 0; i < 2; ++i)
+	{
+		CDrawContext::Transform t (*offscreen, CGraphicsTransform ().scale (2., 2.));
+		offscreen->drawBitmap (bitmap, CRect (0, 0, 8, 8));
+	}
+	offscreen->endDraw ();
+
+	auto sourceAccess = owned (CBitmapPixelAccess::create (bitmap));
+	auto drawnAccess = owned (CBitmapPixelAccess::create (offscreen->getBitmap ()));
+	EXPECT (sourceAccess);
+	EXPECT (drawnAccess);
+	uint32_t numDifferentPixels = 0;
+	do
+	{
+		CColor c1, c2;
+		sourceAccess->getColor (c1);
+		drawnAccess->getColor (c2);
+		if (c1 != c2)
+			++numDifferentPixels;
+	} while (++(*sourceAccess) && ++(*drawnAccess));
+	EXPECT_EQ (numDifferentPixels, 0u);
+}
+
+} // VSTGUI
@@ -105,6 +105,32 @@ TEST_CASE (UTF8StringTest, CodePointIterator)
 	EXPECT (charCount == 3);
 }
 
+TEST_CASE (UTF8StringTest, FormatNumber)
+{
+	char buffer[32];
+	auto format = [&] (double value, uint32_t precision) {
+		auto length = formatNumber (buffer, buffer + sizeof (buffer), value, precision);
+		return std::string (buffer, length);
+	};
+	EXPECT_EQ (format (0.5, 2), "0.50");
+	EXPECT_EQ (format (-12.345, 1), "-12.3");
+	EXPECT_EQ (format (3., 0), "3");
+	EXPECT_EQ (format (static_cast<float> (0.1), 3), "0.100");
+	EXPECT_EQ (formatNumber (buffer, buffer + 3, 1000., 2), 0u);
+}
+
+TEST_CASE (UTF8StringTest, ParseNumber)
+{
+	auto parse = [] (const std::string& str) {
+		return parseNumber (str.data (), str.data () + str.size ());
+	};
+	EXPECT_EQ (*parse ("0.25"), 0.25);
+	EXPECT_EQ (*parse ("  +1.5 dB"), 1.5);
+	EXPECT_EQ (*parse ("-3e2"), -300.);
+	EXPECT_FALSE (parse ("dB"));
+	EXPECT_FALSE (parse (""));
+}
+
 #if MAC
 
 TEST_CASE (UTF8StringTest, MacPlatformString)
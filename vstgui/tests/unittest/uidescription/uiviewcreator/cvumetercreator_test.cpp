@@ -43,6 +43,20 @@ TEST_CASE (CVuMeterCreatorTest, DecreaseStepValue)
 	                         [&] (CVuMeter* v) { return v->getDecreaseStepValue () == 15.; });
 }
 
+TEST_CASE (CVuMeterCreatorTest, PeakHoldTime)
+{
+	DummyUIDescription uidesc;
+	testAttribute<CVuMeter> (kCVuMeter, kAttrPeakHoldTime, 1500, &uidesc,
+	                         [&] (CVuMeter* v) { return v->getPeakHoldTime () == 1500; });
+}
+
+TEST_CASE (CVuMeterCreatorTest, PeakFalloff)
+{
+	DummyUIDescription uidesc;
+	testAttribute<CVuMeter> (kCVuMeter, kAttrPeakFalloff, 0.5, &uidesc,
+	                         [&] (CVuMeter* v) { return v->getPeakFalloff () == 0.5f; });
+}
+
 TEST_CASE (CVuMeterCreatorTest, OrientationValues)
 {
 	DummyUIDescription uidesc;
@@ -398,6 +398,12 @@ CBitmap* UIBitmapNode::getBitmap (const std::string& pathHint)
 				bitmapVariant = multiFrameDesc;
 			}
 			bitmap = createBitmap (*path, bitmapVariant);
+			bool frameCacheEnabled;
+			if (attributes->getBooleanAttribute ("multiframe-frame-cache", frameCacheEnabled))
+			{
+				if (auto mfb = dynamic_cast<CMultiFrameBitmap*> (bitmap))
+					mfb->setFrameCacheEnabled (frameCacheEnabled);
+			}
 			if (bitmap->getPlatformBitmap () == nullptr && pathIsAbsolute (pathHint))
 			{
 				std::string absPath = pathHint;
@@ -269,6 +269,8 @@ static const std::string kAttrDrawValueColor = "draw-value-color";
 static const std::string kAttrOffBitmap = "off-bitmap";
 static const std::string kAttrNumLed = "num-led";
 static const std::string kAttrDecreaseStepValue = "decrease-step-value";
+static const std::string kAttrPeakHoldTime = "peak-hold-time";
+static const std::string kAttrPeakFalloff = "peak-falloff";
 
 //-----------------------------------------------------------------------------
 // CAnimationSplashScreenCreator attributes
@@ -297,6 +297,8 @@ Attributes:
 - \b num-led [integer]
 - \b orientation [vertical/horizontal]
 - \b decrease-step-value [float]
+- \b peak-hold-time [integer]
+- \b peak-falloff [float]
 
 @section uiviewswitchcontainer UIViewSwitchContainer
 Declaration:
@@ -9,6 +9,7 @@
 #include "../uiattributes.h"
 #include "../uiviewcreator.h"
 #include "../uiviewfactory.h"
+#include <algorithm>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -68,6 +69,12 @@ bool VuMeterCreator::apply (CView* view, const UIAttributes& attributes,
 	double value;
 	if (attributes.getDoubleAttribute (kAttrDecreaseStepValue, value))
 		vuMeter->setDecreaseStepValue (static_cast<float> (value));
+
+	int32_t peakHoldTime;
+	if (attributes.getIntegerAttribute (kAttrPeakHoldTime, peakHoldTime))
+		vuMeter->setPeakHoldTime (static_cast<uint32_t> (std::max (peakHoldTime, 0)));
+	if (attributes.getDoubleAttribute (kAttrPeakFalloff, value))
+		vuMeter->setPeakFalloff (static_cast<float> (value));
 	return true;
 }
 
@@ -78,6 +85,8 @@ bool VuMeterCreator::getAttributeNames (StringList& attributeNames) const
 	attributeNames.emplace_back (kAttrNumLed);
 	attributeNames.emplace_back (kAttrOrientation);
 	attributeNames.emplace_back (kAttrDecreaseStepValue);
+	attributeNames.emplace_back (kAttrPeakHoldTime);
+	attributeNames.emplace_back (kAttrPeakFalloff);
 	return true;
 }
 
@@ -92,6 +101,10 @@ auto VuMeterCreator::getAttributeType (const string& attributeName) const -> Att
 		return kListType;
 	if (attributeName == kAttrDecreaseStepValue)
 		return kFloatType;
+	if (attributeName == kAttrPeakHoldTime)
+		return kIntegerType;
+	if (attributeName == kAttrPeakFalloff)
+		return kFloatType;
 	return kUnknownType;
 }
 
@@ -129,6 +142,17 @@ bool VuMeterCreator::getAttributeValue (CView* view, const string& attributeName
 		stringValue = UIAttributes::doubleToString (vuMeter->getDecreaseStepValue ());
 		return true;
 	}
+	else if (attributeName == kAttrPeakHoldTime)
+	{
+		stringValue = UIAttributes::integerToString (
+		    static_cast<int32_t> (vuMeter->getPeakHoldTime ()));
+		return true;
+	}
+	else if (attributeName == kAttrPeakFalloff)
+	{
+		stringValue = UIAttributes::doubleToString (vuMeter->getPeakFalloff ());
+		return true;
+	}
 	return false;
 }
 
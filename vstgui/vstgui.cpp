@@ -33,6 +33,7 @@
 #include "lib/cview.cpp"
 #include "lib/cviewcontainer.cpp"
 #include "lib/cvstguitimer.cpp"
+#include "lib/drawprofiler.cpp"
 #include "lib/events.cpp"
 #include "lib/genericstringlistdatabrowsersource.cpp"
 #include "lib/pixelbuffer.cpp"
@@ -6,13 +6,18 @@
 #include "lib/platform/linux/x11fileselector.cpp"
 #include "lib/platform/linux/x11frame.cpp"
 #include "lib/platform/linux/x11platform.cpp"
+#include "lib/platform/linux/x11shmbackbuffer.cpp"
 #include "lib/platform/linux/x11timer.cpp"
 #include "lib/platform/linux/x11utils.cpp"
 
 #include "lib/platform/linux/cairobitmap.cpp"
 #include "lib/platform/linux/cairographicscontext.cpp"
 #include "lib/platform/linux/cairofont.cpp"
+#include "lib/platform/linux/cairoglyphatlas.cpp"
 #include "lib/platform/linux/cairogradient.cpp"
 #include "lib/platform/linux/cairopath.cpp"
+#include "lib/platform/linux/cairotilerenderer.cpp"
+
+#include "lib/platform/linux/headlessframe.cpp"
 
 #include "lib/platform/linux/linuxfactory.cpp"